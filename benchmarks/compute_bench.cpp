@@ -0,0 +1,654 @@
+// compute_bench.cpp
+// Culling and clustering kernels at scale on a windowless device: synthetic inputs, timestamp queries
+// around every dispatch and a CPU reference check of the outputs. Results within float precision of a
+// plane or sphere boundary are counted as borderline instead of wrong.
+// Usage: ix_compute_bench [--quick] [--json out.json]
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "global_common/ix_global_pods.h"
+#include "platform/headless_platform.h"
+#include "platform/rendering/vk/vk_buffer.h"
+#include "platform/rendering/vk/vk_compute_pipeline.h"
+#include "platform/rendering/vk/vk_context.h"
+#include "platform/rendering/vk/vk_instance.h"
+
+namespace
+{
+    constexpr uint32_t REPETITIONS = 20;      // Timed dispatches per case, after one warm-up
+    constexpr uint32_t BATCH_COUNT = 16;      // CullingPushConstants::batchOffsets
+    constexpr uint32_t GRID_X = 16, GRID_Y = 9, GRID_Z = 24; // Hardcoded in cluster_culling.comp
+    constexpr uint32_t MAX_CLUSTER_LIGHTS = 256;              // cluster_culling.comp
+    constexpr uint32_t MAX_LIGHT_INDICES = GRID_X * GRID_Y * GRID_Z * 100;
+    constexpr uint32_t MAX_LIGHTS = 1024;     // LightData::lights
+    constexpr float Z_NEAR = 0.1f;
+    constexpr float Z_FAR = 1000.0f;
+
+    struct KernelResult
+    {
+        std::string kernel;
+        uint64_t elements = 0;
+        double medianUs = 0.0;
+        double minUs = 0.0;
+        uint64_t mismatches = 0;
+        uint64_t borderline = 0;
+    };
+
+    // Uniform in [min, max), identical on every standard library
+    float randomRange(std::mt19937& rng, float min, float max)
+    {
+        return min + static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f) * (max - min);
+    }
+
+    glm::mat4 clusterProjection(uint32_t gridX, uint32_t gridY)
+    {
+        return glm::perspective(glm::radians(60.0f), float(gridX) / float(gridY), Z_NEAR, Z_FAR);
+    }
+
+    // cluster_build.comp on the CPU
+    std::vector<ix::ClusterAABB> buildClustersReference(const ix::ClusterConstants& push)
+    {
+        std::vector<ix::ClusterAABB> clusters(push.gridX * push.gridY * push.gridZ);
+        auto screenToView = [&](const glm::vec4& screen) {
+            const glm::vec4 view = push.invProjection * screen;
+            return glm::vec3(view / view.w);
+            };
+
+        for (uint32_t z = 0; z < push.gridZ; z++)
+        {
+            const float sliceNear = push.zNear * std::pow(push.zFar / push.zNear, float(z) / float(push.gridZ));
+            const float sliceFar = push.zNear * std::pow(push.zFar / push.zNear, float(z + 1) / float(push.gridZ));
+            for (uint32_t y = 0; y < push.gridY; y++)
+            {
+                for (uint32_t x = 0; x < push.gridX; x++)
+                {
+                    const glm::vec2 texel = 1.0f / glm::vec2(float(push.gridX), float(push.gridY));
+                    const glm::vec2 minNDC = glm::vec2(float(x), float(y)) * texel * 2.0f - 1.0f;
+                    const glm::vec2 maxNDC = glm::vec2(float(x + 1), float(y + 1)) * texel * 2.0f - 1.0f;
+
+                    const glm::vec3 corners[4] = {
+                        screenToView({ minNDC.x, minNDC.y, 0.0f, 1.0f }), screenToView({ maxNDC.x, minNDC.y, 0.0f, 1.0f }),
+                        screenToView({ minNDC.x, maxNDC.y, 0.0f, 1.0f }), screenToView({ maxNDC.x, maxNDC.y, 0.0f, 1.0f }) };
+
+                    glm::vec3 minPoint(100000.0f), maxPoint(-100000.0f);
+                    for (const glm::vec3& corner : corners)
+                    {
+                        const glm::vec3 nearPoint = corner * (sliceNear / std::abs(corner.z));
+                        const glm::vec3 farPoint = corner * (sliceFar / std::abs(corner.z));
+                        minPoint = glm::min(minPoint, glm::min(nearPoint, farPoint));
+                        maxPoint = glm::max(maxPoint, glm::max(nearPoint, farPoint));
+                    }
+                    minPoint.z = -sliceFar;
+                    maxPoint.z = -sliceNear;
+
+                    ix::ClusterAABB& cluster = clusters[x + y * push.gridX + z * push.gridX * push.gridY];
+                    cluster.minPoint = glm::vec4(minPoint, 1.0f);
+                    cluster.maxPoint = glm::vec4(maxPoint, 1.0f);
+                }
+            }
+        }
+        return clusters;
+    }
+
+    // The windowless device plus one pipeline layout that fits all three kernels
+    class ComputeBench
+    {
+    public:
+        explicit ComputeBench(ix::VulkanContext& context)
+            : m_context(context)
+        {
+            VkDevice device = m_context.device();
+            const std::string shaderRoot = std::string(PROJECT_ROOT_DIR) + "/sandbox_game/res/shaders/spirV/";
+
+            // Set 0: the global bindings the kernels use (1-6), set 1 unused, set 2: culling input and output
+            auto createSetLayout = [&](std::initializer_list<uint32_t> bindings) {
+                std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+                for (uint32_t binding : bindings)
+                {
+                    layoutBindings.push_back({ binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr });
+                }
+                VkDescriptorSetLayoutCreateInfo layoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+                layoutCI.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+                layoutCI.pBindings = layoutBindings.data();
+                VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+                if (vkCreateDescriptorSetLayout(device, &layoutCI, nullptr, &layout) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("ComputeBench: Failed to create descriptor set layout");
+                }
+                return layout;
+                };
+            m_setLayouts[0] = createSetLayout({ 1, 2, 3, 4, 5, 6 });
+            m_setLayouts[1] = createSetLayout({});
+            m_setLayouts[2] = createSetLayout({ 0, 1, 2 });
+
+            VkPushConstantRange range{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ix::CullingPushConstants) };
+            VkPipelineLayoutCreateInfo pipelineLayoutCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+            pipelineLayoutCI.setLayoutCount = 3;
+            pipelineLayoutCI.pSetLayouts = m_setLayouts;
+            pipelineLayoutCI.pushConstantRangeCount = 1;
+            pipelineLayoutCI.pPushConstantRanges = &range;
+            if (vkCreatePipelineLayout(device, &pipelineLayoutCI, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+            {
+                throw std::runtime_error("ComputeBench: Failed to create pipeline layout");
+            }
+
+            VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 256 };
+            VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+            poolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+            poolCI.maxSets = 64;
+            poolCI.poolSizeCount = 1;
+            poolCI.pPoolSizes = &poolSize;
+            if (vkCreateDescriptorPool(device, &poolCI, nullptr, &m_descriptorPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("ComputeBench: Failed to create descriptor pool");
+            }
+
+            VkQueryPoolCreateInfo queryCI{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+            queryCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryCI.queryCount = (REPETITIONS + 1) * 2;
+            if (vkCreateQueryPool(device, &queryCI, nullptr, &m_queries) != VK_SUCCESS)
+            {
+                throw std::runtime_error("ComputeBench: Failed to create timestamp query pool");
+            }
+
+            m_frustumCull = std::make_unique<ix::VulkanComputePipeline>(m_context, shaderRoot + "frustum_culling.comp.spv", m_pipelineLayout);
+            m_clusterBuild = std::make_unique<ix::VulkanComputePipeline>(m_context, shaderRoot + "cluster_build.comp.spv", m_pipelineLayout);
+            m_clusterCull = std::make_unique<ix::VulkanComputePipeline>(m_context, shaderRoot + "cluster_culling.comp.spv", m_pipelineLayout);
+
+            // Stands in for bindings a kernel doesn't touch
+            m_dummy = createBuffer(sizeof(ix::LightData));
+
+            if (m_context.getCaps().timestampPeriod == 0.0f)
+            {
+                spdlog::warn("ComputeBench: No timestamp support on this queue, only the correctness checks run");
+            }
+        }
+
+        ~ComputeBench()
+        {
+            VkDevice device = m_context.device();
+            vkDeviceWaitIdle(device);
+            m_frustumCull.reset();
+            m_clusterBuild.reset();
+            m_clusterCull.reset();
+            m_dummy.reset();
+            vkDestroyQueryPool(device, m_queries, nullptr);
+            vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+            vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+            for (VkDescriptorSetLayout layout : m_setLayouts) vkDestroyDescriptorSetLayout(device, layout, nullptr);
+        }
+
+        KernelResult runFrustumCulling(uint32_t instanceCount, uint32_t seed)
+        {
+            std::mt19937 rng(seed);
+            const uint32_t perBatch = (instanceCount + BATCH_COUNT - 1) / BATCH_COUNT;
+
+            // Camera at the origin looking down -Z, instances all around it: roughly a fifth survives
+            ix::CullingPushConstants push{};
+            push.viewProj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, Z_NEAR, Z_FAR);
+            push.maxInstances = instanceCount;
+            for (uint32_t b = 0; b < BATCH_COUNT; b++) push.batchOffsets[b] = b * perBatch;
+
+            std::vector<ix::GPUInstanceData> instances(instanceCount);
+            std::vector<uint32_t> batchFill(BATCH_COUNT, 0);
+            for (uint32_t i = 0; i < instanceCount; i++)
+            {
+                ix::GPUInstanceData& instance = instances[i];
+                const glm::vec3 p(randomRange(rng, -300.0f, 300.0f), randomRange(rng, -100.0f, 100.0f), randomRange(rng, -600.0f, 200.0f));
+                instance.modelRows[0] = glm::vec4(1.0f, 0.0f, 0.0f, p.x);
+                instance.modelRows[1] = glm::vec4(0.0f, 1.0f, 0.0f, p.y);
+                instance.modelRows[2] = glm::vec4(0.0f, 0.0f, 1.0f, p.z);
+                instance.textureIndex = i; // Identifies the instance in the output
+                instance.boundingRadius = randomRange(rng, 0.5f, 4.0f);
+                instance.batchID = i % BATCH_COUNT;
+                batchFill[instance.batchID]++;
+            }
+
+            std::vector<ix::GPUIndirectCommand> commands(BATCH_COUNT);
+            for (uint32_t b = 0; b < BATCH_COUNT; b++) commands[b].indexCount = 36 * (b + 1);
+
+            auto input = createBuffer(instances.size() * sizeof(ix::GPUInstanceData));
+            auto output = createBuffer(static_cast<VkDeviceSize>(perBatch) * BATCH_COUNT * sizeof(ix::GPUInstanceData));
+            auto commandBuffer = createBuffer(commands.size() * sizeof(ix::GPUIndirectCommand));
+            auto pristineCommands = createBuffer(commands.size() * sizeof(ix::GPUIndirectCommand));
+            auto stats = createBuffer(sizeof(ix::GPUCullingStats));
+            input->uploadData(instances.data(), input->getBufferSize());
+            pristineCommands->uploadData(commands.data(), pristineCommands->getBufferSize());
+
+            VkDescriptorSet globalSet = allocateSet(0, { { 1, m_dummy.get() }, { 2, m_dummy.get() }, { 3, m_dummy.get() },
+                { 4, m_dummy.get() }, { 5, m_dummy.get() }, { 6, stats.get() } });
+            VkDescriptorSet cullingSet = allocateSet(2, { { 0, input.get() }, { 1, commandBuffer.get() }, { 2, output.get() } });
+
+            KernelResult result{ "frustum_culling", instanceCount };
+            timeKernel(result,
+                [&](VkCommandBuffer cmd) {
+                    VkBufferCopy copy{ 0, 0, pristineCommands->getBufferSize() };
+                    vkCmdCopyBuffer(cmd, pristineCommands->getBuffer(), commandBuffer->getBuffer(), 1, &copy);
+                    vkCmdFillBuffer(cmd, stats->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+                },
+                [&](VkCommandBuffer cmd) {
+                    m_frustumCull->bind(cmd);
+                    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &globalSet, 0, nullptr);
+                    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 2, 1, &cullingSet, 0, nullptr);
+                    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+                    vkCmdDispatch(cmd, (instanceCount + 63) / 64, 1, 1);
+                });
+
+            const auto gpuCommands = readBuffer<ix::GPUIndirectCommand>(*commandBuffer, BATCH_COUNT);
+            const auto gpuInstances = readBuffer<ix::GPUInstanceData>(*output, static_cast<size_t>(perBatch) * BATCH_COUNT);
+            const auto gpuStats = readBuffer<ix::GPUCullingStats>(*stats, 1)[0];
+
+            // isVisible() of frustum_culling.comp, with the margin to the nearest plane
+            auto classify = [&](const ix::GPUInstanceData& instance, bool& borderline) {
+                const glm::vec4 clip = push.viewProj * glm::vec4(instance.modelRows[0].w, instance.modelRows[1].w, instance.modelRows[2].w, 1.0f);
+                const float radius = instance.boundingRadius;
+                const float limit = clip.w + radius;
+                const float margin = std::min({ limit - std::abs(clip.x), limit - std::abs(clip.y), clip.z + radius, clip.w + radius - clip.z });
+                borderline = std::abs(margin) <= 1e-4f * (std::abs(clip.w) + radius + 1.0f);
+                return margin >= 0.0f;
+                };
+
+            uint64_t expectedTriangles = 0;
+            for (uint32_t b = 0; b < BATCH_COUNT; b++)
+            {
+                const uint32_t count = gpuCommands[b].instanceCount;
+                if (count > batchFill[b] || gpuStats.visibleInstances[b] != count) result.mismatches++;
+                expectedTriangles += static_cast<uint64_t>(count) * (commands[b].indexCount / 3);
+
+                std::set<uint32_t> gpuVisible;
+                for (uint32_t i = 0; i < std::min(count, perBatch); i++)
+                {
+                    const uint32_t id = gpuInstances[push.batchOffsets[b] + i].textureIndex;
+                    if (id >= instanceCount || instances[id].batchID != b || !gpuVisible.insert(id).second) result.mismatches++;
+                }
+
+                for (uint32_t id = b; id < instanceCount; id += BATCH_COUNT)
+                {
+                    bool borderline = false;
+                    const bool visible = classify(instances[id], borderline);
+                    if (visible == (gpuVisible.count(id) != 0)) continue;
+                    if (borderline) result.borderline++;
+                    else result.mismatches++;
+                }
+            }
+            if (gpuStats.trianglesSubmitted != expectedTriangles) result.mismatches++;
+
+            freeSets({ globalSet, cullingSet });
+            return result;
+        }
+
+        KernelResult runClusterBuild(uint32_t gridX, uint32_t gridY, uint32_t gridZ)
+        {
+            ix::ClusterConstants push{};
+            push.invProjection = glm::inverse(clusterProjection(gridX, gridY));
+            push.zNear = Z_NEAR;
+            push.zFar = Z_FAR;
+            push.gridX = gridX;
+            push.gridY = gridY;
+            push.gridZ = gridZ;
+
+            const uint32_t clusterCount = gridX * gridY * gridZ;
+            auto clusters = createBuffer(static_cast<VkDeviceSize>(clusterCount) * sizeof(ix::ClusterAABB));
+            VkDescriptorSet globalSet = allocateSet(0, { { 1, m_dummy.get() }, { 2, clusters.get() }, { 3, m_dummy.get() },
+                { 4, m_dummy.get() }, { 5, m_dummy.get() }, { 6, m_dummy.get() } });
+
+            KernelResult result{ "cluster_build", clusterCount };
+            timeKernel(result,
+                [](VkCommandBuffer) {},
+                [&](VkCommandBuffer cmd) {
+                    m_clusterBuild->bind(cmd);
+                    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &globalSet, 0, nullptr);
+                    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+                    vkCmdDispatch(cmd, gridX, gridY, gridZ);
+                });
+
+            const auto gpuClusters = readBuffer<ix::ClusterAABB>(*clusters, clusterCount);
+            const auto reference = buildClustersReference(push);
+            for (uint32_t i = 0; i < clusterCount; i++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    const float tolerance = 1e-3f * std::max(1.0f, std::abs(reference[i].maxPoint[c]) + std::abs(reference[i].minPoint[c]));
+                    if (std::abs(gpuClusters[i].minPoint[c] - reference[i].minPoint[c]) > tolerance ||
+                        std::abs(gpuClusters[i].maxPoint[c] - reference[i].maxPoint[c]) > tolerance)
+                    {
+                        result.mismatches++;
+                        break;
+                    }
+                }
+            }
+
+            freeSets({ globalSet });
+            return result;
+        }
+
+        KernelResult runClusterCulling(uint32_t lightCount, uint32_t seed)
+        {
+            std::mt19937 rng(seed);
+            const uint32_t clusterCount = GRID_X * GRID_Y * GRID_Z;
+
+            ix::ClusterConstants buildPush{};
+            buildPush.invProjection = glm::inverse(clusterProjection(GRID_X, GRID_Y));
+            buildPush.zNear = Z_NEAR;
+            buildPush.zFar = Z_FAR;
+            buildPush.gridX = GRID_X;
+            buildPush.gridY = GRID_Y;
+            buildPush.gridZ = GRID_Z;
+            const auto aabbs = buildClustersReference(buildPush);
+
+            // View space lights spread through the first few hundred units of the frustum
+            auto lightData = std::make_unique<ix::LightData>();
+            lightData->count = lightCount;
+            for (uint32_t i = 0; i < lightCount; i++)
+            {
+                const float z = -randomRange(rng, 1.0f, 300.0f);
+                const float halfWidth = -z * 0.6f;
+                lightData->lights[i].position = glm::vec4(randomRange(rng, -halfWidth, halfWidth), randomRange(rng, -halfWidth * 0.6f, halfWidth * 0.6f), z,
+                    randomRange(rng, 2.0f, 20.0f));
+                lightData->lights[i].color = glm::vec4(1.0f);
+            }
+
+            auto lights = createBuffer(sizeof(ix::LightData));
+            auto clusters = createBuffer(aabbs.size() * sizeof(ix::ClusterAABB));
+            auto grid = createBuffer(clusterCount * sizeof(ix::LightGrid));
+            auto indexList = createBuffer(MAX_LIGHT_INDICES * sizeof(uint32_t));
+            auto counter = createBuffer(sizeof(uint32_t));
+            auto stats = createBuffer(sizeof(ix::GPUCullingStats));
+            lights->uploadData(lightData.get(), sizeof(ix::LightData));
+            clusters->uploadData(aabbs.data(), clusters->getBufferSize());
+
+            VkDescriptorSet globalSet = allocateSet(0, { { 1, lights.get() }, { 2, clusters.get() }, { 3, grid.get() },
+                { 4, indexList.get() }, { 5, counter.get() }, { 6, stats.get() } });
+
+            KernelResult result{ "cluster_culling", static_cast<uint64_t>(clusterCount) * lightCount };
+            timeKernel(result,
+                [&](VkCommandBuffer cmd) {
+                    vkCmdFillBuffer(cmd, counter->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+                    vkCmdFillBuffer(cmd, stats->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+                },
+                [&](VkCommandBuffer cmd) {
+                    m_clusterCull->bind(cmd);
+                    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &globalSet, 0, nullptr);
+                    vkCmdDispatch(cmd, GRID_X, GRID_Y, GRID_Z);
+                });
+
+            const auto gpuGrid = readBuffer<ix::LightGrid>(*grid, clusterCount);
+            const auto gpuIndices = readBuffer<uint32_t>(*indexList, MAX_LIGHT_INDICES);
+            const auto gpuStats = readBuffer<ix::GPUCullingStats>(*stats, 1)[0];
+
+            uint64_t expectedReferences = 0;
+            uint64_t borderlineReferences = 0;
+            for (uint32_t c = 0; c < clusterCount; c++)
+            {
+                std::set<uint32_t> expected, ambiguous;
+                for (uint32_t i = 0; i < lightCount; i++)
+                {
+                    const glm::vec4& light = lightData->lights[i].position;
+                    float distSq = 0.0f;
+                    for (int j = 0; j < 3; j++)
+                    {
+                        const float v = light[j];
+                        if (v < aabbs[c].minPoint[j]) distSq += (aabbs[c].minPoint[j] - v) * (aabbs[c].minPoint[j] - v);
+                        if (v > aabbs[c].maxPoint[j]) distSq += (v - aabbs[c].maxPoint[j]) * (v - aabbs[c].maxPoint[j]);
+                    }
+                    const float radiusSq = light.w * light.w;
+                    if (std::abs(distSq - radiusSq) <= 1e-4f * std::max(1.0f, radiusSq)) ambiguous.insert(i);
+                    else if (distSq <= radiusSq) expected.insert(i);
+                }
+                expectedReferences += expected.size();
+                borderlineReferences += ambiguous.size();
+
+                // The shared list and the index list keep whichever lights arrive first, only check membership then
+                const ix::LightGrid& cell = gpuGrid[c];
+                const bool truncated = expected.size() + ambiguous.size() > MAX_CLUSTER_LIGHTS || gpuStats.droppedLightIndices != 0;
+                if (cell.count > MAX_CLUSTER_LIGHTS || static_cast<uint64_t>(cell.offset) + cell.count > MAX_LIGHT_INDICES)
+                {
+                    result.mismatches++;
+                    continue;
+                }
+
+                std::set<uint32_t> found;
+                for (uint32_t i = 0; i < cell.count; i++)
+                {
+                    const uint32_t index = gpuIndices[cell.offset + i];
+                    if (ambiguous.count(index)) result.borderline++;
+                    else if (!expected.count(index) || !found.insert(index).second) result.mismatches++;
+                }
+                if (!truncated && found.size() != expected.size()) result.mismatches++;
+            }
+
+            // Totals are counted before any clamping
+            if (gpuStats.totalLightReferences < expectedReferences || gpuStats.totalLightReferences > expectedReferences + borderlineReferences)
+            {
+                result.mismatches++;
+            }
+
+            freeSets({ globalSet });
+            return result;
+        }
+
+    private:
+        std::unique_ptr<ix::VulkanBuffer> createBuffer(VkDeviceSize size)
+        {
+            return std::make_unique<ix::VulkanBuffer>(m_context, size, 1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+        }
+
+        VkDescriptorSet allocateSet(uint32_t set, std::initializer_list<std::pair<uint32_t, ix::VulkanBuffer*>> bindings)
+        {
+            VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+            allocInfo.descriptorPool = m_descriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &m_setLayouts[set];
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            if (vkAllocateDescriptorSets(m_context.device(), &allocInfo, &descriptorSet) != VK_SUCCESS)
+            {
+                throw std::runtime_error("ComputeBench: Failed to allocate descriptor set");
+            }
+
+            std::vector<VkDescriptorBufferInfo> infos;
+            infos.reserve(bindings.size());
+            std::vector<VkWriteDescriptorSet> writes;
+            for (const auto& [binding, buffer] : bindings)
+            {
+                infos.push_back(buffer->descriptorInfo());
+                VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+                write.dstSet = descriptorSet;
+                write.dstBinding = binding;
+                write.descriptorCount = 1;
+                write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                write.pBufferInfo = &infos.back();
+                writes.push_back(write);
+            }
+            vkUpdateDescriptorSets(m_context.device(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+            return descriptorSet;
+        }
+
+        void freeSets(std::initializer_list<VkDescriptorSet> sets)
+        {
+            vkFreeDescriptorSets(m_context.device(), m_descriptorPool, static_cast<uint32_t>(sets.size()), sets.begin());
+        }
+
+        static void fullBarrier(VkCommandBuffer cmd)
+        {
+            VkMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+            VkDependencyInfo dependency{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+            dependency.memoryBarrierCount = 1;
+            dependency.pMemoryBarriers = &barrier;
+            vkCmdPipelineBarrier2(cmd, &dependency);
+        }
+
+        // One submission: a warm-up and REPETITIONS timed dispatches, each after its reset and a full barrier
+        void timeKernel(KernelResult& result, const std::function<void(VkCommandBuffer)>& reset, const std::function<void(VkCommandBuffer)>& dispatch)
+        {
+            const uint32_t runs = REPETITIONS + 1;
+            m_context.immediateSubmit([&](VkCommandBuffer cmd) {
+                vkCmdResetQueryPool(cmd, m_queries, 0, runs * 2);
+                for (uint32_t r = 0; r < runs; r++)
+                {
+                    reset(cmd);
+                    fullBarrier(cmd);
+                    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, m_queries, r * 2);
+                    dispatch(cmd);
+                    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, m_queries, r * 2 + 1);
+                    fullBarrier(cmd);
+                }
+                });
+
+            const double period = m_context.getCaps().timestampPeriod;
+            if (period == 0.0) return;
+
+            std::vector<uint64_t> timestamps(runs * 2);
+            if (vkGetQueryPoolResults(m_context.device(), m_queries, 0, runs * 2, timestamps.size() * sizeof(uint64_t), timestamps.data(),
+                sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) != VK_SUCCESS)
+            {
+                spdlog::warn("ComputeBench: Timestamp readback failed for {}", result.kernel);
+                return;
+            }
+
+            std::vector<double> samples;
+            for (uint32_t r = 1; r < runs; r++) samples.push_back((timestamps[r * 2 + 1] - timestamps[r * 2]) * period / 1000.0);
+            std::sort(samples.begin(), samples.end());
+            result.medianUs = samples[samples.size() / 2];
+            result.minUs = samples.front();
+        }
+
+        template<typename T>
+        std::vector<T> readBuffer(ix::VulkanBuffer& source, size_t count)
+        {
+            const VkDeviceSize size = count * sizeof(T);
+            ix::VulkanBuffer readback(m_context, size, 1, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+            m_context.immediateSubmit([&](VkCommandBuffer cmd) {
+                fullBarrier(cmd);
+                VkBufferCopy copy{ 0, 0, size };
+                vkCmdCopyBuffer(cmd, source.getBuffer(), readback.getBuffer(), 1, &copy);
+                fullBarrier(cmd);
+                });
+
+            std::vector<T> data(count);
+            readback.map();
+            readback.invalidate();
+            std::memcpy(data.data(), readback.getMappedData(), size);
+            readback.unmap();
+            return data;
+        }
+
+        ix::VulkanContext& m_context;
+        VkDescriptorSetLayout m_setLayouts[3]{};
+        VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+        VkQueryPool m_queries = VK_NULL_HANDLE;
+
+        std::unique_ptr<ix::VulkanComputePipeline> m_frustumCull;
+        std::unique_ptr<ix::VulkanComputePipeline> m_clusterBuild;
+        std::unique_ptr<ix::VulkanComputePipeline> m_clusterCull;
+        std::unique_ptr<ix::VulkanBuffer> m_dummy;
+    };
+
+    void printResult(const KernelResult& r)
+    {
+        const double throughput = r.medianUs > 0.0 ? r.elements / r.medianUs : 0.0; // Elements per microsecond = M/s
+        std::printf("%-18s %12llu %12.1f %12.1f %12.1f %10llu %10llu %6s\n", r.kernel.c_str(), static_cast<unsigned long long>(r.elements),
+            r.medianUs, r.minUs, throughput, static_cast<unsigned long long>(r.mismatches), static_cast<unsigned long long>(r.borderline),
+            r.mismatches == 0 ? "ok" : "FAIL");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = false;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "ix_compute_bench: Unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    ix::HeadlessPlatform platform(ix::WindowSpecification{});
+    ix::VulkanInstance instance("ix_compute_bench", true);
+    ix::VulkanContext context(instance, platform);
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(context.physicalDevice(), &properties);
+    std::printf("ix_compute_bench: %s\n\n", properties.deviceName);
+    std::printf("%-18s %12s %12s %12s %12s %10s %10s %6s\n", "kernel", "elements", "median us", "min us", "M elem/s", "mismatch", "border", "");
+
+    std::vector<KernelResult> results;
+    {
+        ComputeBench bench(context);
+        auto record = [&](KernelResult result) {
+            printResult(result);
+            results.push_back(std::move(result));
+            };
+
+        for (uint32_t count : { 1000u, 10000u, 100000u, 1000000u })
+        {
+            if (quick && count > 100000u) break;
+            record(bench.runFrustumCulling(count, 42));
+        }
+
+        // The renderer's 16x9x24 grid and finer ones up to ~1M clusters
+        const uint32_t grids[][3] = { { 16, 9, 24 }, { 32, 18, 48 }, { 64, 36, 96 }, { 96, 54, 192 } };
+        for (const auto& grid : grids)
+        {
+            if (quick && grid[0] > 32) break;
+            record(bench.runClusterBuild(grid[0], grid[1], grid[2]));
+        }
+
+        // Light culling is fixed to the renderer's grid and LightData's capacity
+        for (uint32_t lights : { 64u, 256u, MAX_LIGHTS })
+        {
+            record(bench.runClusterCulling(lights, 42));
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json report;
+    report["device"] = properties.deviceName;
+    report["results"] = nlohmann::json::array();
+    for (const KernelResult& r : results)
+    {
+        passed &= r.mismatches == 0;
+        report["results"].push_back({ { "kernel", r.kernel }, { "elements", r.elements }, { "medianUs", r.medianUs }, { "minUs", r.minUs },
+            { "mismatches", r.mismatches }, { "borderline", r.borderline } });
+    }
+
+    if (!jsonPath.empty())
+    {
+        std::ofstream file(jsonPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::fprintf(stderr, "ix_compute_bench: Could not write %s\n", jsonPath.c_str());
+            return 2;
+        }
+        file << report.dump(2);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+// engine_microbench.cpp
+// CPU hot paths in isolation, no device needed: instance database sync, light packing, TRS composition,
+// glTF decoding, scene JSON loading and asset lookups. Every case reports the median of several samples.
+// Usage: ix_microbench [--filter SUBSTRING] [--json out.json]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "core/asset_manager.h"
+#include "core/components.h"
+#include "core/job_system.h"
+#include "core/scene_manager.h"
+#include "core/transform_system.h"
+#include "platform/rendering/instance_table.h"
+#include "platform/rendering/vk/vk_renderer.h"
+
+namespace
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    constexpr int SAMPLES = 15;
+    constexpr double MIN_SAMPLE_NS = 200000.0; // Short cases repeat inside a sample until it takes this long
+    constexpr uint32_t MESH_COUNT = 8;
+    constexpr uint32_t MAX_BATCHES = 16;       // Same as the renderer
+    constexpr float MOVED_FRACTION = 0.1f;
+
+    struct Result
+    {
+        std::string name;
+        uint64_t items = 0;
+        uint32_t repetitions = 0;
+        double medianNs = 0.0;
+        double minNs = 0.0;
+    };
+
+    std::string g_filter;
+    std::vector<Result> g_results;
+
+    // `body` runs once per repetition; `setup` runs before every repetition and isn't timed
+    void run(const std::string& name, uint64_t items, const std::function<void()>& body, const std::function<void()>& setup = {})
+    {
+        if (!g_filter.empty() && name.find(g_filter) == std::string::npos) return;
+
+        auto sample = [&](uint32_t repetitions) {
+            if (!setup)
+            {
+                const auto start = clock::now();
+                for (uint32_t r = 0; r < repetitions; r++) body();
+                return std::chrono::duration<double, std::nano>(clock::now() - start).count() / repetitions;
+            }
+
+            double ns = 0.0;
+            for (uint32_t r = 0; r < repetitions; r++)
+            {
+                setup();
+                const auto start = clock::now();
+                body();
+                ns += std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            }
+            return ns / repetitions;
+            };
+
+        // Warm-up doubles as the calibration of the repetition count
+        const double first = sample(1);
+        const uint32_t repetitions = first >= MIN_SAMPLE_NS ? 1 : static_cast<uint32_t>(std::min(MIN_SAMPLE_NS / std::max(first, 1.0), 100000.0));
+
+        std::vector<double> samples;
+        for (int i = 0; i < SAMPLES; i++) samples.push_back(sample(repetitions));
+        std::sort(samples.begin(), samples.end());
+
+        Result result{ name, items, repetitions, samples[samples.size() / 2], samples.front() };
+        std::printf("%-40s %10llu %14.1f %14.1f %12.2f\n", name.c_str(), static_cast<unsigned long long>(items),
+            result.medianNs / 1000.0, result.minNs / 1000.0, result.medianNs / std::max<uint64_t>(items, 1));
+        g_results.push_back(result);
+    }
+
+    glm::vec3 gridPosition(uint32_t i)
+    {
+        return glm::vec3(float(i % 100), float((i / 100) % 100), float(i / 10000)) * 3.0f;
+    }
+
+    void populateInstances(ix::Scene& scene, uint32_t count, std::vector<ix::Entity>& entities)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ix::Entity entity = scene.createEntity("Instance");
+            entity.addComponent<ix::TransformComponent>();
+            entity.setPosition(gridPosition(i));
+            entity.addComponent<ix::MeshComponent>(1 + i % MESH_COUNT);
+            entities.push_back(entity);
+        }
+        scene.updateTransforms();
+    }
+
+    void benchInstanceTable(uint32_t count)
+    {
+        ix::Scene scene;
+        std::vector<ix::Entity> entities;
+        populateInstances(scene, count, entities);
+
+        ix::InstanceTable table(count * 2, MAX_BATCHES);
+        ix::RenderSnapshot snapshot;
+
+        // Scene switch: every slot is laid out and uploaded
+        run("instances/full_sync/" + std::to_string(count), count, [&]() {
+            table.clear();
+            table.sync(scene);
+            table.gatherChanges(snapshot);
+            });
+
+        // Steady state: a tenth of the entities moved this frame. Moving them and recomposing the
+        // transforms is setup, only the table's sync and the gather are timed
+        const uint32_t moved = std::max(1u, static_cast<uint32_t>(count * MOVED_FRACTION));
+        uint32_t frame = 0;
+        run("instances/delta_sync/" + std::to_string(count), moved, [&]() {
+            table.sync(scene);
+            table.gatherChanges(snapshot);
+            }, [&]() {
+            frame++;
+            for (uint32_t i = 0; i < moved; i++)
+            {
+                entities[(i * 10 + frame) % count].setPosition(gridPosition(i) + glm::vec3(float(frame & 7)));
+            }
+            scene.updateTransforms();
+            });
+    }
+
+    void benchLights(uint32_t count)
+    {
+        ix::Scene scene;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ix::Entity light = scene.createEntity("Light");
+            light.addComponent<ix::TransformComponent>();
+            light.setPosition(gridPosition(i));
+            auto& plc = light.addComponent<ix::PointLightComponent>();
+            plc.color = glm::vec3(float(i % 3), float(i % 5), float(i % 7)) * 0.2f;
+            plc.radius = 10.0f;
+        }
+
+        ix::RenderSnapshot snapshot;
+        snapshot.view.viewMatrix = glm::lookAt(glm::vec3(0.0f, 50.0f, 100.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        std::vector<ix::GPUPointLight> lightCache(count);
+
+        // View space packing, then updateLightBuffer's copy into the staging struct
+        run("lights/pack/" + std::to_string(count), count, [&]() {
+            ix::VulkanRenderer::extractLights(scene, snapshot);
+            std::copy(snapshot.lights.begin(), snapshot.lights.end(), lightCache.begin());
+            });
+    }
+
+    void benchCompose(uint32_t count)
+    {
+        std::vector<ix::TransformComponent> local(count);
+        std::vector<ix::WorldTransformComponent> world(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            local[i].position = gridPosition(i);
+            local[i].rotation = glm::angleAxis(float(i) * 0.001f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+            local[i].scale = glm::vec3(1.0f + float(i % 3));
+        }
+
+        run("transforms/compose/" + std::to_string(count), count, [&]() {
+            ix::composeAffineBatch(local.data(), world.data(), count);
+            });
+
+        // Baseline for the SIMD kernels above
+        run("transforms/compose_scalar/" + std::to_string(count), count, [&]() {
+            ix::composeAffineBatchScalar(local.data(), world.data(), count);
+            });
+    }
+
+    void benchGltf(const std::string& file)
+    {
+        const std::string path = std::string(PROJECT_ROOT_DIR) + "/sandbox_game/res/models/" + file;
+        ix::MeshData data;
+        if (!ix::AssetManager::decodeGLTF(path, data)) return;
+
+        run("gltf/decode/" + file, data.vertices.size(), [&]() {
+            ix::MeshData mesh;
+            ix::AssetManager::decodeGLTF(path, mesh);
+            });
+    }
+
+    void benchSceneLoad(uint32_t count)
+    {
+        // Transforms, lights and a camera: everything the loader parses without a device
+        nlohmann::json scene;
+        scene["entities"].push_back({ { "name", "Camera" }, { "transform", { { "pos", { 0, 4, 35 } } } }, { "camera", { { "fov", 75.0 } } } });
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const glm::vec3 p = gridPosition(i);
+            nlohmann::json entity = { { "name", "Entity_" + std::to_string(i) },
+                { "transform", { { "pos", { p.x, p.y, p.z } }, { "rot", { 0, float(i % 360), 0 } }, { "scale", { 1, 1, 1 } } } } };
+            if (i % 4 == 0) entity["pointLight"] = { { "color", { 1.0, 0.5, 0.25 } }, { "intensity", 2.0 }, { "radius", 10.0 } };
+            scene["entities"].push_back(std::move(entity));
+        }
+
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "ix_microbench";
+        std::filesystem::create_directories(directory);
+        const std::string name = "bench_scene_" + std::to_string(count);
+        std::ofstream(directory / (name + ".json")) << scene.dump();
+
+        ix::SceneManager::setSceneRoot(directory.string() + "/");
+        run("scene/load/" + std::to_string(count), count, [&]() { ix::SceneManager::load(name); });
+    }
+
+    void benchAssetLookups(ix::JobSystem& jobs, uint32_t count)
+    {
+        // Without a device the maps stay empty, so this is the shared lock and the hash probe,
+        // which is what the instance table pays per instance
+        ix::AssetManager& assets = ix::AssetManager::get();
+        std::vector<float> radii(count);
+
+        run("assets/lookup/" + std::to_string(count), count, [&]() {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                radii[i] = assets.getMeshBoundingRadius(1 + i % MESH_COUNT) + float(assets.getTextureBindlessIndex(i % 4));
+            }
+            });
+
+        // Every worker contends for the same shared_mutex
+        run("assets/lookup_parallel/" + std::to_string(count), count, [&]() {
+            jobs.parallelFor(0, count, 1024, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    radii[i] = assets.getMeshBoundingRadius(1 + i % MESH_COUNT) + float(assets.getTextureBindlessIndex(i % 4));
+                }
+                });
+            });
+    }
+
+    bool writeJson(const std::string& path)
+    {
+        nlohmann::json report;
+        report["samples"] = SAMPLES;
+        nlohmann::json results = nlohmann::json::array();
+        for (const Result& r : g_results)
+        {
+            results.push_back({ { "name", r.name }, { "items", r.items }, { "repetitions", r.repetitions },
+                { "medianNs", r.medianNs }, { "minNs", r.minNs }, { "nsPerItem", r.medianNs / std::max<uint64_t>(r.items, 1) } });
+        }
+        report["results"] = std::move(results);
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) return false;
+        file << report.dump(2);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) g_filter = argv[++i];
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "ix_microbench: Unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    // The scene loader and the batcher log per entity
+    spdlog::set_level(spdlog::level::warn);
+
+    ix::JobSystem jobs{ ix::JobSystemSpecification{} };
+    ix::SceneManager::init();
+
+    std::printf("%-40s %10s %14s %14s %12s\n", "case", "items", "median us", "min us", "ns/item");
+
+    for (uint32_t count : { 1000u, 10000u, 100000u }) benchInstanceTable(count);
+    for (uint32_t count : { 256u, 1024u, 4096u }) benchLights(count);
+    for (uint32_t count : { 1000u, 10000u, 100000u }) benchCompose(count);
+    for (const char* file : { "sphere.gltf", "sphere.glb", "plane.gltf" }) benchGltf(file);
+    for (uint32_t count : { 1000u, 10000u }) benchSceneLoad(count);
+    for (uint32_t count : { 1000u, 100000u }) benchAssetLookups(jobs, count);
+
+    ix::SceneManager::shutdown();
+
+    if (!jsonPath.empty() && !writeJson(jsonPath))
+    {
+        std::fprintf(stderr, "ix_microbench: Could not write %s\n", jsonPath.c_str());
+        return 2;
+    }
+    return 0;
+}
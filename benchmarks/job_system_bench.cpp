@@ -0,0 +1,112 @@
+// job_system_bench.cpp
+// Scaling of the job system across thread counts: a data-parallel TRS compose, a flood of tiny jobs
+// and a fan-out/fan-in dependency graph. Usage: ix_job_bench [maxThreads]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "core/job_system.h"
+#include "core/transform_system.h"
+
+namespace
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    constexpr size_t TRANSFORM_COUNT = 1 << 20;
+    constexpr size_t SMALL_JOB_COUNT = 100000;
+    constexpr uint32_t GRAPH_WIDTH = 64;
+    constexpr uint32_t GRAPH_DEPTH = 32;
+    constexpr int RUNS = 7;
+
+    template<typename Func>
+    double medianMs(Func&& func)
+    {
+        std::vector<double> samples;
+        for (int i = 0; i < RUNS; i++)
+        {
+            auto start = clock::now();
+            func();
+            samples.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    // Busy work that the optimizer cannot drop
+    void spin(uint32_t iterations, std::atomic<uint32_t>& sink)
+    {
+        uint32_t x = iterations;
+        for (uint32_t i = 0; i < iterations; i++) x = x * 1664525u + 1013904223u;
+        sink.fetch_add(x & 1, std::memory_order_relaxed);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t maxThreads = argc > 1 ? std::max(1, std::atoi(argv[1])) : hardware;
+
+    std::vector<ix::TransformComponent> local(TRANSFORM_COUNT);
+    std::vector<ix::WorldTransformComponent> world(TRANSFORM_COUNT);
+    for (size_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        local[i].position = glm::vec3(float(i), float(i % 7), float(i % 13));
+        local[i].rotation = glm::angleAxis(float(i) * 0.001f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+        local[i].scale = glm::vec3(1.0f + float(i % 3));
+    }
+
+    std::printf("%-8s %14s %8s %14s %8s %14s %8s\n", "threads", "compose ms", "x", "small jobs ms", "x", "graph ms", "x");
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    double baseCompose = 0.0, baseSmall = 0.0, baseGraph = 0.0;
+    for (uint32_t threads : threadCounts)
+    {
+        ix::JobSystemSpecification spec;
+        spec.workerCount = threads - 1;
+        ix::JobSystem jobs(spec);
+        std::atomic<uint32_t> sink{ 0 };
+
+        const double compose = medianMs([&]() {
+            jobs.parallelFor(0, TRANSFORM_COUNT, 4096, [&](size_t begin, size_t end) {
+                ix::composeAffineBatch(local.data() + begin, world.data() + begin, end - begin);
+                });
+            });
+
+        const double small = medianMs([&]() {
+            ix::JobCounter counter;
+            for (size_t i = 0; i < SMALL_JOB_COUNT; i++) jobs.schedule([&sink]() { spin(64, sink); }, &counter);
+            jobs.wait(counter);
+            });
+
+        // Every layer fans out GRAPH_WIDTH jobs that depend on the whole previous layer
+        const double graph = medianMs([&]() {
+            std::vector<ix::JobCounter> layers(GRAPH_DEPTH);
+            for (uint32_t w = 0; w < GRAPH_WIDTH; w++) jobs.schedule([&sink]() { spin(20000, sink); }, &layers[0]);
+            for (uint32_t d = 1; d < GRAPH_DEPTH; d++)
+            {
+                for (uint32_t w = 0; w < GRAPH_WIDTH; w++) jobs.scheduleAfter(layers[d - 1], [&sink]() { spin(20000, sink); }, &layers[d]);
+            }
+            for (auto& layer : layers) jobs.wait(layer);
+            });
+
+        if (threads == 1)
+        {
+            baseCompose = compose;
+            baseSmall = small;
+            baseGraph = graph;
+        }
+
+        std::printf("%-8u %14.3f %8.2f %14.3f %8.2f %14.3f %8.2f\n", threads,
+            compose, baseCompose / compose, small, baseSmall / small, graph, baseGraph / graph);
+    }
+
+    return 0;
+}
@@ -0,0 +1,467 @@
+// scene_bench.cpp
+// Deterministic scene benchmark: generates a scene from a handful of parameters, renders it headless for a
+// fixed number of frames and reports CPU/GPU frame time percentiles and per-pass GPU timings.
+// Usage: ix_bench [--instances N] [--meshes M] [--lights L] [--camera static|orbit] [--moving PERCENT]
+//                 [--frames F] [--warmup W] [--seed S] [--width W] [--height H] [--pipelined]
+//                 [--json out.json] [--csv out.csv]
+//        ix_bench --compare base.json new.json [--threshold PERCENT]
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <nlohmann/json.hpp>
+
+#include "engine.h"
+#include "layer_i.h"
+#include "core/components.h"
+#include "core/scene_manager.h"
+#include "platform/rendering/vk/vk_context.h"
+#include "platform/rendering/vk/vk_gpu_profiler.h"
+#include "platform/rendering/vk/vk_renderer.h"
+
+namespace
+{
+    // Every model the sandbox ships, one mesh handle (and draw batch) each
+    const char* const MESH_FILES[] = { "sphere.gltf", "plane.gltf", "sphere.glb" };
+    constexpr uint32_t MESH_FILE_COUNT = sizeof(MESH_FILES) / sizeof(MESH_FILES[0]);
+
+    constexpr float GRID_SPACING = 4.0f;
+    constexpr float MOVE_AMPLITUDE = 1.5f;
+    constexpr float SIM_STEP = 1.0f / 60.0f; // Motion is driven by the frame index, not the wall clock
+
+    struct BenchConfig
+    {
+        uint32_t instances = 2500; // At most VulkanRenderer::MAX_INSTANCES
+        uint32_t meshes = MESH_FILE_COUNT;
+        uint32_t lights = 150;
+        bool orbitCamera = false;
+        float movingPercent = 0.0f;
+        uint32_t frames = 600;
+        uint32_t warmup = 60;
+        uint32_t seed = 42;
+        uint32_t width = 1280;
+        uint32_t height = 720;
+        bool pipelined = false;
+        std::string jsonPath;
+        std::string csvPath;
+    };
+
+    struct Percentiles
+    {
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        double average = 0.0;
+    };
+
+    // Filled on the render thread by the layer, read by main once the engine stopped
+    struct BenchResults
+    {
+        std::map<std::string, std::vector<double>> passMs;
+        std::vector<double> visibleInstances;
+        std::vector<double> triangles;
+        std::string deviceName;
+    };
+
+    Percentiles computePercentiles(std::vector<double> samples)
+    {
+        Percentiles result;
+        if (samples.empty()) return result;
+
+        std::sort(samples.begin(), samples.end());
+        auto rank = [&](double fraction) {
+            const size_t index = static_cast<size_t>(std::ceil(fraction * samples.size()));
+            return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+            };
+
+        double sum = 0.0;
+        for (double sample : samples) sum += sample;
+
+        result.p50 = rank(0.50);
+        result.p95 = rank(0.95);
+        result.p99 = rank(0.99);
+        result.max = samples.back();
+        result.average = sum / samples.size();
+        return result;
+    }
+
+    // Uniform in [0, 1), identical on every standard library unlike std::uniform_real_distribution
+    float unitFloat(std::mt19937& rng)
+    {
+        return static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    class SceneBenchLayer : public ix::Layer_I
+    {
+    public:
+        SceneBenchLayer(const BenchConfig& config, BenchResults& results)
+            : m_config(config), m_results(results) {}
+
+        void onAttach() override
+        {
+            const std::string resPath = std::string(PROJECT_ROOT_DIR) + "/sandbox_game/res/";
+            ix::AssetManager::get().setModelRoot(resPath + "models/");
+            ix::AssetManager::get().setTextureRoot(resPath + "textures/");
+
+            std::ifstream pipelineFile(resPath + "pipelines/default_pipelines.json");
+            if (pipelineFile.is_open())
+            {
+                ix::Engine::get().getRenderer().loadPipelines(nlohmann::json::parse(pipelineFile));
+            }
+
+            buildScene();
+
+            auto& renderer = static_cast<ix::VulkanRenderer&>(ix::Engine::get().getRenderer());
+            auto* context = static_cast<ix::VulkanContext*>(renderer.getAPIContext());
+            VkPhysicalDeviceProperties properties{};
+            vkGetPhysicalDeviceProperties(context->physicalDevice(), &properties);
+            m_results.deviceName = properties.deviceName;
+        }
+
+        // Game thread in pipelined mode
+        void onUpdate(float dt) override
+        {
+            const float t = static_cast<float>(m_simFrame++) * SIM_STEP;
+            auto& scene = ix::SceneManager::getActiveScene();
+
+            for (size_t i = 0; i < m_moving.size(); i++)
+            {
+                const float phase = static_cast<float>(i) * 0.37f;
+                const glm::vec3 offset(std::sin(t + phase), 0.0f, std::cos(t + phase));
+                m_moving[i].setPosition(m_movingBase[i] + offset * MOVE_AMPLITUDE);
+            }
+
+            if (m_config.orbitCamera)
+            {
+                const float angle = t * 0.25f;
+                const glm::vec3 position(std::sin(angle) * m_orbitRadius, m_extent * 0.5f, std::cos(angle) * m_orbitRadius);
+                m_camera.setPosition(position);
+                m_camera.setRotation(glm::quatLookAt(glm::normalize(-position), glm::vec3(0.0f, 1.0f, 0.0f)));
+            }
+
+            scene.update(dt, ix::Engine::get().getInput(), &ix::Engine::get().getJobSystem());
+        }
+
+        // Render thread, after the frame was recorded
+        void onRender(float alpha) override
+        {
+            const uint32_t frame = m_renderFrame++;
+            if (frame < m_config.warmup) return;
+            if (frame == m_config.warmup) ix::Engine::get().getFrameStats().reset();
+
+            auto& renderer = static_cast<ix::VulkanRenderer&>(ix::Engine::get().getRenderer());
+            const ix::RenderStats stats = renderer.getStats();
+            m_results.visibleInstances.push_back(stats.visibleInstances);
+            m_results.triangles.push_back(stats.triangleCount);
+
+            if (const ix::VulkanGpuProfiler* profiler = renderer.getGpuProfiler())
+            {
+                for (const auto& pass : profiler->getResults()) m_results.passMs[pass.name].push_back(pass.gpuMs);
+            }
+        }
+
+    private:
+        void buildScene()
+        {
+            auto& scene = ix::SceneManager::getActiveScene();
+            auto& assetManager = ix::AssetManager::get();
+            std::mt19937 rng(m_config.seed);
+
+            std::vector<ix::AssetHandle> meshes;
+            for (uint32_t i = 0; i < m_config.meshes; i++) meshes.push_back(assetManager.loadModel(MESH_FILES[i]));
+
+            // Instances on a cube grid centered at the origin
+            const uint32_t side = std::max(1u, static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(m_config.instances)))));
+            m_extent = side * GRID_SPACING;
+            const float half = m_extent * 0.5f;
+
+            for (uint32_t i = 0; i < m_config.instances; i++)
+            {
+                const glm::vec3 position(
+                    (i % side) * GRID_SPACING - half,
+                    ((i / side) % side) * GRID_SPACING,
+                    (i / (side * side)) * GRID_SPACING - half);
+
+                ix::Entity entity = scene.createEntity("BenchInstance");
+                entity.addComponent<ix::TransformComponent>();
+                entity.setPosition(position);
+                entity.setRotation(glm::angleAxis(unitFloat(rng) * 6.2831853f, glm::vec3(0.0f, 1.0f, 0.0f)));
+                entity.addComponent<ix::MeshComponent>(meshes[rng() % meshes.size()]);
+
+                if (unitFloat(rng) * 100.0f < m_config.movingPercent)
+                {
+                    m_moving.push_back(entity);
+                    m_movingBase.push_back(position);
+                }
+            }
+
+            for (uint32_t i = 0; i < m_config.lights; i++)
+            {
+                ix::Entity light = scene.createEntity("BenchLight");
+                light.addComponent<ix::TransformComponent>();
+                light.setPosition({ unitFloat(rng) * m_extent - half, unitFloat(rng) * m_extent, unitFloat(rng) * m_extent - half });
+
+                auto& plc = light.addComponent<ix::PointLightComponent>();
+                plc.color = glm::vec3(unitFloat(rng), unitFloat(rng), unitFloat(rng));
+                plc.intensity = 3.0f;
+                plc.radius = GRID_SPACING * 4.0f;
+            }
+
+            // Static camera looks at the grid from the front, the orbit keeps it in view from every side
+            m_orbitRadius = m_extent * 1.2f + 10.0f;
+            m_camera = scene.createEntity("BenchCamera");
+            m_camera.addComponent<ix::TransformComponent>();
+            m_camera.addComponent<ix::CameraComponent>();
+            const glm::vec3 cameraPosition(0.0f, m_extent * 0.5f, m_orbitRadius);
+            m_camera.setPosition(cameraPosition);
+            m_camera.setRotation(glm::quatLookAt(glm::normalize(-cameraPosition), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+            std::printf("ix_bench: %u instances (%zu moving) over %u meshes, %u lights, %s camera\n",
+                m_config.instances, m_moving.size(), m_config.meshes, m_config.lights, m_config.orbitCamera ? "orbit" : "static");
+        }
+
+        BenchConfig m_config;
+        BenchResults& m_results;
+
+        std::vector<ix::Entity> m_moving;
+        std::vector<glm::vec3> m_movingBase;
+        ix::Entity m_camera;
+        float m_extent = 0.0f;
+        float m_orbitRadius = 0.0f;
+
+        uint32_t m_simFrame = 0;
+        uint32_t m_renderFrame = 0;
+    };
+
+    nlohmann::json toJson(const Percentiles& p)
+    {
+        return { { "p50", p.p50 }, { "p95", p.p95 }, { "p99", p.p99 }, { "max", p.max }, { "average", p.average } };
+    }
+
+    nlohmann::json buildReport(const BenchConfig& config, const BenchResults& results, ix::FrameStats& frameStats)
+    {
+        nlohmann::json report;
+        report["device"] = results.deviceName;
+        report["config"] = {
+            { "instances", config.instances }, { "meshes", config.meshes }, { "lights", config.lights },
+            { "camera", config.orbitCamera ? "orbit" : "static" }, { "movingPercent", config.movingPercent },
+            { "frames", config.frames }, { "warmup", config.warmup }, { "seed", config.seed },
+            { "width", config.width }, { "height", config.height }, { "pipelined", config.pipelined }
+        };
+
+        nlohmann::json metrics = nlohmann::json::object();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(ix::FrameMetric::Count); i++)
+        {
+            const auto metric = static_cast<ix::FrameMetric>(i);
+            const ix::FrameMetricSummary summary = frameStats.getSummary(metric);
+            if (summary.samples == 0) continue;
+            metrics[ix::FrameStats::getMetricName(metric)] = toJson({ summary.p50, summary.p95, summary.p99, summary.max, summary.average });
+        }
+        report["metrics"] = std::move(metrics);
+
+        nlohmann::json passes = nlohmann::json::object();
+        for (const auto& [name, samples] : results.passMs) passes[name] = toJson(computePercentiles(samples));
+        report["passes"] = std::move(passes);
+
+        report["visibleInstances"] = computePercentiles(results.visibleInstances).average;
+        report["triangles"] = computePercentiles(results.triangles).average;
+        return report;
+    }
+
+    bool writeCsv(const std::string& path, const nlohmann::json& report)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file << "kind,name,p50,p95,p99,max,average\n";
+        auto writeRows = [&](const char* kind, const nlohmann::json& group) {
+            for (const auto& [name, p] : group.items())
+            {
+                file << kind << ',' << name << ',' << p["p50"].get<double>() << ',' << p["p95"].get<double>() << ','
+                    << p["p99"].get<double>() << ',' << p["max"].get<double>() << ',' << p["average"].get<double>() << '\n';
+            }
+            };
+        writeRows("metric", report["metrics"]);
+        writeRows("pass", report["passes"]);
+        return true;
+    }
+
+    void printReport(const nlohmann::json& report)
+    {
+        std::printf("\n%-28s %10s %10s %10s %10s %10s\n", "ms", "p50", "p95", "p99", "max", "avg");
+        auto printRows = [](const nlohmann::json& group) {
+            for (const auto& [name, p] : group.items())
+            {
+                std::printf("%-28s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name.c_str(), p["p50"].get<double>(),
+                    p["p95"].get<double>(), p["p99"].get<double>(), p["max"].get<double>(), p["average"].get<double>());
+            }
+            };
+        printRows(report["metrics"]);
+        printRows(report["passes"]);
+        std::printf("\nvisible instances %.0f, triangles %.0f, device %s\n", report["visibleInstances"].get<double>(),
+            report["triangles"].get<double>(), report["device"].get<std::string>().c_str());
+    }
+
+    bool loadReport(const char* path, nlohmann::json& report)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            std::fprintf(stderr, "ix_bench: Could not open %s\n", path);
+            return false;
+        }
+        report = nlohmann::json::parse(file, nullptr, false);
+        if (report.is_discarded() || !report.contains("metrics"))
+        {
+            std::fprintf(stderr, "ix_bench: %s is not an ix_bench report\n", path);
+            return false;
+        }
+        return true;
+    }
+
+    // Exit code 1 when any p50 got slower by more than thresholdPercent
+    int compareReports(const char* basePath, const char* newPath, double thresholdPercent)
+    {
+        nlohmann::json base, next;
+        if (!loadReport(basePath, base) || !loadReport(newPath, next)) return 2;
+
+        if (base["config"] != next["config"]) std::printf("ix_bench: Warning, the runs used different configurations\n");
+        if (base["device"] != next["device"]) std::printf("ix_bench: Warning, the runs used different devices\n");
+
+        bool regressed = false;
+        std::printf("%-28s %10s %10s %8s %10s %10s %8s\n", "ms", "base p50", "new p50", "delta", "base p95", "new p95", "delta");
+        auto compareGroup = [&](const char* group) {
+            for (const auto& [name, b] : base[group].items())
+            {
+                if (!next[group].contains(name)) continue;
+                const auto& n = next[group][name];
+
+                const double b50 = b["p50"].get<double>(), n50 = n["p50"].get<double>();
+                const double b95 = b["p95"].get<double>(), n95 = n["p95"].get<double>();
+                const double d50 = b50 > 0.0 ? (n50 - b50) / b50 * 100.0 : 0.0;
+                const double d95 = b95 > 0.0 ? (n95 - b95) / b95 * 100.0 : 0.0;
+                const bool slower = d50 > thresholdPercent;
+                regressed |= slower;
+
+                std::printf("%-28s %10.3f %10.3f %+7.1f%% %10.3f %10.3f %+7.1f%%%s\n", name.c_str(),
+                    b50, n50, d50, b95, n95, d95, slower ? "  REGRESSION" : "");
+            }
+            };
+        compareGroup("metrics");
+        compareGroup("passes");
+
+        return regressed ? 1 : 0;
+    }
+
+    bool parseArgs(int argc, char** argv, BenchConfig& config)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char* arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            auto value = [&]() { return argv[++i]; };
+
+            if (std::strcmp(arg, "--instances") == 0 && hasValue) config.instances = std::atoi(value());
+            else if (std::strcmp(arg, "--meshes") == 0 && hasValue) config.meshes = std::atoi(value());
+            else if (std::strcmp(arg, "--lights") == 0 && hasValue) config.lights = std::atoi(value());
+            else if (std::strcmp(arg, "--camera") == 0 && hasValue) config.orbitCamera = std::strcmp(value(), "orbit") == 0;
+            else if (std::strcmp(arg, "--moving") == 0 && hasValue) config.movingPercent = static_cast<float>(std::atof(value()));
+            else if (std::strcmp(arg, "--frames") == 0 && hasValue) config.frames = std::atoi(value());
+            else if (std::strcmp(arg, "--warmup") == 0 && hasValue) config.warmup = std::atoi(value());
+            else if (std::strcmp(arg, "--seed") == 0 && hasValue) config.seed = std::atoi(value());
+            else if (std::strcmp(arg, "--width") == 0 && hasValue) config.width = std::atoi(value());
+            else if (std::strcmp(arg, "--height") == 0 && hasValue) config.height = std::atoi(value());
+            else if (std::strcmp(arg, "--json") == 0 && hasValue) config.jsonPath = value();
+            else if (std::strcmp(arg, "--csv") == 0 && hasValue) config.csvPath = value();
+            else if (std::strcmp(arg, "--pipelined") == 0) config.pipelined = true;
+            else
+            {
+                std::fprintf(stderr, "ix_bench: Unknown argument %s\n", arg);
+                return false;
+            }
+        }
+
+        if (config.meshes == 0 || config.meshes > MESH_FILE_COUNT)
+        {
+            std::printf("ix_bench: %u meshes requested, %u available\n", config.meshes, MESH_FILE_COUNT);
+            config.meshes = std::clamp(config.meshes, 1u, MESH_FILE_COUNT);
+        }
+        // More would leave entities out of the instance database, the report would describe a scene that wasn't drawn
+        if (config.instances > ix::VulkanRenderer::MAX_INSTANCES)
+        {
+            std::printf("ix_bench: %u instances requested, the renderer holds %u\n", config.instances, ix::VulkanRenderer::MAX_INSTANCES);
+            config.instances = ix::VulkanRenderer::MAX_INSTANCES;
+        }
+        config.frames = std::max(1u, config.frames);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--compare") == 0)
+    {
+        if (argc < 4)
+        {
+            std::fprintf(stderr, "ix_bench: --compare base.json new.json [--threshold PERCENT]\n");
+            return 2;
+        }
+        const double threshold = argc > 5 && std::strcmp(argv[4], "--threshold") == 0 ? std::atof(argv[5]) : 5.0;
+        return compareReports(argv[2], argv[3], threshold);
+    }
+
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) return 2;
+
+    BenchResults results;
+    nlohmann::json report;
+    {
+        ix::EngineSpecification spec;
+        spec.name = "ix_bench";
+        spec.windowSpec.mode = ix::WindowMode::Windowed;
+        spec.windowSpec.width = config.width;
+        spec.windowSpec.height = config.height;
+        spec.pipelinedRendering = config.pipelined;
+        spec.headless.enabled = true;
+        spec.headless.frameCount = config.warmup + config.frames;
+        spec.frameStats.windowSize = config.frames;
+        spec.frameStats.snapshotHitches = false;
+        spec.frameStats.hitchThresholdMs = 1000.0f; // Software drivers hitch constantly, the percentiles tell the story
+
+        ix::Engine engine(spec);
+        engine.pushLayer<SceneBenchLayer>(config, results);
+        engine.init();
+        engine.run();
+
+        report = buildReport(config, results, engine.getFrameStats());
+    }
+
+    printReport(report);
+
+    if (!config.jsonPath.empty())
+    {
+        std::ofstream file(config.jsonPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::fprintf(stderr, "ix_bench: Could not write %s\n", config.jsonPath.c_str());
+            return 2;
+        }
+        file << report.dump(2);
+    }
+    if (!config.csvPath.empty() && !writeCsv(config.csvPath, report))
+    {
+        std::fprintf(stderr, "ix_bench: Could not write %s\n", config.csvPath.c_str());
+        return 2;
+    }
+    return 0;
+}
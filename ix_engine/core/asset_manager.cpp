@@ -44,6 +44,7 @@ namespace ix
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY
         );
+        m_globalVBO->setMemoryTag(MemoryCategory::Geometry, "Global VBO");
 
         // Initialize Global IBO (2 Million Indices)
         const size_t indexBufferSize = 2000000 * sizeof(uint32_t);
@@ -54,6 +55,7 @@ namespace ix
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY
         );
+        m_globalIBO->setMemoryTag(MemoryCategory::Geometry, "Global IBO");
 
         // Track offsets
         m_currentVertexOffset = 0;
@@ -71,6 +73,7 @@ namespace ix
 
                 AssetHandle handle = loadModel(path);
 
+                std::unique_lock lock(m_assetMutex);
                 m_pathMap[name] = handle;
             }
         }
@@ -83,14 +86,17 @@ namespace ix
      
 
         // Prevent double loading (using the name as the key)
-        if (m_pathMap.count(name)) {
-            return m_pathMap[name];
+        {
+            std::shared_lock lock(m_assetMutex);
+            auto it = m_pathMap.find(name);
+            if (it != m_pathMap.end()) return it->second;
         }
 
         spdlog::info("AssetManager: Starting load of {}", fullPath);
         auto mesh = loadGLTF(fullPath);
 
         if (mesh) {
+            std::unique_lock lock(m_assetMutex);
             AssetHandle handle = m_nextMeshHandle++;
 
             m_meshRadii[handle] = mesh->boundingRadius;
@@ -103,13 +109,8 @@ namespace ix
         return 0;
     }
 
-    std::unique_ptr<VulkanMesh> AssetManager::loadGLTF(const std::string& path)
+    bool AssetManager::decodeGLTF(const std::string& path, MeshData& out)
     {
-        if (!m_context) 
-        { 
-            spdlog::error("AssetManager::loadGLTF missing context");
-            return nullptr;
-        }
         tinygltf::Model model;
         tinygltf::TinyGLTF loader;
         std::string err, warn;
@@ -119,7 +120,7 @@ namespace ix
         if (!stream) 
         {
             spdlog::error("AssetManager: System failed to open file at: {}", path);
-            return nullptr;
+            return false;
         }
 
         // Get the directory containing the file
@@ -138,7 +139,7 @@ namespace ix
             std::ifstream ifile(path);
             if (!ifile.is_open()) {
                 spdlog::error("AssetManager: Could not open file stream at {}", path);
-                return nullptr;
+                return false;
             }
 
             std::stringstream buffer;
@@ -152,18 +153,18 @@ namespace ix
         if (!success) 
         {
             spdlog::error("AssetManager: GLTF Parse Error: {} (Warn: {})", err, warn);
-            return nullptr;
+            return false;
         }
 
         // Extract Data from first mesh/primitive
         const auto& mesh = model.meshes[0];
         const auto& primitive = mesh.primitives[0];
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        std::vector<Vertex>& vertices = out.vertices;
+        std::vector<uint32_t>& indices = out.indices;
 
         // Position Data 
-        if (primitive.attributes.count("POSITION") == 0) return nullptr;
+        if (primitive.attributes.count("POSITION") == 0) return false;
         const auto& posAccessor = model.accessors[primitive.attributes.at("POSITION")];
         const auto& posView = model.bufferViews[posAccessor.bufferView];
         const auto& posBuffer = model.buffers[posView.buffer];
@@ -196,7 +197,7 @@ namespace ix
             vertices[i].color = glm::vec4(1.0f);
         }
 
-        float meshRadius = std::sqrt(maxDistSq);
+        out.boundingRadius = std::sqrt(maxDistSq);
 
         // Index Data 
         const auto& idxAccessor = model.accessors[primitive.indices];
@@ -215,6 +216,24 @@ namespace ix
             for (size_t i = 0; i < idxAccessor.count; i++) indices[i] = buf[i];
         }
 
+        return true;
+    }
+
+    std::unique_ptr<VulkanMesh> AssetManager::loadGLTF(const std::string& path)
+    {
+        if (!m_context) 
+        { 
+            spdlog::error("AssetManager::loadGLTF missing context");
+            return nullptr;
+        }
+
+        MeshData data;
+        if (!decodeGLTF(path, data)) return nullptr;
+        const std::vector<Vertex>& vertices = data.vertices;
+        const std::vector<uint32_t>& indices = data.indices;
+        const float meshRadius = data.boundingRadius;
+        std::filesystem::path osPath(path);
+
         // GPU Upload
         auto gpuMesh = std::make_unique<VulkanMesh>();
         gpuMesh->baseVertex = m_currentVertexOffset;
@@ -245,7 +264,11 @@ namespace ix
 
     TextureHandle AssetManager::loadTexture(const std::string& path, bool isHDR)
     {
-        if (m_pathMap.count(path)) return m_pathMap[path];
+        {
+            std::shared_lock lock(m_assetMutex);
+            auto it = m_pathMap.find(path);
+            if (it != m_pathMap.end()) return it->second;
+        }
 
         std::string fullPath = m_texRoot + path;
         int width, height, channels;
@@ -259,8 +282,6 @@ namespace ix
                 return 0;
             }
 
-            TextureHandle handle = m_nextTextureHandle++;
-
             auto sourceImage = std::make_unique<VulkanImage>(
                 *m_context, VkExtent2D{ (uint32_t)width, (uint32_t)height },
                 VK_FORMAT_R32G32B32A32_SFLOAT,
@@ -277,15 +298,17 @@ namespace ix
                 VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT, 6, true
             );
 
+            auto sourceInfo = sourceImage->getDescriptorInfo(m_defaultSampler);
+            auto cubeInfo = cubemap->getDescriptorInfo(m_defaultSampler);
+
+            std::unique_lock assetLock(m_assetMutex);
+            TextureHandle handle = m_nextTextureHandle++;
             uint32_t sourceSlot = m_nextTextureSlot++;
             uint32_t cubeSlot = m_nextTextureSlot++;
 
             m_hdrSourceBindlessSlots[handle] = sourceSlot;
             m_textureToBindlessSlot[handle] = cubeSlot;
 
-            auto sourceInfo = sourceImage->getDescriptorInfo(m_defaultSampler);
-            auto cubeInfo = cubemap->getDescriptorInfo(m_defaultSampler);
-
             m_hdrSources[handle] = std::move(sourceImage);
             m_textures[handle] = std::move(cubemap);
             m_pathMap[path] = handle;
@@ -315,6 +338,9 @@ namespace ix
         image->uploadData(pixels, width * height * 4);
         stbi_image_free(pixels);
 
+        auto info = image->getDescriptorInfo(m_defaultSampler);
+
+        std::unique_lock assetLock(m_assetMutex);
         TextureHandle handle = m_nextTextureHandle++;
         uint32_t slot = m_nextTextureSlot++;
 
@@ -322,7 +348,6 @@ namespace ix
         m_textureToBindlessSlot[handle] = slot;
         m_pathMap[path] = handle;
 
-        auto info = m_textures[handle]->getDescriptorInfo(m_defaultSampler);
         {
             std::lock_guard<std::mutex> lock(m_queueMutex);
             m_updateQueue.push({ slot, info });
@@ -333,27 +358,35 @@ namespace ix
 
     uint32_t AssetManager::getTextureBindlessIndex(TextureHandle handle)
     {
+        std::shared_lock lock(m_assetMutex);
         auto it = m_textureToBindlessSlot.find(handle);
         return (it != m_textureToBindlessSlot.end()) ? it->second : 0;
     }
 
     VulkanImage* AssetManager::getHDRSource(TextureHandle handle) 
     {
-        return m_hdrSources.count(handle) ? m_hdrSources[handle].get() : nullptr;
+        std::shared_lock lock(m_assetMutex);
+        auto it = m_hdrSources.find(handle);
+        return (it != m_hdrSources.end()) ? it->second.get() : nullptr;
     }
 
     uint32_t AssetManager::getHDRSourceBindlessIndex(TextureHandle handle) 
     {
-        return m_hdrSourceBindlessSlots.count(handle) ? m_hdrSourceBindlessSlots[handle] : 0;
+        std::shared_lock lock(m_assetMutex);
+        auto it = m_hdrSourceBindlessSlots.find(handle);
+        return (it != m_hdrSourceBindlessSlots.end()) ? it->second : 0;
     }
 
     float AssetManager::getMeshBoundingRadius(AssetHandle handle) 
     {
-        return m_meshRadii.count(handle) ? m_meshRadii[handle] : 1.0f;
+        std::shared_lock lock(m_assetMutex);
+        auto it = m_meshRadii.find(handle);
+        return (it != m_meshRadii.end()) ? it->second : 1.0f;
     }
 
     VulkanImage* AssetManager::getTexture(TextureHandle handle)
     {
+        std::shared_lock lock(m_assetMutex);
         auto it = m_textures.find(handle);
         if (it != m_textures.end())
         {
@@ -367,6 +400,7 @@ namespace ix
     {
         if (handle == 0) return nullptr;
 
+        std::shared_lock lock(m_assetMutex);
         auto it = m_meshes.find(handle);
         if (it == m_meshes.end()) {
             spdlog::warn("AssetManager: Requested invalid handle {}", handle);
@@ -402,6 +436,9 @@ namespace ix
         uint32_t bytesPerPixel = (format == VK_FORMAT_R32G32B32_SFLOAT || format == VK_FORMAT_R32G32B32A32_SFLOAT) ? 16 : 4;
         image->uploadData(data, width * height * bytesPerPixel);
 
+        auto info = image->getDescriptorInfo(m_defaultSampler);
+
+        std::unique_lock assetLock(m_assetMutex);
         TextureHandle handle = m_nextTextureHandle++;
         uint32_t slot = m_nextTextureSlot++;
 
@@ -409,7 +446,6 @@ namespace ix
         m_textureToBindlessSlot[handle] = slot;
         m_pathMap[name] = handle;
 
-        auto info = m_textures[handle]->getDescriptorInfo(m_defaultSampler);
         {
             std::lock_guard<std::mutex> lock(m_queueMutex);
             m_updateQueue.push({ slot, info });
@@ -421,6 +457,7 @@ namespace ix
     void AssetManager::clearAssetCache()
     {
         spdlog::info("AssetManager: Clearing asset cache...");
+        std::unique_lock assetLock(m_assetMutex);
 
         // Destroy global VBO/IBO
         m_globalVBO.reset();
@@ -6,6 +6,7 @@
 #include <memory>
 #include <queue>
 #include <mutex>
+#include <shared_mutex>
 #include <nlohmann/json.hpp>
 #include <functional>
 
@@ -18,6 +19,14 @@ namespace ix
     class VulkanContext;
     class VulkanImage;
 
+    // CPU side of a glTF load, the first primitive of the first mesh
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        float boundingRadius = 0.0f;
+    };
+
     class AssetManager 
     {
     public:
@@ -40,6 +49,9 @@ namespace ix
         uint32_t getHDRSourceBindlessIndex(TextureHandle handle);
         float getMeshBoundingRadius(AssetHandle handle);
 
+        // Parses the file and decodes its accessors, no device needed
+        static bool decodeGLTF(const std::string& path, MeshData& out);
+
         VulkanBuffer* getGlobalVBO() { return m_globalVBO.get(); }
         VulkanBuffer* getGlobalIBO() { return m_globalIBO.get(); }
 
@@ -58,6 +70,10 @@ namespace ix
         std::string m_modelRoot = "";
         std::string m_texRoot = "";
 
+        // Loads happen on the game thread while the render thread resolves handles. Writers take
+        // the lock only to publish new entries, the slow file and GPU work runs outside of it
+        mutable std::shared_mutex m_assetMutex;
+
         std::unordered_map<std::string, AssetHandle> m_pathMap;
         std::unordered_map<AssetHandle, std::unique_ptr<VulkanMesh>> m_meshes;
 
@@ -18,7 +18,7 @@ namespace ix
         MeshComponent(AssetHandle handle, TextureHandle tex) : meshHandle(handle), textureHandle(tex) {}
     };
 
-    // Transform data for the entity
+    // Local TRS of the entity (hot data read by gameplay and the transform system)
     struct TransformComponent 
     {
         glm::vec3 position{ 0.0f, 0.0f, 0.0f };
@@ -27,27 +27,35 @@ namespace ix
 
         TransformComponent() = default;
 
-        bool dirty = true;
-        glm::mat4 worldMatrix{ 1.0f };
-
-        void setPosition(const glm::vec3& p) { position = p; dirty = true; }
-        void setRotation(const glm::quat& r) { rotation = r; dirty = true; }
-        void setScale(const glm::vec3& s) { scale = s;    dirty = true; }
-
-        glm::mat4 getTransform()
-        {
-            if (dirty) {
-                worldMatrix = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
-                dirty = false;
-            }
-            return worldMatrix;
-        }
+        // No setters here on purpose: use Entity::setPosition/setRotation/setScale (or registry.patch)
+        // so the change is tagged and picked up by the TransformSystem
 
         glm::vec3 getForward() const { return rotation * glm::vec3(0, 0, -1); }
         glm::vec3 getRight()   const { return rotation * glm::vec3(1, 0, 0); }
         glm::vec3 getUp()      const { return rotation * glm::vec3(0, 1, 0); }
     };
 
+    // World matrix composed by the TransformSystem, stored as a row-major affine 3x4
+    // (xyz = rotation * scale, w = translation). Layout matches GPUInstanceData::modelRows
+    struct WorldTransformComponent
+    {
+        glm::vec4 rows[3]{
+            { 1.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f, 0.0f }
+        };
+
+        glm::vec3 getTranslation() const { return { rows[0].w, rows[1].w, rows[2].w }; }
+
+        glm::mat4 toMat4() const
+        {
+            return glm::transpose(glm::mat4(rows[0], rows[1], rows[2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+        }
+    };
+
+    // Empty tag: the local TRS changed since the last TransformSystem::update
+    struct TransformDirtyTag {};
+
     // Tag component for the Scene hierarchy
     struct TagComponent {
         std::string tag;
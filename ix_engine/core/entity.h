@@ -1,6 +1,8 @@
 // entity.h
 #pragma once
 #include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace ix 
 {
@@ -18,6 +20,15 @@ namespace ix
         template<typename T>
         T& getComponent();
 
+        // Modifies a component in place and notifies on_update listeners
+        template<typename T, typename... Func>
+        T& patchComponent(Func&&... func);
+
+        // Transform helpers, tracked by the TransformSystem
+        void setPosition(const glm::vec3& position);
+        void setRotation(const glm::quat& rotation);
+        void setScale(const glm::vec3& scale);
+
         operator entt::entity() const { return m_entityHandle; }
         bool isValid() const { return m_entityHandle != entt::null && m_scene != nullptr; }
 
@@ -1,6 +1,7 @@
 // entity_methods.inl
 #pragma once
 #include "scene.h"
+#include "components.h"
 
 namespace ix 
 {
@@ -15,4 +16,21 @@ namespace ix
         return m_scene->m_registry.get<T>(m_entityHandle);
     }
 
+    template<typename T, typename... Func>
+    T& Entity::patchComponent(Func&&... func) {
+        return m_scene->m_registry.patch<T>(m_entityHandle, std::forward<Func>(func)...);
+    }
+
+    inline void Entity::setPosition(const glm::vec3& position) {
+        patchComponent<TransformComponent>([&](TransformComponent& t) { t.position = position; });
+    }
+
+    inline void Entity::setRotation(const glm::quat& rotation) {
+        patchComponent<TransformComponent>([&](TransformComponent& t) { t.rotation = rotation; });
+    }
+
+    inline void Entity::setScale(const glm::vec3& scale) {
+        patchComponent<TransformComponent>([&](TransformComponent& t) { t.scale = scale; });
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,330 @@
+// frame_recorder.cpp
+#include "common/engine_pch.h"
+#include "frame_recorder.h"
+#include "scene.h"
+
+#include <cstring>
+
+namespace ix
+{
+    namespace
+    {
+        template<typename T>
+        void write(std::ofstream& file, const T& value)
+        {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        bool read(std::ifstream& file, T& value)
+        {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        void writeView(std::ofstream& file, const SceneView& view)
+        {
+            write(file, view.deltaTime);
+            write(file, view.totalTime);
+            write(file, view.viewMatrix);
+            write(file, view.projectionMatrix);
+            write(file, view.clusterProjection);
+            write(file, view.cameraPosition);
+            write(file, view.skybox);
+            write(file, view.skyboxIntensity);
+        }
+
+        bool readView(std::ifstream& file, SceneView& view)
+        {
+            return read(file, view.deltaTime) && read(file, view.totalTime) && read(file, view.viewMatrix) &&
+                read(file, view.projectionMatrix) && read(file, view.clusterProjection) && read(file, view.cameraPosition) &&
+                read(file, view.skybox) && read(file, view.skyboxIntensity);
+        }
+
+        void writeEvent(std::ofstream& file, const InputEvent& event)
+        {
+            write(file, static_cast<uint8_t>(event.type));
+            switch (event.type)
+            {
+            case InputEvent::Type::Key:
+            case InputEvent::Type::MouseButton:
+                write(file, static_cast<int16_t>(event.code));
+                write(file, static_cast<int32_t>(event.scancode));
+                write(file, static_cast<int16_t>(event.mods));
+                write(file, static_cast<uint8_t>(event.action));
+                break;
+            case InputEvent::Type::MouseMove:
+                write(file, event.dx);
+                write(file, event.dy);
+                break;
+            case InputEvent::Type::CursorLock:
+                write(file, static_cast<uint8_t>(event.locked));
+                break;
+            }
+        }
+
+        bool readEvent(std::ifstream& file, InputEvent& event)
+        {
+            uint8_t type = 0;
+            if (!read(file, type)) return false;
+            event = InputEvent{};
+            event.type = static_cast<InputEvent::Type>(type);
+
+            switch (event.type)
+            {
+            case InputEvent::Type::Key:
+            case InputEvent::Type::MouseButton:
+            {
+                int16_t code = 0, mods = 0;
+                int32_t scancode = 0;
+                uint8_t action = 0;
+                if (!read(file, code) || !read(file, scancode) || !read(file, mods) || !read(file, action)) return false;
+                event.code = code;
+                event.scancode = scancode;
+                event.mods = mods;
+                event.action = static_cast<KeyAction>(action);
+                return true;
+            }
+            case InputEvent::Type::MouseMove:
+                return read(file, event.dx) && read(file, event.dy);
+            case InputEvent::Type::CursorLock:
+            {
+                uint8_t locked = 0;
+                if (!read(file, locked)) return false;
+                event.locked = locked != 0;
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+
+        bool sameTransform(const TransformComponent& a, const TransformComponent& b)
+        {
+            return a.position == b.position && a.rotation == b.rotation && a.scale == b.scale;
+        }
+
+        // The frame count sits right after magic, version and viewport
+        constexpr std::streamoff FRAME_COUNT_OFFSET = sizeof(FrameCaptureHeader::MAGIC) + 3 * sizeof(uint32_t);
+    }
+
+    FrameRecorder::FrameRecorder(const std::string& path, uint32_t width, uint32_t height)
+        : m_path(path)
+        , m_file(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!m_file.is_open())
+        {
+            throw std::runtime_error("FrameRecorder: Failed to open " + path);
+        }
+
+        m_header.width = width;
+        m_header.height = height;
+        m_file.write(FrameCaptureHeader::MAGIC, sizeof(FrameCaptureHeader::MAGIC));
+        write(m_file, FrameCaptureHeader::VERSION);
+        write(m_file, m_header.width);
+        write(m_file, m_header.height);
+        write(m_file, m_header.frameCount);
+
+        spdlog::info("FrameRecorder: Recording to {}", path);
+    }
+
+    FrameRecorder::~FrameRecorder()
+    {
+        writeFrameCount();
+        m_file.close();
+
+        spdlog::info("FrameRecorder: {} frames written to {}", m_header.frameCount, m_path);
+    }
+
+    void FrameRecorder::recordEvent(const InputEvent& event)
+    {
+        m_frame.events.push_back(event);
+    }
+
+    void FrameRecorder::recordTransforms(Scene& scene)
+    {
+        const auto& registry = scene.getRegistry();
+        for (entt::entity entity : scene.getChangedTransforms())
+        {
+            m_frame.transforms.push_back({ entt::to_integral(entity), registry.get<TransformComponent>(entity) });
+        }
+    }
+
+    void FrameRecorder::endFrame(double frameTime, const SceneView& view)
+    {
+        write(m_file, frameTime);
+        writeView(m_file, view);
+
+        write(m_file, static_cast<uint32_t>(m_frame.events.size()));
+        for (const InputEvent& event : m_frame.events) writeEvent(m_file, event);
+
+        write(m_file, static_cast<uint32_t>(m_frame.transforms.size()));
+        for (const RecordedTransform& recorded : m_frame.transforms)
+        {
+            write(m_file, recorded.entity);
+            write(m_file, recorded.transform.position);
+            write(m_file, recorded.transform.rotation);
+            write(m_file, recorded.transform.scale);
+        }
+
+        m_frame.events.clear();
+        m_frame.transforms.clear();
+        m_header.frameCount++;
+
+        if (m_header.frameCount % COUNT_FLUSH_INTERVAL == 0) writeFrameCount();
+    }
+
+    void FrameRecorder::writeFrameCount()
+    {
+        const std::streampos end = m_file.tellp();
+        m_file.seekp(FRAME_COUNT_OFFSET);
+        write(m_file, m_header.frameCount);
+        m_file.seekp(end);
+        m_file.flush();
+    }
+
+    FrameReplayer::FrameReplayer(const std::string& path)
+        : m_file(path, std::ios::binary)
+    {
+        if (!m_file.is_open())
+        {
+            throw std::runtime_error("FrameReplayer: Failed to open " + path);
+        }
+
+        char magic[sizeof(FrameCaptureHeader::MAGIC)]{};
+        uint32_t version = 0;
+        m_file.read(magic, sizeof(magic));
+        if (!m_file || std::memcmp(magic, FrameCaptureHeader::MAGIC, sizeof(magic)) != 0 || !read(m_file, version) ||
+            version != FrameCaptureHeader::VERSION || !read(m_file, m_header.width) || !read(m_file, m_header.height) ||
+            !read(m_file, m_header.frameCount))
+        {
+            throw std::runtime_error("FrameReplayer: " + path + " is not a version " + std::to_string(FrameCaptureHeader::VERSION) + " capture");
+        }
+
+        spdlog::info("FrameReplayer: Replaying {} ({}x{}, header counts {} frames)", path, m_header.width, m_header.height, m_header.frameCount);
+    }
+
+    bool FrameReplayer::nextFrame()
+    {
+        // The header's count lags behind if the recorder didn't shut down cleanly, the file doesn't
+        if (m_file.peek() == std::ifstream::traits_type::eof())
+        {
+            if (m_framesRead != m_header.frameCount)
+            {
+                spdlog::info("FrameReplayer: Capture holds {} frames, its header counted {}", m_framesRead, m_header.frameCount);
+            }
+            return false;
+        }
+
+        RecordedFrame& frame = m_frame;
+        frame.events.clear();
+        frame.transforms.clear();
+
+        uint32_t eventCount = 0, transformCount = 0;
+        bool valid = read(m_file, frame.frameTime) && readView(m_file, frame.view) && read(m_file, eventCount);
+        for (uint32_t i = 0; valid && i < eventCount; i++)
+        {
+            valid = readEvent(m_file, frame.events.emplace_back());
+        }
+
+        valid = valid && read(m_file, transformCount);
+        for (uint32_t i = 0; valid && i < transformCount; i++)
+        {
+            RecordedTransform& recorded = frame.transforms.emplace_back();
+            valid = read(m_file, recorded.entity) && read(m_file, recorded.transform.position) &&
+                read(m_file, recorded.transform.rotation) && read(m_file, recorded.transform.scale);
+        }
+
+        if (!valid)
+        {
+            spdlog::warn("FrameReplayer: Capture truncated at frame {}", m_framesRead);
+            return false;
+        }
+
+        m_framesRead++;
+        return true;
+    }
+
+    void FrameReplayer::pushEvents(InputEventQueue& queue) const
+    {
+        for (const InputEvent& event : m_frame.events)
+        {
+            if (!queue.push(event))
+            {
+                spdlog::warn("FrameReplayer: Input queue full, frame {} lost events", m_framesRead);
+                return;
+            }
+        }
+    }
+
+    void FrameReplayer::beginFrame(Scene& scene)
+    {
+        if (scene.getId() == m_baselineSceneId) return;
+
+        m_baseline.clear();
+        for (auto [entity, transform] : scene.getRegistry().view<TransformComponent>().each())
+        {
+            m_baseline.emplace(entt::to_integral(entity), transform);
+        }
+        m_baselineSceneId = scene.getId();
+    }
+
+    void FrameReplayer::applyTransforms(Scene& scene)
+    {
+        auto& registry = scene.getRegistry();
+        m_recorded.clear();
+        for (const RecordedTransform& recorded : m_frame.transforms) m_recorded.insert(recorded.entity);
+
+        // The recording lists every transform that changed, anything else the game moved this frame goes
+        // back to where the last frame left it. Skipped when the scene was switched during the simulation
+        const bool sameScene = scene.getId() == m_baselineSceneId;
+        if (sameScene)
+        {
+            for (auto [entity, transform] : registry.view<TransformDirtyTag, TransformComponent>().each())
+            {
+                const uint32_t id = entt::to_integral(entity);
+                if (m_recorded.contains(id)) continue;
+
+                auto it = m_baseline.find(id);
+                if (it == m_baseline.end() || sameTransform(transform, it->second)) continue;
+
+                // Still tagged dirty, so the revert is composed like any other change
+                transform = it->second;
+                if (!m_warnedReverted)
+                {
+                    spdlog::warn("FrameReplayer: Entity {} moved without being in the capture, reverting such changes", id);
+                    m_warnedReverted = true;
+                }
+            }
+        }
+
+        // A deterministic game already produced the same transforms, only divergences get patched
+        for (const RecordedTransform& recorded : m_frame.transforms)
+        {
+            const auto entity = static_cast<entt::entity>(recorded.entity);
+            if (!registry.valid(entity) || !registry.all_of<TransformComponent>(entity))
+            {
+                if (!m_warnedMissingEntity)
+                {
+                    spdlog::warn("FrameReplayer: Entity {} from the capture doesn't exist, the scene differs from the recording", recorded.entity);
+                    m_warnedMissingEntity = true;
+                }
+                continue;
+            }
+
+            if (sameTransform(registry.get<TransformComponent>(entity), recorded.transform)) continue;
+            registry.patch<TransformComponent>(entity, [&](TransformComponent& t) { t = recorded.transform; });
+        }
+
+        // What this frame ends with is the next frame's baseline
+        if (!sameScene)
+        {
+            m_baselineSceneId = 0;
+            beginFrame(scene);
+            return;
+        }
+        for (auto [entity, transform] : registry.view<TransformDirtyTag, TransformComponent>().each())
+        {
+            m_baseline.insert_or_assign(entt::to_integral(entity), transform);
+        }
+    }
+}
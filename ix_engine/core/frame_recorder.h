@@ -0,0 +1,114 @@
+// frame_recorder.h
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "components.h"
+#include "input_state.h"
+#include "global_common/ix_global_pods.h"
+
+namespace ix
+{
+    class Scene;
+
+    struct RecordedTransform
+    {
+        uint32_t entity = 0;
+        TransformComponent transform;
+    };
+
+    // Everything the game thread consumed in one frame
+    struct RecordedFrame
+    {
+        double frameTime = 0.0;                   // What the simulation advanced by, already clamped
+        SceneView view{};
+        std::vector<InputEvent> events;           // In the order InputState applied them
+        std::vector<RecordedTransform> transforms; // Local transforms recomposed this frame
+    };
+
+    // Binary capture file, little endian:
+    //   header: "IXRP", version, viewport width, height, frame count
+    //   frame:  frame time, SceneView, event count + events, transform count + (entity, position, rotation, scale)
+    // Events only store the fields their type uses, a moving entity costs 44 bytes per frame.
+    // The frame count is only a hint (0 if the recorder never got to write it), frames run to the end of the file
+    struct FrameCaptureHeader
+    {
+        static constexpr char MAGIC[4] = { 'I', 'X', 'R', 'P' };
+        static constexpr uint32_t VERSION = 1;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t frameCount = 0;
+    };
+
+    // Writes a capture from the game thread. The frame count in the header is patched in every
+    // COUNT_FLUSH_INTERVAL frames and on destruction, so a crash loses at most that many frames
+    // of the written count (the frames themselves stay readable)
+    class FrameRecorder
+    {
+    public:
+        FrameRecorder(const std::string& path, uint32_t width, uint32_t height);
+        ~FrameRecorder();
+
+        FrameRecorder(const FrameRecorder&) = delete;
+        FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+        // From InputState::processEvents, kept until the frame ends
+        void recordEvent(const InputEvent& event);
+        // Right after Scene::updateTransforms, while its changed list is valid
+        void recordTransforms(Scene& scene);
+        // Once the frame's SceneView is final, writes the frame out
+        void endFrame(double frameTime, const SceneView& view);
+
+        uint32_t getFrameCount() const { return m_header.frameCount; }
+
+        static constexpr uint32_t COUNT_FLUSH_INTERVAL = 60;
+
+    private:
+        void writeFrameCount();
+
+        std::string m_path;
+        std::ofstream m_file;
+        FrameCaptureHeader m_header;
+        RecordedFrame m_frame;
+    };
+
+    // Reads a capture back one frame at a time
+    class FrameReplayer
+    {
+    public:
+        explicit FrameReplayer(const std::string& path);
+
+        // False at the end of the file (or at a truncated frame)
+        bool nextFrame();
+        const RecordedFrame& getFrame() const { return m_frame; }
+
+        // Queues the frame's input as if the window had sent it
+        void pushEvents(InputEventQueue& queue) const;
+        // Before the simulation: takes the scene's local transforms as the baseline when the scene changed
+        void beginFrame(Scene& scene);
+        // Before Scene::updateTransforms: sets the recorded transforms and reverts the ones the game
+        // moved but the capture didn't, so every frame ends with the transforms of the recording
+        void applyTransforms(Scene& scene);
+
+        const FrameCaptureHeader& getHeader() const { return m_header; }
+        uint32_t getFramesRead() const { return m_framesRead; }
+
+    private:
+        std::ifstream m_file;
+        FrameCaptureHeader m_header;
+        RecordedFrame m_frame;
+        uint32_t m_framesRead = 0;
+        bool m_warnedMissingEntity = false;
+        bool m_warnedReverted = false;
+
+        // Local transforms as of the end of the last replayed frame, by entity
+        std::unordered_map<uint32_t, TransformComponent> m_baseline;
+        std::unordered_set<uint32_t> m_recorded;
+        uint64_t m_baselineSceneId = 0;
+    };
+}
@@ -0,0 +1,208 @@
+// frame_stats.cpp
+#include "common/engine_pch.h"
+#include "frame_stats.h"
+#include "profiler.h"
+
+#include <cmath>
+
+namespace ix
+{
+    FrameStats::FrameStats(const FrameStatsSpecification& spec)
+        : m_spec(spec)
+    {
+        m_spec.windowSize = std::max(1u, m_spec.windowSize);
+        for (auto& series : m_series)
+        {
+            series.ring.resize(m_spec.windowSize);
+            series.bins.resize(BIN_COUNT);
+        }
+
+#if defined(IX_ENABLE_PROFILER)
+        // Zones have to be recorded every frame to be there when a hitch happens
+        if (m_spec.snapshotHitches) Profiler::get().setKeepLastFrame(true);
+#endif
+    }
+
+    FrameStats::~FrameStats()
+    {
+        flush();
+    }
+
+    void FrameStats::flush()
+    {
+        if (m_jobSystem) m_jobSystem->wait(m_snapshotJobs);
+    }
+
+    const char* FrameStats::getMetricName(FrameMetric metric)
+    {
+        switch (metric)
+        {
+        case FrameMetric::CpuFrame: return "CPU Frame";
+        case FrameMetric::GpuFrame: return "GPU Frame";
+        case FrameMetric::AcquireWait: return "Acquire Wait";
+        case FrameMetric::FenceWait: return "Fence Wait";
+        default: return "Unknown";
+        }
+    }
+
+    uint32_t FrameStats::binOf(float ms)
+    {
+        if (!(ms > 0.0f)) return 0;
+        return static_cast<uint32_t>(std::min(ms / BIN_MS, static_cast<float>(BIN_COUNT - 1)));
+    }
+
+    void FrameStats::record(FrameMetric metric, float ms)
+    {
+        std::lock_guard lock(m_mutex);
+        const uint32_t index = static_cast<uint32_t>(metric);
+        m_pending[index] = ms;
+        m_hasPending[index] = true;
+    }
+
+    void FrameStats::endFrame()
+    {
+        const uint32_t cpu = static_cast<uint32_t>(FrameMetric::CpuFrame);
+        float cpuMs = 0.0f;
+        float thresholdMs = 0.0f;
+        uint64_t frame = 0;
+        bool hitch = false;
+        {
+            std::lock_guard lock(m_mutex);
+            hitch = m_hasPending[cpu] && m_pending[cpu] > m_spec.hitchThresholdMs;
+            cpuMs = m_pending[cpu];
+            thresholdMs = m_spec.hitchThresholdMs;
+            frame = m_frameCount++;
+
+            for (uint32_t i = 0; i < METRIC_COUNT; i++)
+            {
+                if (!m_hasPending[i]) continue;
+                push(m_series[i], m_pending[i]);
+                m_hasPending[i] = false;
+            }
+            if (hitch) m_hitchCount++;
+        }
+
+        if (hitch) onHitch(frame, cpuMs, thresholdMs);
+    }
+
+    void FrameStats::push(Series& series, float ms)
+    {
+        // The oldest sample leaves the histogram once the window is full
+        if (series.count == series.ring.size())
+        {
+            const float oldest = series.ring[series.next];
+            series.bins[binOf(oldest)]--;
+            series.sum -= oldest;
+        }
+        else
+        {
+            series.count++;
+        }
+
+        series.ring[series.next] = ms;
+        series.next = (series.next + 1) % static_cast<uint32_t>(series.ring.size());
+        series.bins[binOf(ms)]++;
+        series.sum += ms;
+    }
+
+    void FrameStats::onHitch(uint64_t frame, float ms, float thresholdMs)
+    {
+        spdlog::warn("FrameStats: Hitch in frame {}, {:.2f} ms (threshold {:.2f} ms)", frame, ms, thresholdMs);
+
+#if defined(IX_ENABLE_PROFILER)
+        if (!m_spec.snapshotHitches || !m_jobSystem || m_snapshotCount >= m_spec.maxHitchSnapshots) return;
+
+        // Only the copy happens here, the render thread never waits on the disk
+        auto trace = std::make_shared<ProfileTrace>();
+        if (!Profiler::get().copyLastFrame(*trace)) return;
+        m_snapshotCount++;
+
+        std::string directory = m_spec.snapshotDirectory;
+        m_jobSystem->schedule([trace, directory, frame]() {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            trace->write(directory + "/hitch_" + std::to_string(frame) + ".json");
+            }, &m_snapshotJobs);
+#endif
+    }
+
+    FrameMetricSummary FrameStats::getSummary(FrameMetric metric) const
+    {
+        std::lock_guard lock(m_mutex);
+        const Series& series = m_series[static_cast<uint32_t>(metric)];
+
+        FrameMetricSummary summary;
+        summary.samples = series.count;
+        if (series.count == 0) return summary;
+
+        for (uint32_t i = 0; i < series.count; i++) summary.max = std::max(summary.max, series.ring[i]);
+        summary.average = static_cast<float>(series.sum / series.count);
+
+        // Bin centers, clamped so the overflow bin reports the real maximum
+        auto percentile = [&](float fraction) {
+            const uint32_t rank = std::max(1u, static_cast<uint32_t>(std::ceil(fraction * series.count)));
+            uint32_t seen = 0;
+            for (uint32_t bin = 0; bin < BIN_COUNT; bin++)
+            {
+                seen += series.bins[bin];
+                if (seen >= rank) return std::min(summary.max, (bin + 0.5f) * BIN_MS);
+            }
+            return summary.max;
+            };
+
+        summary.p50 = percentile(0.50f);
+        summary.p95 = percentile(0.95f);
+        summary.p99 = percentile(0.99f);
+        return summary;
+    }
+
+    std::vector<float> FrameStats::getHistory(FrameMetric metric) const
+    {
+        std::lock_guard lock(m_mutex);
+        const Series& series = m_series[static_cast<uint32_t>(metric)];
+
+        std::vector<float> history;
+        history.reserve(series.count);
+        const uint32_t size = static_cast<uint32_t>(series.ring.size());
+        const uint32_t first = series.count == size ? series.next : 0;
+        for (uint32_t i = 0; i < series.count; i++) history.push_back(series.ring[(first + i) % size]);
+        return history;
+    }
+
+    uint64_t FrameStats::getFrameCount() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_frameCount;
+    }
+
+    uint32_t FrameStats::getHitchCount() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_hitchCount;
+    }
+
+    float FrameStats::getHitchThreshold() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_spec.hitchThresholdMs;
+    }
+
+    void FrameStats::setHitchThreshold(float ms)
+    {
+        std::lock_guard lock(m_mutex);
+        m_spec.hitchThresholdMs = ms;
+    }
+
+    void FrameStats::reset()
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto& series : m_series)
+        {
+            std::fill(series.bins.begin(), series.bins.end(), 0u);
+            series.next = 0;
+            series.count = 0;
+            series.sum = 0.0;
+        }
+        m_hitchCount = 0;
+    }
+}
@@ -0,0 +1,106 @@
+// frame_stats.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "job_system.h"
+
+namespace ix
+{
+    enum class FrameMetric : uint32_t
+    {
+        CpuFrame,    // Render loop iteration
+        GpuFrame,    // Graphics queue time of the passes, a few frames behind
+        AcquireWait, // vkAcquireNextImageKHR
+        FenceWait,   // Waiting for the frame slot's previous submission
+        Count
+    };
+
+    struct FrameMetricSummary
+    {
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+        float average = 0.0f;
+        uint32_t samples = 0;
+    };
+
+    struct FrameStatsSpecification
+    {
+        uint32_t windowSize = 1024;        // Frames the percentiles cover
+        float hitchThresholdMs = 33.3f;    // CPU frames above this count as hitches
+        bool snapshotHitches = false;      // Write the hitch frame's profiler zones (profiler builds only). Keeps the profiler recording every frame
+        uint32_t maxHitchSnapshots = 16;   // Per session, so a bad stretch doesn't flood the disk
+        std::string snapshotDirectory = "hitches";
+    };
+
+    // Rolling frame time histograms, one per metric. Each metric keeps the last windowSize samples in a
+    // ring and a histogram of 0.1 ms bins over the same samples, so percentiles never sort.
+    // Written by the render thread, queryable from any thread
+    class FrameStats
+    {
+    public:
+        static constexpr float BIN_MS = 0.1f;
+        static constexpr uint32_t BIN_COUNT = 1000; // The last bin also holds everything above 100 ms
+
+        explicit FrameStats(const FrameStatsSpecification& spec = {});
+        ~FrameStats(); // Waits for snapshots still being written
+
+        FrameStats(const FrameStats&) = delete;
+        FrameStats& operator=(const FrameStats&) = delete;
+
+        // Hitch snapshots are written there, off the render thread. Without one they are skipped
+        void setJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+        // Waits for the snapshots still being written, before the job system goes away
+        void flush();
+
+        // Samples for the frame in progress, metrics without one this frame are left out
+        void record(FrameMetric metric, float ms);
+        // Commits the frame's samples and checks it for a hitch
+        void endFrame();
+
+        FrameMetricSummary getSummary(FrameMetric metric) const;
+        // Oldest first, for plotting
+        std::vector<float> getHistory(FrameMetric metric) const;
+
+        uint64_t getFrameCount() const;
+        uint32_t getHitchCount() const;
+        float getHitchThreshold() const;
+        void setHitchThreshold(float ms);
+        void reset();
+
+        static const char* getMetricName(FrameMetric metric);
+
+    private:
+        static constexpr uint32_t METRIC_COUNT = static_cast<uint32_t>(FrameMetric::Count);
+
+        struct Series
+        {
+            std::vector<float> ring;
+            uint32_t next = 0;
+            uint32_t count = 0;
+            double sum = 0.0;
+            std::vector<uint32_t> bins;
+        };
+
+        static uint32_t binOf(float ms);
+        void push(Series& series, float ms);
+        void onHitch(uint64_t frame, float ms, float thresholdMs); // Outside the lock, may schedule a snapshot
+
+        FrameStatsSpecification m_spec;
+        mutable std::mutex m_mutex;
+        std::array<Series, METRIC_COUNT> m_series;
+        std::array<float, METRIC_COUNT> m_pending{};
+        std::array<bool, METRIC_COUNT> m_hasPending{};
+
+        uint64_t m_frameCount = 0;
+        uint32_t m_hitchCount = 0;
+        uint32_t m_snapshotCount = 0; // Render thread only
+        JobSystem* m_jobSystem = nullptr;
+        JobCounter m_snapshotJobs;
+    };
+}
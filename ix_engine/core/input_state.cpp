@@ -0,0 +1,89 @@
+// input_state.cpp
+#include "common/engine_pch.h"
+#include "input_state.h"
+
+namespace ix
+{
+    bool InputEventQueue::push(const InputEvent& event)
+    {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint32_t next = (tail + 1) % CAPACITY;
+        if (next == m_head.load(std::memory_order_acquire)) return false;
+
+        m_events[tail] = event;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool InputEventQueue::pop(InputEvent& event)
+    {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        event = m_events[head];
+        m_head.store((head + 1) % CAPACITY, std::memory_order_release);
+        return true;
+    }
+
+    void InputState::processEvents()
+    {
+        InputEvent event;
+        while (m_queue.pop(event))
+        {
+            if (m_eventObserver) m_eventObserver(event);
+
+            switch (event.type)
+            {
+            case InputEvent::Type::Key:
+                if (event.code < 0 || event.code >= static_cast<int>(m_keyStates.size())) break;
+                if (event.action == KeyAction::PRESS) m_keyStates.set(event.code);
+                else if (event.action == KeyAction::RELEASE) m_keyStates.reset(event.code);
+
+                if (m_keyCallback) m_keyCallback(static_cast<IxKey>(event.code), event.scancode, event.action, event.mods);
+                break;
+
+            case InputEvent::Type::MouseButton:
+                if (event.code < 0 || event.code >= static_cast<int>(m_mouseButtons.size())) break;
+                if (event.action == KeyAction::PRESS) m_mouseButtons.set(event.code);
+                else if (event.action == KeyAction::RELEASE) m_mouseButtons.reset(event.code);
+                break;
+
+            case InputEvent::Type::MouseMove:
+                m_accumDX += event.dx;
+                m_accumDY += event.dy;
+                break;
+
+            case InputEvent::Type::CursorLock:
+                m_cursorLocked = event.locked;
+                break;
+            }
+        }
+    }
+
+    bool InputState::isKeyPressed(IxKey key) const
+    {
+        int code = static_cast<int>(key);
+        if (code < 0 || code >= static_cast<int>(m_keyStates.size())) return false;
+        return m_keyStates.test(code);
+    }
+
+    bool InputState::isMouseButtonPressed(int button) const
+    {
+        if (button < 0 || button >= static_cast<int>(m_mouseButtons.size())) return false;
+        return m_mouseButtons.test(button);
+    }
+
+    void InputState::lockCursor(bool lock)
+    {
+        // The window confirms with a CursorLock event
+        if (m_cursorLockHandler) m_cursorLockHandler(lock);
+    }
+
+    void InputState::consumeMouseDelta(double& dx, double& dy)
+    {
+        dx = m_accumDX;
+        dy = m_accumDY;
+        m_accumDX = 0.0;
+        m_accumDY = 0.0;
+    }
+}
@@ -0,0 +1,79 @@
+// input_state.h
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+
+#include "input_i.h"
+
+namespace ix
+{
+    struct InputEvent
+    {
+        enum class Type : uint8_t { Key, MouseButton, MouseMove, CursorLock };
+
+        Type type = Type::Key;
+        int code = 0;                 // IxKey or mouse button
+        int scancode = 0;
+        int mods = 0;
+        KeyAction action = KeyAction::PRESS;
+        double dx = 0.0, dy = 0.0;    // MouseMove
+        bool locked = false;          // CursorLock
+    };
+
+    // Lock-free single producer / single consumer ring. The platform pushes from its callbacks,
+    // the thread that simulates the game pops.
+    class InputEventQueue
+    {
+    public:
+        static constexpr uint32_t CAPACITY = 1024;
+
+        // Fails (drops the event) when full
+        bool push(const InputEvent& event);
+        bool pop(InputEvent& event);
+
+    private:
+        InputEvent m_events[CAPACITY];
+        alignas(64) std::atomic<uint32_t> m_head{ 0 }; // Next slot to read
+        alignas(64) std::atomic<uint32_t> m_tail{ 0 }; // Next slot to write
+    };
+
+    // Input_I seen by game code. Rebuilt from the event queue once per simulation step, so it is
+    // consistent for the whole step no matter which thread polls the window.
+    class InputState : public Input_I
+    {
+    public:
+        explicit InputState(InputEventQueue& queue) : m_queue(queue) {}
+
+        // Applies every queued event and dispatches key callbacks. Consumer thread only
+        void processEvents();
+
+        // Cursor locking has to go through the window on the main thread
+        void setCursorLockHandler(std::function<void(bool)> handler) { m_cursorLockHandler = std::move(handler); }
+        // Sees every event processEvents applies, in order (frame recording)
+        void setEventObserver(std::function<void(const InputEvent&)> observer) { m_eventObserver = std::move(observer); }
+
+        bool isKeyPressed(IxKey key) const override;
+        bool isMouseButtonPressed(int button) const override;
+
+        void lockCursor(bool lock) override;
+        bool isCursorLocked() const override { return m_cursorLocked; }
+        void consumeMouseDelta(double& dx, double& dy) override;
+
+        void setKeyCallback(IxKeyCallback callback) override { m_keyCallback = std::move(callback); }
+
+    private:
+        InputEventQueue& m_queue;
+
+        std::bitset<512> m_keyStates;
+        std::bitset<8> m_mouseButtons;
+        double m_accumDX = 0.0;
+        double m_accumDY = 0.0;
+        bool m_cursorLocked = false;
+
+        IxKeyCallback m_keyCallback;
+        std::function<void(bool)> m_cursorLockHandler;
+        std::function<void(const InputEvent&)> m_eventObserver;
+    };
+}
@@ -0,0 +1,402 @@
+// job_system.cpp
+#include "common/engine_pch.h"
+#include "job_system.h"
+#include "profiler.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ix
+{
+    struct Job
+    {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+    };
+
+    // Chase-Lev work-stealing deque with a fixed ring (C11 formulation by Le et al.)
+    class WorkStealingDeque
+    {
+    public:
+        static constexpr int64_t CAPACITY = 4096;
+
+        // Owner only. Fails when full
+        bool push(Job* job)
+        {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed);
+            const int64_t t = m_top.load(std::memory_order_acquire);
+            if (b - t >= CAPACITY) return false;
+
+            m_buffer[b & MASK].store(job, std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only, LIFO
+        Job* pop()
+        {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = m_top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = m_buffer[b & MASK].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // Last element, race against thieves
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // Any thread, FIFO
+        Job* steal()
+        {
+            int64_t t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = m_bottom.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+
+            Job* job = m_buffer[t & MASK].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+            return job;
+        }
+
+    private:
+        static constexpr int64_t MASK = CAPACITY - 1;
+
+        alignas(64) std::atomic<int64_t> m_top{ 0 };
+        alignas(64) std::atomic<int64_t> m_bottom{ 0 };
+        alignas(64) std::atomic<Job*> m_buffer[CAPACITY]{};
+    };
+
+    namespace
+    {
+        constexpr uint32_t INVALID_THREAD_INDEX = ~0u;
+        constexpr int SPIN_COUNT = 64;
+
+        thread_local uint32_t t_threadIndex = INVALID_THREAD_INDEX;
+        thread_local const JobSystem* t_owner = nullptr;
+
+        void pinCurrentThread(uint32_t core)
+        {
+#if defined(_WIN32)
+            if (core < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) == 0)
+            {
+                spdlog::warn("JobSystem: Failed to pin worker to core {}", core);
+            }
+#elif defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            {
+                spdlog::warn("JobSystem: Failed to pin worker to core {}", core);
+            }
+#else
+            (void)core;
+#endif
+        }
+    }
+
+    JobSystem::JobSystem(const JobSystemSpecification& spec)
+    {
+        uint32_t workerCount = spec.workerCount;
+        if (workerCount == JobSystemSpecification::AUTO_WORKER_COUNT)
+        {
+            const uint32_t hardware = std::thread::hardware_concurrency();
+            workerCount = hardware > 1 ? hardware - 1 : 0;
+        }
+
+        t_threadIndex = 0;
+        t_owner = this;
+
+        m_queues.reserve(workerCount + 1);
+        for (uint32_t i = 0; i <= workerCount; i++) m_queues.push_back(std::make_unique<WorkStealingDeque>());
+
+        m_workers.reserve(workerCount);
+        for (uint32_t i = 1; i <= workerCount; i++)
+        {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, i, spec.pinThreads);
+        }
+
+        spdlog::info("JobSystem: Started {} worker threads{}", workerCount, spec.pinThreads ? " (pinned)" : "");
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_running.store(false);
+        }
+        m_sleepCv.notify_all();
+
+        for (auto& worker : m_workers) worker.join();
+
+        // Drop whatever never ran, finishing its counter so nobody waits on it forever. Continuations
+        // released by that are queued again and dropped on the next pass
+        std::vector<Job*> dropped;
+        for (;;)
+        {
+            for (auto& queue : m_queues)
+            {
+                while (Job* job = queue->steal()) dropped.push_back(job);
+            }
+            dropped.insert(dropped.end(), m_injected.begin(), m_injected.end());
+            dropped.insert(dropped.end(), m_mainJobs.begin(), m_mainJobs.end());
+            m_injected.clear();
+            m_injectedCount.store(0);
+            m_mainJobs.clear();
+            if (dropped.empty()) break;
+
+            for (Job* job : dropped)
+            {
+                JobCounter* counter = job->counter;
+                delete job;
+                if (counter) finish(*counter);
+            }
+            dropped.clear();
+        }
+
+        if (t_owner == this)
+        {
+            t_threadIndex = INVALID_THREAD_INDEX;
+            t_owner = nullptr;
+        }
+    }
+
+    uint32_t JobSystem::getCurrentThreadIndex()
+    {
+        return t_threadIndex;
+    }
+
+    bool JobSystem::isMainThread() const
+    {
+        return t_owner == this && t_threadIndex == 0;
+    }
+
+    void JobSystem::schedule(JobFunction function, JobCounter* counter)
+    {
+        if (counter) counter->m_count.fetch_add(1);
+        submit(new Job{ std::move(function), counter });
+    }
+
+    void JobSystem::scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+    {
+        if (counter) counter->m_count.fetch_add(1);
+        Job* job = new Job{ std::move(function), counter };
+
+        {
+            std::lock_guard lock(dependency.m_mutex);
+            if (dependency.m_count.load() != 0)
+            {
+                dependency.m_continuations.push_back(job);
+                return;
+            }
+        }
+        submit(job);
+    }
+
+    void JobSystem::scheduleOnMainThread(JobFunction function, JobCounter* counter)
+    {
+        if (counter) counter->m_count.fetch_add(1);
+
+        std::lock_guard lock(m_mainMutex);
+        m_mainJobs.push_back(new Job{ std::move(function), counter });
+    }
+
+    void JobSystem::submit(Job* job)
+    {
+        const bool known = (t_owner == this && t_threadIndex != INVALID_THREAD_INDEX);
+        if (!known || !m_queues[t_threadIndex]->push(job))
+        {
+            std::lock_guard lock(m_injectMutex);
+            m_injected.push_back(job);
+            m_injectedCount.fetch_add(1);
+        }
+
+        m_queuedJobs.fetch_add(1);
+        if (m_sleepingWorkers.load() > 0)
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_sleepCv.notify_one();
+        }
+    }
+
+    Job* JobSystem::findJob(uint32_t index)
+    {
+        Job* job = nullptr;
+
+        if (index != INVALID_THREAD_INDEX) job = m_queues[index]->pop();
+
+        if (!job && m_injectedCount.load() > 0)
+        {
+            std::lock_guard lock(m_injectMutex);
+            if (!m_injected.empty())
+            {
+                job = m_injected.front();
+                m_injected.pop_front();
+                m_injectedCount.fetch_sub(1);
+            }
+        }
+
+        if (!job)
+        {
+            // Steal round-robin, starting after ourselves so victims are spread out
+            const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+            const uint32_t start = (index == INVALID_THREAD_INDEX) ? 0 : index + 1;
+            for (uint32_t i = 0; i < queueCount && !job; i++)
+            {
+                const uint32_t victim = (start + i) % queueCount;
+                if (victim == index) continue;
+                job = m_queues[victim]->steal();
+            }
+        }
+
+        if (job) m_queuedJobs.fetch_sub(1);
+        return job;
+    }
+
+    void JobSystem::execute(Job* job)
+    {
+        IX_PROFILE_SCOPE("Job");
+
+        job->function();
+        JobCounter* counter = job->counter;
+        delete job;
+
+        if (counter) finish(*counter);
+    }
+
+    void JobSystem::finish(JobCounter& counter)
+    {
+        counter.m_finishing.fetch_add(1);
+
+        if (counter.m_count.fetch_sub(1) == 1)
+        {
+            std::vector<Job*> continuations;
+            {
+                std::lock_guard lock(counter.m_mutex);
+                continuations.swap(counter.m_continuations);
+            }
+            for (Job* job : continuations) submit(job);
+        }
+
+        // Last access: waiters may destroy the counter after this
+        counter.m_finishing.fetch_sub(1);
+    }
+
+    bool JobSystem::runMainThreadJob()
+    {
+        Job* job = nullptr;
+        {
+            std::lock_guard lock(m_mainMutex);
+            if (m_mainJobs.empty()) return false;
+            job = m_mainJobs.front();
+            m_mainJobs.pop_front();
+        }
+        execute(job);
+        return true;
+    }
+
+    void JobSystem::pumpMainThread()
+    {
+        // Only drain what is queued now, jobs scheduled by these run next pump
+        size_t pending;
+        {
+            std::lock_guard lock(m_mainMutex);
+            pending = m_mainJobs.size();
+        }
+        while (pending-- > 0 && runMainThreadJob()) {}
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        const uint32_t index = (t_owner == this) ? t_threadIndex : INVALID_THREAD_INDEX;
+        const bool mainThread = isMainThread();
+
+        while (!counter.isDone())
+        {
+            if (mainThread && runMainThreadJob()) continue;
+
+            if (Job* job = findJob(index)) execute(job);
+            else std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body)
+    {
+        if (end <= begin) return;
+
+        const size_t count = end - begin;
+        grain = std::max<size_t>(grain, 1);
+
+        // A few chunks per thread gives stealing something to balance with
+        const size_t maxChunks = size_t(getThreadCount()) * 4;
+        const size_t chunkCount = std::min((count + grain - 1) / grain, maxChunks);
+        if (chunkCount <= 1 || m_workers.empty())
+        {
+            body(begin, end);
+            return;
+        }
+
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+        JobCounter counter;
+        for (size_t chunkBegin = begin + chunkSize; chunkBegin < end; chunkBegin += chunkSize)
+        {
+            const size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+            schedule([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); }, &counter);
+        }
+
+        // The caller takes the first chunk itself
+        body(begin, std::min(begin + chunkSize, end));
+        wait(counter);
+    }
+
+    void JobSystem::workerLoop(uint32_t index, bool pin)
+    {
+        t_threadIndex = index;
+        t_owner = this;
+        if (pin) pinCurrentThread(index);
+        IX_PROFILE_THREAD("Worker " + std::to_string(index));
+
+        while (m_running.load())
+        {
+            Job* job = nullptr;
+            for (int spin = 0; spin < SPIN_COUNT && !job; spin++)
+            {
+                job = findJob(index);
+                if (!job) std::this_thread::yield();
+            }
+
+            if (job)
+            {
+                execute(job);
+                continue;
+            }
+
+            std::unique_lock lock(m_sleepMutex);
+            m_sleepingWorkers.fetch_add(1);
+            m_sleepCv.wait(lock, [this]() { return !m_running.load() || m_queuedJobs.load() > 0; });
+            m_sleepingWorkers.fetch_sub(1);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+// job_system.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ix
+{
+    struct Job;
+    class WorkStealingDeque;
+
+    using JobFunction = std::function<void()>;
+
+    // Counts outstanding jobs. Jobs scheduled with scheduleAfter() run once it drops to zero
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool isDone() const { return m_count.load() == 0 && m_finishing.load() == 0; }
+        uint32_t getCount() const { return m_count.load(); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_count{ 0 };
+        std::atomic<uint32_t> m_finishing{ 0 }; // Completions still touching the counter
+        std::mutex m_mutex;
+        std::vector<Job*> m_continuations;
+    };
+
+    struct JobSystemSpecification
+    {
+        static constexpr uint32_t AUTO_WORKER_COUNT = ~0u;
+
+        uint32_t workerCount = AUTO_WORKER_COUNT; // Auto = hardware threads - 1, the main thread also runs jobs
+        bool pinThreads = false;   // Pin worker i to core i + 1
+    };
+
+    // Worker threads with one Chase-Lev deque each. Owners push/pop at the bottom, idle threads steal
+    // from the top. The thread that creates the system is the main thread and takes part while waiting.
+    class JobSystem
+    {
+    public:
+        explicit JobSystem(const JobSystemSpecification& spec = {});
+        // Jobs that never ran are dropped and their counters finished
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void schedule(JobFunction function, JobCounter* counter = nullptr);
+        // Runs `function` once `dependency` reaches zero. `counter` is incremented right away
+        void scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+        // Runs on the main thread during pumpMainThread() (or while the main thread waits)
+        void scheduleOnMainThread(JobFunction function, JobCounter* counter = nullptr);
+
+        // Executes other jobs until the counter reaches zero. Only valid while the system exists,
+        // a counter has to be waited on before the system that runs its jobs is destroyed
+        void wait(JobCounter& counter);
+
+        // Splits [begin, end) into chunks of at least `grain` elements and blocks until all are done
+        void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+        void pumpMainThread();
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+        uint32_t getThreadCount() const { return getWorkerCount() + 1; }
+        bool isMainThread() const;
+
+        // 0 = main thread, 1..N = workers, ~0u = threads the system does not know
+        static uint32_t getCurrentThreadIndex();
+
+    private:
+        void workerLoop(uint32_t index, bool pin);
+        void submit(Job* job);
+        Job* findJob(uint32_t index);
+        void execute(Job* job);
+        void finish(JobCounter& counter);
+        bool runMainThreadJob();
+
+        std::vector<std::unique_ptr<WorkStealingDeque>> m_queues; // [0] = main thread
+        std::vector<std::thread> m_workers;
+
+        // Jobs from unknown threads and deque overflow
+        std::mutex m_injectMutex;
+        std::deque<Job*> m_injected;
+        std::atomic<uint32_t> m_injectedCount{ 0 };
+
+        std::mutex m_mainMutex;
+        std::deque<Job*> m_mainJobs;
+
+        // Idle workers sleep here
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCv;
+        std::atomic<int32_t> m_queuedJobs{ 0 }; // Can dip below zero briefly when a thief beats the push
+        std::atomic<uint32_t> m_sleepingWorkers{ 0 };
+        std::atomic<bool> m_running{ true };
+    };
+}
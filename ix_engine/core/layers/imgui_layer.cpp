@@ -3,6 +3,10 @@
 #include "imgui_layer.h"
 #include "engine.h"
 #include "platform/rendering/vk/vk_renderer.h"
+#include "platform/rendering/vk/vk_gpu_profiler.h"
+#include "platform/rendering/vk/vk_context.h"
+#include "platform/rendering/vk/vk_memory_tracker.h"
+#include "core/profiler.h"
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -27,7 +31,7 @@ namespace ix
         m_renderer->setupImGui();
     }
 
-    void ImGuiLayer::onUpdate(float dt)
+    void ImGuiLayer::onImGuiRender()
     {
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -45,6 +49,21 @@ namespace ix
             ImGui::Text("FPS:         %.1f", currentFps);
             ImGui::Text("Frame Time:  %.3f ms", 1000.0f / currentFps);
 
+            ImGui::Spacing();
+            ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Culling");
+            ImGui::Separator();
+
+            const RenderStats stats = m_renderer->getStats();
+            const GPUCullingStats& culling = m_renderer->getCullingStats();
+            ImGui::Text("Visible:     %u instances", stats.visibleInstances);
+            ImGui::Text("Triangles:   %u", stats.triangleCount);
+            ImGui::Text("Lights:      %.1f avg / %u max per cluster", stats.averageLightsPerCluster, stats.maxLightsPerCluster);
+            if (culling.overflowedClusters > 0 || stats.lightIndexOverflow > 0)
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Overflow:    %u clusters, %u indices dropped",
+                    culling.overflowedClusters, stats.lightIndexOverflow);
+            }
+
             ImGui::Spacing();
             ImGui::TextColored(ImVec4(0.0f, 0.7f, 1.0f, 1.0f), "Settings");
             ImGui::Separator();
@@ -61,9 +80,181 @@ namespace ix
             else {
                 ImGui::TextWrapped("(Uncapped - Maximum Hardware Usage)");
             }
+
+#if defined(IX_ENABLE_PROFILER)
+            ImGui::Spacing();
+            ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f), "Profiler");
+            ImGui::Separator();
+
+            if (Profiler::get().isCapturing()) ImGui::TextUnformatted("Capturing trace...");
+            else if (ImGui::Button("Capture Trace (120 frames)")) Profiler::get().startCapture("ix_trace.json", 120);
+#endif
         }
         ImGui::End();
+
+        drawFramePacing();
+        drawGpuPasses();
+        drawMemory();
+
         ImGui::Render();
     }
 
-}
\ No newline at end of file
+    void ImGuiLayer::drawFramePacing()
+    {
+        FrameStats& frameStats = Engine::get().getFrameStats();
+
+        ImGui::SetNextWindowSize(ImVec2(420, 240), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowPos(ImVec2(20, 420), ImGuiCond_FirstUseEver);
+
+        if (ImGui::Begin("Frame Pacing"))
+        {
+            const std::vector<float> cpuHistory = frameStats.getHistory(FrameMetric::CpuFrame);
+            if (!cpuHistory.empty())
+            {
+                ImGui::PlotLines("##CpuFrame", cpuHistory.data(), static_cast<int>(cpuHistory.size()), 0, "CPU frame (ms)",
+                    0.0f, frameStats.getHitchThreshold() * 1.5f, ImVec2(-1.0f, 60.0f));
+            }
+
+            float threshold = frameStats.getHitchThreshold();
+            if (ImGui::SliderFloat("Hitch (ms)", &threshold, 4.0f, 100.0f, "%.1f")) frameStats.setHitchThreshold(threshold);
+            ImGui::Text("Hitches:     %u / %llu frames", frameStats.getHitchCount(), (unsigned long long)frameStats.getFrameCount());
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Reset")) frameStats.reset();
+
+            const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp;
+            if (ImGui::BeginTable("Metrics", 5, flags))
+            {
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p95");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableSetupColumn("max");
+                ImGui::TableHeadersRow();
+
+                for (uint32_t i = 0; i < static_cast<uint32_t>(FrameMetric::Count); i++)
+                {
+                    const FrameMetric metric = static_cast<FrameMetric>(i);
+                    const FrameMetricSummary summary = frameStats.getSummary(metric);
+                    if (summary.samples == 0) continue;
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(FrameStats::getMetricName(metric));
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", summary.p50);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", summary.p95);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", summary.p99);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", summary.max);
+                }
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
+    void ImGuiLayer::drawGpuPasses()
+    {
+        VulkanGpuProfiler* profiler = m_renderer->getGpuProfiler();
+        if (!profiler) return;
+
+        ImGui::SetNextWindowSize(ImVec2(520, 260), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowPos(ImVec2(20, 140), ImGuiCond_FirstUseEver);
+
+        if (ImGui::Begin("GPU Passes"))
+        {
+            const RenderStats stats = m_renderer->getStats();
+            ImGui::Text("GPU Time:    %.3f ms", stats.gpuTimeMs);
+            if (profiler->hasPipelineStatistics())
+            {
+                // Input assembly primitives, so every pass that draws the scene counts it again
+                uint64_t primitives = 0;
+                for (const auto& timing : profiler->getResults()) primitives += timing.primitives;
+                ImGui::Text("Primitives:  %llu", (unsigned long long)primitives);
+            }
+
+            ImGui::InputText("##CapturePath", m_capturePath, sizeof(m_capturePath));
+            ImGui::SameLine();
+            if (profiler->isCapturing())
+            {
+                if (ImGui::Button("Stop Capture")) profiler->stopCapture();
+            }
+            else if (ImGui::Button("Capture"))
+            {
+                profiler->startCapture(m_capturePath);
+            }
+
+            const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp;
+            if (ImGui::BeginTable("Passes", 6, flags))
+            {
+                ImGui::TableSetupColumn("Pass");
+                ImGui::TableSetupColumn("Queue");
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("Primitives");
+                ImGui::TableSetupColumn("VS / FS");
+                ImGui::TableSetupColumn("CS");
+                ImGui::TableHeadersRow();
+
+                for (const auto& timing : profiler->getResults())
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(timing.name.c_str());
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(timing.asyncCompute ? "Compute" : "Graphics");
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", timing.gpuMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)timing.primitives);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu / %llu", (unsigned long long)timing.vertexInvocations, (unsigned long long)timing.fragmentInvocations);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)timing.computeInvocations);
+                }
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
+    void ImGuiLayer::drawMemory()
+    {
+        VulkanMemoryTracker& tracker = static_cast<VulkanContext*>(m_renderer->getAPIContext())->getMemoryTracker();
+        constexpr float MB = 1024.0f * 1024.0f;
+
+        ImGui::SetNextWindowSize(ImVec2(420, 300), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowPos(ImVec2(20, 420), ImGuiCond_FirstUseEver);
+
+        if (ImGui::Begin("GPU Memory"))
+        {
+            for (const auto& heap : tracker.getHeapBudgets())
+            {
+                if (heap.budget == 0) continue;
+
+                const float fraction = static_cast<float>(heap.usage) / static_cast<float>(heap.budget);
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%s %.0f / %.0f MB", heap.deviceLocal ? "Device" : "Host", heap.usage / MB, heap.budget / MB);
+
+                const bool nearBudget = fraction > VulkanMemoryTracker::WARNING_FRACTION;
+                if (nearBudget) ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
+                ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+                if (nearBudget) ImGui::PopStyleColor();
+            }
+
+            if (ImGui::Button("Dump JSON")) tracker.dumpJson("ix_memory.json");
+
+            const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp;
+            if (ImGui::BeginTable("Categories", 3, flags))
+            {
+                ImGui::TableSetupColumn("Category");
+                ImGui::TableSetupColumn("MB");
+                ImGui::TableSetupColumn("Allocations");
+                ImGui::TableHeadersRow();
+
+                for (uint32_t i = 0; i < VulkanMemoryTracker::CATEGORY_COUNT; i++)
+                {
+                    const MemoryCategory category = static_cast<MemoryCategory>(i);
+                    const MemoryCategoryUsage usage = tracker.getUsage(category);
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(VulkanMemoryTracker::getCategoryName(category));
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", usage.bytes / MB);
+                    ImGui::TableNextColumn(); ImGui::Text("%u", usage.allocations);
+                }
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+}
@@ -9,9 +9,13 @@ namespace ix
 	{
 	public:
 		void onAttach() override;
-		void onUpdate(float dt) override;
+		void onImGuiRender() override;
 	private:
+		void drawFramePacing();
+		void drawGpuPasses();
+		void drawMemory();
 
 		VulkanRenderer* m_renderer = nullptr;
+		char m_capturePath[256] = "gpu_passes.csv"; // .json for a JSON capture
 	};
 }
@@ -0,0 +1,270 @@
+// profiler.cpp
+#include "common/engine_pch.h"
+#include "profiler.h"
+
+#include <iomanip>
+
+namespace ix
+{
+    namespace
+    {
+        thread_local ProfileThreadBuffer* t_buffer = nullptr;
+
+        void writeString(std::ofstream& out, const std::string& text)
+        {
+            out << '"';
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\') out << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+                else out << c;
+            }
+            out << '"';
+        }
+
+        // Trace timestamps are microseconds from the start of the capture
+        double toMicroseconds(uint64_t ns, uint64_t originNs)
+        {
+            return static_cast<double>(static_cast<int64_t>(ns - originNs)) / 1000.0;
+        }
+    }
+
+    Profiler& Profiler::get()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    uint64_t Profiler::now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    ProfileThreadBuffer& Profiler::getThreadBuffer()
+    {
+        if (t_buffer) return *t_buffer;
+
+        std::lock_guard lock(m_mutex);
+        auto buffer = std::make_unique<ProfileThreadBuffer>();
+        buffer->threadId = static_cast<uint32_t>(m_threads.size());
+        buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+        t_buffer = buffer.get();
+        m_threads.push_back(std::move(buffer));
+        return *t_buffer;
+    }
+
+    void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs)
+    {
+        ProfileThreadBuffer& buffer = getThreadBuffer();
+
+        const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+        if (head - buffer.tail.load(std::memory_order_acquire) >= ProfileThreadBuffer::CAPACITY)
+        {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer.events[head % ProfileThreadBuffer::CAPACITY] = { name, startNs, endNs };
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+
+    void Profiler::recordGpu(const std::string& name, bool asyncCompute, uint64_t startNs, uint64_t endNs)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!isRecording()) return;
+        m_gpuEvents.push_back({ name, asyncCompute, startNs, endNs });
+    }
+
+    void Profiler::setThreadName(const std::string& name)
+    {
+        ProfileThreadBuffer& buffer = getThreadBuffer();
+        std::lock_guard lock(m_mutex);
+        buffer.threadName = name;
+    }
+
+    void Profiler::startCapture(const std::string& path, uint32_t frameCount)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_armed || m_capturing)
+        {
+            spdlog::warn("Profiler: A capture is already running, ignoring {}", path);
+            return;
+        }
+
+        m_capturePath = path;
+        m_framesLeft = std::max(1u, frameCount);
+        m_armed = true;
+    }
+
+    bool Profiler::isCapturing() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_armed || m_capturing;
+    }
+
+    void Profiler::setKeepLastFrame(bool keep)
+    {
+        std::lock_guard lock(m_mutex);
+        m_keepLastFrame = keep;
+        m_hasLastFrame = false;
+        m_frameStartNs = now();
+        updateRecording();
+    }
+
+    void Profiler::updateRecording()
+    {
+        m_recording.store(m_capturing || m_keepLastFrame);
+    }
+
+    void Profiler::markFrame()
+    {
+        std::lock_guard lock(m_mutex);
+        const uint64_t frameEndNs = now();
+
+        if (m_armed)
+        {
+            // Zones that were still open when the last capture stopped are not part of this one
+            discardRings();
+            clearEvents();
+
+            m_armed = false;
+            m_capturing = true;
+            m_hasLastFrame = false;
+            m_captureStartNs = frameEndNs;
+            m_frameMarks.push_back(m_captureStartNs);
+            updateRecording();
+            spdlog::info("Profiler: Capturing {} frames", m_framesLeft);
+        }
+        else if (m_capturing)
+        {
+            drain();
+            m_frameMarks.push_back(frameEndNs);
+            if (--m_framesLeft == 0)
+            {
+                m_capturing = false;
+                updateRecording();
+                drain();
+                makeTrace(m_captureStartNs).write(m_capturePath);
+                clearEvents();
+            }
+        }
+        else if (m_keepLastFrame)
+        {
+            clearEvents();
+            drain();
+            m_frameMarks.push_back(m_frameStartNs);
+            m_lastFrameStartNs = m_frameStartNs;
+            m_hasLastFrame = true;
+        }
+
+        m_frameStartNs = frameEndNs;
+    }
+
+    bool Profiler::copyLastFrame(ProfileTrace& trace)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_capturing || !m_hasLastFrame) return false;
+        trace = makeTrace(m_lastFrameStartNs);
+        return true;
+    }
+
+    void Profiler::drain()
+    {
+        for (auto& buffer : m_threads)
+        {
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            for (; tail < head; tail++)
+            {
+                m_events.push_back({ buffer->events[tail % ProfileThreadBuffer::CAPACITY], buffer->threadId });
+            }
+            buffer->tail.store(head, std::memory_order_release);
+        }
+    }
+
+    void Profiler::discardRings()
+    {
+        for (auto& buffer : m_threads) buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    void Profiler::clearEvents()
+    {
+        m_events.clear();
+        m_gpuEvents.clear();
+        m_frameMarks.clear();
+    }
+
+    ProfileTrace Profiler::makeTrace(uint64_t originNs)
+    {
+        ProfileTrace trace;
+        trace.originNs = originNs;
+        for (const auto& buffer : m_threads)
+        {
+            trace.threadNames.emplace_back(buffer->threadId, buffer->threadName);
+            trace.droppedZones += buffer->dropped.exchange(0);
+        }
+        trace.frameMarks = m_frameMarks;
+        trace.events = m_events;
+
+        // Frames recorded before the capture started are still being collected during it
+        for (const auto& event : m_gpuEvents)
+        {
+            if (event.startNs >= originNs) trace.gpuEvents.push_back(event);
+        }
+        return trace;
+    }
+
+    bool ProfileTrace::write(const std::string& path) const
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open())
+        {
+            spdlog::error("Profiler: Failed to open trace file {}", path);
+            return false;
+        }
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}},\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Graphics queue\"}},\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Compute queue\"}}";
+
+        for (const auto& [threadId, threadName] : threadNames)
+        {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadId << ",\"args\":{\"name\":";
+            writeString(out, threadName);
+            out << "}}";
+        }
+
+        for (size_t i = 0; i < frameMarks.size(); i++)
+        {
+            out << ",\n{\"name\":\"Frame " << i << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":"
+                << toMicroseconds(frameMarks[i], originNs) << "}";
+        }
+
+        for (const auto& [event, threadId] : events)
+        {
+            out << ",\n{\"name\":";
+            writeString(out, event.name);
+            out << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadId
+                << ",\"ts\":" << toMicroseconds(event.startNs, originNs)
+                << ",\"dur\":" << toMicroseconds(event.endNs, event.startNs) << "}";
+        }
+
+        for (const auto& event : gpuEvents)
+        {
+            out << ",\n{\"name\":";
+            writeString(out, event.name);
+            out << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.asyncCompute ? 1 : 0)
+                << ",\"ts\":" << toMicroseconds(event.startNs, originNs)
+                << ",\"dur\":" << toMicroseconds(event.endNs, event.startNs) << "}";
+        }
+        out << "\n]}\n";
+
+        spdlog::info("Profiler: Wrote {} CPU and {} GPU zones to {}", events.size(), gpuEvents.size(), path);
+        if (droppedZones > 0) spdlog::warn("Profiler: {} zones dropped, a thread's ring was full", droppedZones);
+        return true;
+    }
+}
@@ -0,0 +1,164 @@
+// profiler.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ix
+{
+    // One finished zone. Names are string literals, nothing is copied on the recording path
+    struct ProfileEvent
+    {
+        const char* name = nullptr;
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+    };
+
+    // Single producer ring per thread: the owning thread pushes, the frame boundary drains.
+    // Full rings drop zones instead of blocking the thread that records them
+    struct ProfileThreadBuffer
+    {
+        static constexpr uint64_t CAPACITY = 8192;
+
+        std::array<ProfileEvent, CAPACITY> events;
+        std::atomic<uint64_t> head{ 0 }; // Owner only
+        std::atomic<uint64_t> tail{ 0 }; // Drain only
+        std::atomic<uint64_t> dropped{ 0 };
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    // A finished range of zones, copied out of the profiler so any thread can write it
+    struct ProfileTrace
+    {
+        struct ThreadEvent
+        {
+            ProfileEvent event;
+            uint32_t threadId = 0;
+        };
+
+        struct GpuEvent
+        {
+            std::string name;
+            bool asyncCompute = false;
+            uint64_t startNs = 0;
+            uint64_t endNs = 0;
+        };
+
+        uint64_t originNs = 0;
+        std::vector<std::pair<uint32_t, std::string>> threadNames;
+        std::vector<uint64_t> frameMarks;
+        std::vector<ThreadEvent> events;
+        std::vector<GpuEvent> gpuEvents;
+        uint64_t droppedZones = 0;
+
+        // chrome://tracing / Perfetto JSON
+        bool write(const std::string& path) const;
+    };
+
+    // CPU zones from every thread, plus GPU pass timings, captured over a frame range and written as a
+    // chrome://tracing / Perfetto JSON file. Zones are only recorded while a capture runs, or every frame
+    // when the last frame is kept for hitch snapshots. IX_PROFILE_* macros compile to nothing without IX_ENABLE_PROFILER
+    class Profiler
+    {
+    public:
+        static Profiler& get();
+
+        // Steady clock, shared by every zone and the calibrated GPU timestamps
+        static uint64_t now();
+
+        bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+        // Lock-free, into the calling thread's ring
+        void record(const char* name, uint64_t startNs, uint64_t endNs);
+        // Render thread. GPU results arrive a few frames late, the capture's last frames have none
+        void recordGpu(const std::string& name, bool asyncCompute, uint64_t startNs, uint64_t endNs);
+
+        // Names the calling thread in the trace
+        void setThreadName(const std::string& name);
+
+        // Starts recording at the next frame boundary and writes `path` after `frameCount` frames
+        void startCapture(const std::string& path, uint32_t frameCount);
+        bool isCapturing() const;
+
+        // Render thread, once per frame. Drains the rings and starts or finishes captures
+        void markFrame();
+
+        // Records every frame and keeps the zones of the last finished one for copyLastFrame()
+        void setKeepLastFrame(bool keep);
+        // The frame before the last markFrame(), cheap enough for the render thread. Writing it is not.
+        // False during a capture, which already holds it
+        bool copyLastFrame(ProfileTrace& trace);
+
+    private:
+        Profiler() = default;
+
+        ProfileThreadBuffer& getThreadBuffer();
+        void drain();
+        void discardRings();
+        void clearEvents();
+        void updateRecording();
+        ProfileTrace makeTrace(uint64_t originNs);
+
+        std::atomic<bool> m_recording{ false };
+
+        // Registration, capture state and drained events
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> m_threads;
+
+        std::string m_capturePath;
+        uint32_t m_framesLeft = 0;
+        bool m_armed = false;
+        bool m_capturing = false;
+        uint64_t m_captureStartNs = 0;
+
+        bool m_keepLastFrame = false;
+        bool m_hasLastFrame = false;
+        uint64_t m_frameStartNs = 0;
+        uint64_t m_lastFrameStartNs = 0;
+
+        std::vector<ProfileTrace::ThreadEvent> m_events;
+        std::vector<ProfileTrace::GpuEvent> m_gpuEvents;
+        std::vector<uint64_t> m_frameMarks;
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_name(name), m_recording(Profiler::get().isRecording())
+        {
+            if (m_recording) m_startNs = Profiler::now();
+        }
+
+        ~ProfileScope()
+        {
+            if (m_recording) Profiler::get().record(m_name, m_startNs, Profiler::now());
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_startNs = 0;
+        bool m_recording;
+    };
+}
+
+#if defined(IX_ENABLE_PROFILER)
+    #define IX_PROFILE_CONCAT_INNER(a, b) a##b
+    #define IX_PROFILE_CONCAT(a, b) IX_PROFILE_CONCAT_INNER(a, b)
+    #define IX_PROFILE_SCOPE(name) ::ix::ProfileScope IX_PROFILE_CONCAT(ixProfileScope, __LINE__)(name)
+    #define IX_PROFILE_THREAD(name) ::ix::Profiler::get().setThreadName(name)
+    #define IX_PROFILE_FRAME() ::ix::Profiler::get().markFrame()
+#else
+    #define IX_PROFILE_SCOPE(name) ((void)0)
+    #define IX_PROFILE_THREAD(name) ((void)0)
+    #define IX_PROFILE_FRAME() ((void)0)
+#endif
@@ -7,6 +7,95 @@
 
 namespace ix
 {
+    namespace
+    {
+        void cameraControlSystem(const SystemContext& context)
+        {
+            entt::registry& registry = context.registry;
+            const Input_I& input = context.input;
+            const float dt = context.dt;
+
+            auto view = registry.view<TransformComponent, CameraControlComponent>();
+
+            view.each([&](const entt::entity entity, TransformComponent& transform, CameraControlComponent& control) {
+                // Rotation
+                double dx, dy;
+                // Clear the accumulation buffer
+                const_cast<Input_I&>(input).consumeMouseDelta(dx, dy);
+                bool moved = false;
+
+                if (dx != 0.0 || dy != 0.0) {
+                    // Yaw
+                    glm::quat yaw = glm::angleAxis(static_cast<float>(-dx) * control.lookSensitivity, glm::vec3(0, 1, 0));
+                    // Pitch
+                    glm::quat pitch = glm::angleAxis(static_cast<float>(-dy) * control.lookSensitivity, glm::vec3(1, 0, 0));
+
+                    // Quaternion orientation: Yaw * Current * Pitch
+                    transform.rotation = yaw * transform.rotation * pitch;
+                    transform.rotation = glm::normalize(transform.rotation);
+                    moved = true;
+                }
+
+                // Translation
+                float speedMultiplier = input.isKeyPressed(IxKey::LEFT_SHIFT) ? 2.0f : 1.0f;
+                float currentSpeed = control.moveSpeed * speedMultiplier;
+
+                glm::vec3 moveDir{ 0.0f };
+
+                if (input.isCursorLocked() == true)
+                {
+                    if (input.isKeyPressed(IxKey::W)) moveDir += transform.getForward();
+                    if (input.isKeyPressed(IxKey::S)) moveDir -= transform.getForward();
+                    if (input.isKeyPressed(IxKey::A)) moveDir -= transform.getRight();
+                    if (input.isKeyPressed(IxKey::D)) moveDir += transform.getRight();
+
+                    if (input.isKeyPressed(IxKey::SPACE)) {
+                        moveDir += glm::vec3(0.0f, 1.0f, 0.0f);
+                    }
+                    if (input.isKeyPressed(IxKey::LEFT_CONTROL)) {
+                        moveDir += glm::vec3(0.0f, -1.0f, 0.0f);
+                    }
+                }
+
+                if (glm::length(moveDir) > 0.001f) {
+                    transform.position += glm::normalize(moveDir) * currentSpeed * dt;
+                    moved = true;
+                }
+
+                // Flag the transform so the world matrix gets recomposed
+                if (moved) registry.patch<TransformComponent>(entity);
+                });
+        }
+    }
+
+    Scene::Scene()
+    {
+        static uint64_t s_nextSceneId = 1;
+        m_id = s_nextSceneId++;
+
+        TransformSystem::connect(m_registry);
+
+        // Structural changes of renderables (an instance needs both a mesh and a transform)
+        m_registry.on_construct<MeshComponent>().connect<&Scene::onRenderableAdded>(*this);
+        m_registry.on_construct<TransformComponent>().connect<&Scene::onRenderableAdded>(*this);
+        m_registry.on_update<MeshComponent>().connect<&Scene::onRenderableChanged>(*this);
+        m_registry.on_destroy<MeshComponent>().connect<&Scene::onRenderableRemoved>(*this);
+        m_registry.on_destroy<TransformComponent>().connect<&Scene::onRenderableRemoved>(*this);
+
+        // Consumes the mouse delta, hence the write on the input
+        m_systems.addSystem("CameraControl", &cameraControlSystem)
+            .reads<CameraControlComponent>()
+            .writes<TransformComponent>()
+            .writesResource<Input_I>();
+    }
+
+    void Scene::onRenderableChanged(entt::registry&, entt::entity entity)
+    {
+        // Mesh or texture swapped: re-slot the instance
+        m_renderableChanges.removed.push_back(entity);
+        m_renderableChanges.added.push_back(entity);
+    }
+
     Entity Scene::createEntity(const std::string& name)
     {
         // Create the raw EnTT handle
@@ -24,55 +113,11 @@ namespace ix
         m_registry.destroy(entity);
     }
 
-    void Scene::update(float dt, const Input_I& input)
+    void Scene::update(float dt, const Input_I& input, JobSystem* jobs)
     {
-        auto view = m_registry.view<TransformComponent, CameraControlComponent>();
-
-        view.each([&](const entt::entity entity, TransformComponent& transform, CameraControlComponent& control) {
-            // Rotation
-            double dx, dy;
-            // Clear the accumulation buffer
-            const_cast<Input_I&>(input).consumeMouseDelta(dx, dy);
-
-            if (dx != 0.0 || dy != 0.0) {
-                // Yaw
-                glm::quat yaw = glm::angleAxis(static_cast<float>(-dx) * control.lookSensitivity, glm::vec3(0, 1, 0));
-                // Pitch
-                glm::quat pitch = glm::angleAxis(static_cast<float>(-dy) * control.lookSensitivity, glm::vec3(1, 0, 0));
-
-                // Quaternion orientation: Yaw * Current * Pitch
-                transform.rotation = yaw * transform.rotation * pitch;
-                transform.rotation = glm::normalize(transform.rotation);
-            }
-
-            // Translation
-            float speedMultiplier = input.isKeyPressed(IxKey::LEFT_SHIFT) ? 2.0f : 1.0f;
-            float currentSpeed = control.moveSpeed * speedMultiplier;
-
-            glm::vec3 moveDir{ 0.0f };
-
-            if (input.isCursorLocked() == true)
-            {
-                if (input.isKeyPressed(IxKey::W)) moveDir += transform.getForward();
-                if (input.isKeyPressed(IxKey::S)) moveDir -= transform.getForward();
-                if (input.isKeyPressed(IxKey::A)) moveDir -= transform.getRight();
-                if (input.isKeyPressed(IxKey::D)) moveDir += transform.getRight();
-
-                if (input.isKeyPressed(IxKey::SPACE)) {
-                    moveDir += glm::vec3(0.0f, 1.0f, 0.0f);
-                }
-                if (input.isKeyPressed(IxKey::LEFT_CONTROL)) {
-                    moveDir += glm::vec3(0.0f, -1.0f, 0.0f);
-                }
-            }
-
-         
-
-            if (glm::length(moveDir) > 0.001f) {
-                transform.position += glm::normalize(moveDir) * currentSpeed * dt;
-            }
-            });
+        m_systems.run(m_registry, input, jobs, dt);
     }
+
     Scene::CameraMatrices Scene::getActiveCameraMatrices(float aspect) {
         CameraMatrices result{};
         auto view = m_registry.view<TransformComponent, CameraComponent>();
@@ -4,6 +4,8 @@
 #include "entity.h"
 #include "input_i.h"
 #include "common/handles.h"
+#include "transform_system.h"
+#include "system_scheduler.h"
 
 
 namespace ix 
@@ -13,12 +15,33 @@ namespace ix
     class Scene
     {
     public:
-        Scene() = default;
+        Scene();
         ~Scene() = default;
 
+        // Signal listeners capture this scene, so it must stay at a fixed address
+        Scene(const Scene&) = delete;
+        Scene& operator=(const Scene&) = delete;
+
         Entity createEntity(const std::string& name = "Entity");
         void destroyEntity(Entity entity);
-        void update(float dt, const Input_I& input);
+        // Runs the registered systems, in parallel where their declared access allows it
+        void update(float dt, const Input_I& input, JobSystem* jobs = nullptr);
+        SystemScheduler& getSystems() { return m_systems; }
+
+        // Recompose world matrices of every transform changed since the last call
+        size_t updateTransforms(JobSystem* jobs = nullptr) { return m_transformSystem.update(m_registry, jobs); }
+        const std::vector<entt::entity>& getChangedTransforms() const { return m_transformSystem.getChanged(); }
+
+        // Entities that gained or lost a renderable component since the consumer last cleared the lists
+        struct RenderableChanges
+        {
+            std::vector<entt::entity> added;
+            std::vector<entt::entity> removed;
+        };
+        RenderableChanges& getRenderableChanges() { return m_renderableChanges; }
+
+        // Unique per scene instance, lets caches detect a scene switch
+        uint64_t getId() const { return m_id; }
 
         template<typename... Components>
         auto getAllEntitiesWith()
@@ -50,10 +73,19 @@ namespace ix
         float getSkyboxIntensity() const { return m_skyboxIntensity; }
 
     private:
+        void onRenderableAdded(entt::registry&, entt::entity entity) { m_renderableChanges.added.push_back(entity); }
+        void onRenderableRemoved(entt::registry&, entt::entity entity) { m_renderableChanges.removed.push_back(entity); }
+        void onRenderableChanged(entt::registry&, entt::entity entity);
+
+    private:
+        uint64_t m_id = 0;
+        RenderableChanges m_renderableChanges;
 
         TextureHandle m_skybox = 0;
         float m_skyboxIntensity = 1.0f;
         entt::registry m_registry;
+        TransformSystem m_transformSystem;
+        SystemScheduler m_systems;
         friend class Entity;
     };
 
@@ -67,13 +67,13 @@ namespace ix
 
                 if (item.contains("transform"))
                 {
-                    auto& tc = entity.addComponent<TransformComponent>();
+                    entity.addComponent<TransformComponent>();
                     auto& tJson = item["transform"];
 
                     // Position
                     if (tJson.contains("pos")) {
                         auto p = tJson["pos"];
-                        tc.setPosition({ p[0], p[1], p[2] });
+                        entity.setPosition({ p[0], p[1], p[2] });
                     }
 
                     // Rotation
@@ -84,13 +84,13 @@ namespace ix
                             glm::radians((float)r[1]),
                             glm::radians((float)r[2])
                         };
-                        tc.setRotation(glm::quat(eulerRadians));
+                        entity.setRotation(glm::quat(eulerRadians));
                     }
 
                     // Scale
                     if (tJson.contains("scale")) {
                         auto s = tJson["scale"];
-                        tc.setScale({ s[0], s[1], s[2] });
+                        entity.setScale({ s[0], s[1], s[2] });
                     }
                 }
                 if (item.contains("camera"))
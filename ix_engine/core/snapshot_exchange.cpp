@@ -0,0 +1,51 @@
+// snapshot_exchange.cpp
+#include "common/engine_pch.h"
+#include "snapshot_exchange.h"
+
+namespace ix
+{
+    RenderSnapshot* SnapshotExchange::beginWrite()
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_closed || m_readIndex != m_writeIndex; });
+        return m_closed ? nullptr : &m_buffers[m_writeIndex];
+    }
+
+    bool SnapshotExchange::publish()
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_closed || m_publishedIndex == -1; });
+        if (m_closed) return false;
+
+        m_publishedIndex = m_writeIndex;
+        m_writeIndex ^= 1;
+        m_cv.notify_all();
+        return true;
+    }
+
+    const RenderSnapshot* SnapshotExchange::acquireRead(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait_for(lock, timeout, [this]() { return m_closed || m_publishedIndex != -1; });
+        if (m_closed || m_publishedIndex == -1) return nullptr;
+
+        m_readIndex = m_publishedIndex;
+        m_publishedIndex = -1;
+        m_cv.notify_all();
+        return &m_buffers[m_readIndex];
+    }
+
+    void SnapshotExchange::releaseRead()
+    {
+        std::lock_guard lock(m_mutex);
+        m_readIndex = -1;
+        m_cv.notify_all();
+    }
+
+    void SnapshotExchange::close()
+    {
+        std::lock_guard lock(m_mutex);
+        m_closed = true;
+        m_cv.notify_all();
+    }
+}
@@ -0,0 +1,39 @@
+// snapshot_exchange.h
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "global_common/ix_global_pods.h"
+
+namespace ix
+{
+    // Double-buffered hand-off of RenderSnapshots from the game thread to the render thread.
+    // The game thread fills one buffer while the render thread reads the other. Every published
+    // snapshot is consumed exactly once, so the instance deltas inside them are never lost.
+    class SnapshotExchange
+    {
+    public:
+        // Game thread. Blocks while the render thread still reads the buffer; null once closed
+        RenderSnapshot* beginWrite();
+        // Game thread. Blocks until the previous snapshot was taken; false once closed
+        bool publish();
+
+        // Render thread. Null on timeout or once closed
+        const RenderSnapshot* acquireRead(std::chrono::milliseconds timeout);
+        void releaseRead();
+
+        // Wakes up both sides for shutdown
+        void close();
+
+    private:
+        RenderSnapshot m_buffers[2];
+        int m_writeIndex = 0;
+        int m_publishedIndex = -1;
+        int m_readIndex = -1;
+        bool m_closed = false;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+    };
+}
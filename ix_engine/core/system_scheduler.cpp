@@ -0,0 +1,115 @@
+// system_scheduler.cpp
+#include "common/engine_pch.h"
+#include "system_scheduler.h"
+#include "job_system.h"
+
+namespace ix
+{
+    SystemScheduler::SystemBuilder SystemScheduler::addSystem(const std::string& name, SystemFunction function)
+    {
+        System system;
+        system.name = name;
+        system.function = std::move(function);
+        m_systems.push_back(std::move(system));
+        m_graphDirty = true;
+
+        return SystemBuilder(*this, m_systems.size() - 1);
+    }
+
+    void SystemScheduler::setEnabled(const std::string& name, bool enabled)
+    {
+        for (auto& system : m_systems)
+        {
+            if (system.name != name) continue;
+            if (system.enabled != enabled) m_graphDirty = true;
+            system.enabled = enabled;
+            return;
+        }
+        spdlog::warn("SystemScheduler: No system named '{}'", name);
+    }
+
+    bool SystemScheduler::conflicts(const System& a, const System& b)
+    {
+        if (a.exclusive || b.exclusive) return true;
+
+        auto overlaps = [](const std::vector<entt::id_type>& lhs, const std::vector<entt::id_type>& rhs) {
+            for (entt::id_type id : lhs)
+            {
+                if (std::find(rhs.begin(), rhs.end(), id) != rhs.end()) return true;
+            }
+            return false;
+            };
+
+        return overlaps(a.writes, b.writes) || overlaps(a.writes, b.reads) || overlaps(a.reads, b.writes);
+    }
+
+    void SystemScheduler::buildGraph()
+    {
+        m_nodes.clear();
+        for (size_t i = 0; i < m_systems.size(); i++)
+        {
+            if (!m_systems[i].enabled) continue;
+
+            Node node;
+            node.system = i;
+            m_nodes.push_back(std::move(node));
+        }
+
+        // Every conflicting pair is ordered by registration
+        for (uint32_t later = 0; later < m_nodes.size(); later++)
+        {
+            for (uint32_t earlier = 0; earlier < later; earlier++)
+            {
+                if (!conflicts(m_systems[m_nodes[earlier].system], m_systems[m_nodes[later].system])) continue;
+
+                m_nodes[earlier].dependents.push_back(later);
+                m_nodes[later].dependencyCount++;
+            }
+        }
+
+        m_pending = std::make_unique<std::atomic<uint32_t>[]>(m_nodes.size());
+        m_graphDirty = false;
+    }
+
+    void SystemScheduler::run(entt::registry& registry, const Input_I& input, JobSystem* jobs, float dt)
+    {
+        if (m_graphDirty) buildGraph();
+        if (m_nodes.empty()) return;
+
+        SystemContext context{ registry, input, jobs, dt };
+
+        // Registration order is a valid topological order
+        if (!jobs || jobs->getWorkerCount() == 0 || m_nodes.size() == 1)
+        {
+            for (const Node& node : m_nodes) m_systems[node.system].function(context);
+            return;
+        }
+
+        for (const Node& node : m_nodes)
+        {
+            for (auto prepare : m_systems[node.system].prepare) prepare(registry);
+        }
+
+        for (uint32_t i = 0; i < m_nodes.size(); i++) m_pending[i].store(m_nodes[i].dependencyCount);
+
+        JobCounter done;
+        for (uint32_t i = 0; i < m_nodes.size(); i++)
+        {
+            if (m_nodes[i].dependencyCount == 0) launch(i, context, *jobs, done);
+        }
+        jobs->wait(done);
+    }
+
+    void SystemScheduler::launch(uint32_t node, const SystemContext& context, JobSystem& jobs, JobCounter& done)
+    {
+        jobs.schedule([this, node, &context, &jobs, &done]() {
+            m_systems[m_nodes[node].system].function(context);
+
+            // Dependents are launched before this job retires, so `done` cannot drain early
+            for (uint32_t dependent : m_nodes[node].dependents)
+            {
+                if (m_pending[dependent].fetch_sub(1) == 1) launch(dependent, context, jobs, done);
+            }
+            }, &done);
+    }
+}
@@ -0,0 +1,138 @@
+// system_scheduler.h
+#pragma once
+#include <entt/entt.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "components.h"
+
+namespace ix
+{
+    class Input_I;
+    class JobSystem;
+    class JobCounter;
+
+    struct SystemContext
+    {
+        entt::registry& registry;
+        const Input_I& input;
+        JobSystem* jobs; // Null when running single threaded
+        float dt;
+    };
+
+    using SystemFunction = std::function<void(const SystemContext&)>;
+
+    // Runs ECS systems as a dependency graph. Each system declares the components (and other shared
+    // resources) it reads and writes; two systems conflict when one writes something the other touches.
+    // Conflicting systems run in registration order, everything else runs in parallel on the job system.
+    class SystemScheduler
+    {
+    public:
+        class SystemBuilder
+        {
+        public:
+            template<typename... Components>
+            SystemBuilder& reads()
+            {
+                (addComponent<Components>(m_scheduler.m_systems[m_index].reads), ...);
+                return *this;
+            }
+
+            // Also declares the pools the components' update signals write
+            template<typename... Components>
+            SystemBuilder& writes()
+            {
+                (addWrite<Components>(), ...);
+                return *this;
+            }
+
+            // Non-component state shared between systems (input, singletons...)
+            template<typename... Resources>
+            SystemBuilder& readsResource()
+            {
+                (m_scheduler.m_systems[m_index].reads.push_back(entt::type_hash<Resources>::value()), ...);
+                return *this;
+            }
+
+            template<typename... Resources>
+            SystemBuilder& writesResource()
+            {
+                (m_scheduler.m_systems[m_index].writes.push_back(entt::type_hash<Resources>::value()), ...);
+                return *this;
+            }
+
+            // Runs alone. Required for systems that create or destroy entities or emplace/remove components
+            SystemBuilder& exclusive()
+            {
+                m_scheduler.m_systems[m_index].exclusive = true;
+                return *this;
+            }
+
+        private:
+            friend class SystemScheduler;
+            SystemBuilder(SystemScheduler& scheduler, size_t index) : m_scheduler(scheduler), m_index(index) {}
+
+            template<typename Component>
+            void addWrite()
+            {
+                addComponent<Component>(m_scheduler.m_systems[m_index].writes);
+                // patch<TransformComponent> tags the entity through on_update (TransformSystem)
+                if constexpr (std::is_same_v<Component, TransformComponent>)
+                {
+                    addComponent<TransformDirtyTag>(m_scheduler.m_systems[m_index].writes);
+                }
+            }
+
+            template<typename Component>
+            void addComponent(std::vector<entt::id_type>& access)
+            {
+                access.push_back(entt::type_hash<Component>::value());
+                // Pools must exist before systems run concurrently, creating one mutates the registry
+                m_scheduler.m_systems[m_index].prepare.push_back(+[](entt::registry& registry) { registry.storage<Component>(); });
+            }
+
+            SystemScheduler& m_scheduler;
+            size_t m_index;
+        };
+
+        SystemBuilder addSystem(const std::string& name, SystemFunction function);
+        void setEnabled(const std::string& name, bool enabled);
+
+        // Blocks until every enabled system has run
+        void run(entt::registry& registry, const Input_I& input, JobSystem* jobs, float dt);
+
+        size_t getSystemCount() const { return m_systems.size(); }
+
+    private:
+        struct System
+        {
+            std::string name;
+            SystemFunction function;
+            std::vector<entt::id_type> reads;
+            std::vector<entt::id_type> writes;
+            std::vector<void(*)(entt::registry&)> prepare;
+            bool exclusive = false;
+            bool enabled = true;
+        };
+
+        struct Node
+        {
+            size_t system = 0;
+            uint32_t dependencyCount = 0;
+            std::vector<uint32_t> dependents;
+        };
+
+        static bool conflicts(const System& a, const System& b);
+        void buildGraph();
+        void launch(uint32_t node, const SystemContext& context, JobSystem& jobs, JobCounter& done);
+
+        std::vector<System> m_systems;
+        std::vector<Node> m_nodes;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_pending; // Per node, unfinished dependencies this frame
+        bool m_graphDirty = true;
+    };
+}
@@ -0,0 +1,266 @@
+// transform_system.cpp
+#include "common/engine_pch.h"
+#include "transform_system.h"
+#include "components.h"
+#include "job_system.h"
+
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define IX_TRANSFORM_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IX_TRANSFORM_SSE 1
+#endif
+
+namespace ix
+{
+    namespace
+    {
+        // Scalar reference, also handles the tail of the SIMD loops
+        inline void composeAffine(const TransformComponent& t, WorldTransformComponent& out)
+        {
+            const glm::quat& q = t.rotation;
+            const float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z;
+            const float xx = q.x * x2, yy = q.y * y2, zz = q.z * z2;
+            const float xy = q.x * y2, xz = q.x * z2, yz = q.y * z2;
+            const float wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+
+            out.rows[0] = { (1.0f - (yy + zz)) * t.scale.x, (xy - wz) * t.scale.y, (xz + wy) * t.scale.z, t.position.x };
+            out.rows[1] = { (xy + wz) * t.scale.x, (1.0f - (xx + zz)) * t.scale.y, (yz - wx) * t.scale.z, t.position.y };
+            out.rows[2] = { (xz - wy) * t.scale.x, (yz + wx) * t.scale.y, (1.0f - (xx + yy)) * t.scale.z, t.position.z };
+        }
+
+#if defined(IX_TRANSFORM_SSE)
+        // r holds the 12 matrix elements (row-major) for 4 lanes; transposes them into 4 affine matrices
+        inline void storeAffine4(__m128 r[12], WorldTransformComponent* out)
+        {
+            for (int row = 0; row < 3; row++)
+            {
+                __m128 a = r[row * 4 + 0];
+                __m128 b = r[row * 4 + 1];
+                __m128 c = r[row * 4 + 2];
+                __m128 d = r[row * 4 + 3];
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+                _mm_storeu_ps(&out[0].rows[row].x, a);
+                _mm_storeu_ps(&out[1].rows[row].x, b);
+                _mm_storeu_ps(&out[2].rows[row].x, c);
+                _mm_storeu_ps(&out[3].rows[row].x, d);
+            }
+        }
+
+        // TransformComponent is 10 packed floats: px py pz | qx qy qz qw | sx sy sz
+        static_assert(sizeof(TransformComponent) == 10 * sizeof(float), "composeAffine4 loads TransformComponent as 10 floats");
+        static_assert(offsetof(TransformComponent, rotation) == 3 * sizeof(float) && offsetof(TransformComponent, scale) == 7 * sizeof(float),
+            "composeAffine4 expects position, rotation, scale in that order");
+        static_assert(offsetof(glm::quat, x) == 0 && offsetof(glm::quat, w) == 3 * sizeof(float), "composeAffine4 expects xyzw quaternions");
+
+        // The 10 TRS streams of 4 consecutive transforms, one lane per transform. Three overlapping
+        // 4-float loads per transform (floats 0-3, 4-7 and 6-9) and three transposes, no scalar inserts
+        struct Lanes4
+        {
+            __m128 px, py, pz, qx, qy, qz, qw, sx, sy, sz;
+        };
+
+        inline Lanes4 loadLanes4(const TransformComponent* in)
+        {
+            const float* f0 = &in[0].position.x;
+            const float* f1 = &in[1].position.x;
+            const float* f2 = &in[2].position.x;
+            const float* f3 = &in[3].position.x;
+
+            Lanes4 l;
+            l.px = _mm_loadu_ps(f0); l.py = _mm_loadu_ps(f1); l.pz = _mm_loadu_ps(f2); l.qx = _mm_loadu_ps(f3);
+            _MM_TRANSPOSE4_PS(l.px, l.py, l.pz, l.qx);
+
+            l.qy = _mm_loadu_ps(f0 + 4); l.qz = _mm_loadu_ps(f1 + 4); l.qw = _mm_loadu_ps(f2 + 4); l.sx = _mm_loadu_ps(f3 + 4);
+            _MM_TRANSPOSE4_PS(l.qy, l.qz, l.qw, l.sx);
+
+            // Floats 6-9: qw and sx again, then sy and sz
+            __m128 a = _mm_loadu_ps(f0 + 6), b = _mm_loadu_ps(f1 + 6), c = _mm_loadu_ps(f2 + 6), d = _mm_loadu_ps(f3 + 6);
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            l.sy = c;
+            l.sz = d;
+            return l;
+        }
+
+        inline void composeAffine4(const TransformComponent* in, WorldTransformComponent* out)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            const Lanes4 l = loadLanes4(in);
+            const __m128 qx = l.qx, qy = l.qy, qz = l.qz, qw = l.qw;
+            const __m128 sx = l.sx, sy = l.sy, sz = l.sz;
+
+            const __m128 x2 = _mm_add_ps(qx, qx), y2 = _mm_add_ps(qy, qy), z2 = _mm_add_ps(qz, qz);
+            const __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2), zz = _mm_mul_ps(qz, z2);
+            const __m128 xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+            const __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2), wz = _mm_mul_ps(qw, z2);
+
+            __m128 r[12];
+            r[0] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+            r[1] = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+            r[2] = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+            r[3] = l.px;
+
+            r[4] = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+            r[5] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+            r[6] = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+            r[7] = l.py;
+
+            r[8] = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+            r[9] = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+            r[10] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+            r[11] = l.pz;
+
+            storeAffine4(r, out);
+        }
+#endif
+
+#if defined(IX_TRANSFORM_AVX2)
+        inline __m256 combine(__m128 lo, __m128 hi)
+        {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+        }
+
+        inline void composeAffine8(const TransformComponent* in, WorldTransformComponent* out)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            const Lanes4 lo = loadLanes4(in);
+            const Lanes4 hi = loadLanes4(in + 4);
+            const __m256 qx = combine(lo.qx, hi.qx), qy = combine(lo.qy, hi.qy), qz = combine(lo.qz, hi.qz), qw = combine(lo.qw, hi.qw);
+            const __m256 sx = combine(lo.sx, hi.sx), sy = combine(lo.sy, hi.sy), sz = combine(lo.sz, hi.sz);
+
+            const __m256 x2 = _mm256_add_ps(qx, qx), y2 = _mm256_add_ps(qy, qy), z2 = _mm256_add_ps(qz, qz);
+            const __m256 xx = _mm256_mul_ps(qx, x2), yy = _mm256_mul_ps(qy, y2), zz = _mm256_mul_ps(qz, z2);
+            const __m256 xy = _mm256_mul_ps(qx, y2), xz = _mm256_mul_ps(qx, z2), yz = _mm256_mul_ps(qy, z2);
+            const __m256 wx = _mm256_mul_ps(qw, x2), wy = _mm256_mul_ps(qw, y2), wz = _mm256_mul_ps(qw, z2);
+
+            __m256 r[12];
+            r[0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx);
+            r[1] = _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy);
+            r[2] = _mm256_mul_ps(_mm256_add_ps(xz, wy), sz);
+            r[3] = combine(lo.px, hi.px);
+
+            r[4] = _mm256_mul_ps(_mm256_add_ps(xy, wz), sx);
+            r[5] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy);
+            r[6] = _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz);
+            r[7] = combine(lo.py, hi.py);
+
+            r[8] = _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx);
+            r[9] = _mm256_mul_ps(_mm256_add_ps(yz, wx), sy);
+            r[10] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz);
+            r[11] = combine(lo.pz, hi.pz);
+
+            // Split into two 4-wide halves and reuse the SSE transpose
+            __m128 low[12], high[12];
+            for (int i = 0; i < 12; i++)
+            {
+                low[i] = _mm256_castps256_ps128(r[i]);
+                high[i] = _mm256_extractf128_ps(r[i], 1);
+            }
+            storeAffine4(low, out);
+            storeAffine4(high, out + 4);
+        }
+#endif
+    }
+
+    void composeAffineBatch(const TransformComponent* local, WorldTransformComponent* world, size_t count)
+    {
+        size_t i = 0;
+
+#if defined(IX_TRANSFORM_AVX2)
+        for (; i + 8 <= count; i += 8) composeAffine8(local + i, world + i);
+#endif
+#if defined(IX_TRANSFORM_SSE)
+        for (; i + 4 <= count; i += 4) composeAffine4(local + i, world + i);
+#endif
+        for (; i < count; i++) composeAffine(local[i], world[i]);
+    }
+
+    void composeAffineBatchScalar(const TransformComponent* local, WorldTransformComponent* world, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) composeAffine(local[i], world[i]);
+    }
+
+    namespace
+    {
+        void onTransformConstruct(entt::registry& registry, entt::entity entity)
+        {
+            registry.emplace_or_replace<WorldTransformComponent>(entity);
+            registry.emplace_or_replace<TransformDirtyTag>(entity);
+        }
+
+        void onTransformUpdate(entt::registry& registry, entt::entity entity)
+        {
+            registry.emplace_or_replace<TransformDirtyTag>(entity);
+        }
+
+        void onTransformDestroy(entt::registry& registry, entt::entity entity)
+        {
+            registry.remove<WorldTransformComponent, TransformDirtyTag>(entity);
+        }
+    }
+
+    void TransformSystem::connect(entt::registry& registry)
+    {
+        registry.on_construct<TransformComponent>().connect<&onTransformConstruct>();
+        registry.on_update<TransformComponent>().connect<&onTransformUpdate>();
+        registry.on_destroy<TransformComponent>().connect<&onTransformDestroy>();
+    }
+
+    void TransformSystem::disconnect(entt::registry& registry)
+    {
+        registry.on_construct<TransformComponent>().disconnect<&onTransformConstruct>();
+        registry.on_update<TransformComponent>().disconnect<&onTransformUpdate>();
+        registry.on_destroy<TransformComponent>().disconnect<&onTransformDestroy>();
+    }
+
+    size_t TransformSystem::update(entt::registry& registry, JobSystem* jobs)
+    {
+        auto dirty = registry.view<TransformDirtyTag, TransformComponent>();
+
+        // Gather the dirty TRS into a contiguous block so the kernel runs over packed data
+        m_entities.clear();
+        m_localScratch.clear();
+        for (auto [entity, transform] : dirty.each())
+        {
+            m_entities.push_back(entity);
+            m_localScratch.push_back(transform);
+        }
+
+        const size_t count = m_entities.size();
+        if (count == 0) return 0;
+
+        m_worldScratch.resize(count);
+        // Below a few thousand transforms the fork/join costs more than it saves
+        constexpr size_t PARALLEL_THRESHOLD = 4096;
+        constexpr size_t PARALLEL_GRAIN = 2048;
+
+        const TransformComponent* local = m_localScratch.data();
+        WorldTransformComponent* world = m_worldScratch.data();
+        if (jobs && count >= PARALLEL_THRESHOLD)
+        {
+            jobs->parallelFor(0, count, PARALLEL_GRAIN, [local, world](size_t begin, size_t end) {
+                composeAffineBatch(local + begin, world + begin, end - begin);
+                });
+        }
+        else
+        {
+            composeAffineBatch(local, world, count);
+        }
+
+        // Scatter back into the world storage
+        auto& worldStorage = registry.storage<WorldTransformComponent>();
+        for (size_t i = 0; i < count; i++)
+        {
+            worldStorage.get(m_entities[i]) = m_worldScratch[i];
+        }
+
+        registry.clear<TransformDirtyTag>();
+        return count;
+    }
+}
@@ -0,0 +1,38 @@
+// transform_system.h
+#pragma once
+#include <entt/entt.hpp>
+#include <vector>
+#include <cstddef>
+#include "components.h"
+
+namespace ix
+{
+    class JobSystem;
+
+    // Composes T * R * S for `count` transforms into row-major affine 3x4 matrices.
+    // Uses AVX2 (8 wide) when compiled with it, SSE (4 wide) on x86, scalar otherwise.
+    void composeAffineBatch(const TransformComponent* local, WorldTransformComponent* world, size_t count);
+    // Same result without SIMD, the reference the kernels are measured against
+    void composeAffineBatchScalar(const TransformComponent* local, WorldTransformComponent* world, size_t count);
+
+    // Keeps WorldTransformComponent in sync with TransformComponent.
+    // Dirty entities are tagged through registry signals and recomposed in one batch per update.
+    class TransformSystem
+    {
+    public:
+        static void connect(entt::registry& registry);
+        static void disconnect(entt::registry& registry);
+
+        // Recomposes every entity tagged dirty since the last call. Returns the number of updated entities.
+        // Large batches are split across the job system when one is given
+        size_t update(entt::registry& registry, JobSystem* jobs = nullptr);
+
+        // Entities recomposed by the last update, valid until the next one
+        const std::vector<entt::entity>& getChanged() const { return m_entities; }
+
+    private:
+        std::vector<entt::entity> m_entities;
+        std::vector<TransformComponent> m_localScratch;
+        std::vector<WorldTransformComponent> m_worldScratch;
+    };
+}
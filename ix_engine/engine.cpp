@@ -5,6 +5,11 @@
 #include "core/scene_manager.h"
 #include "platform/rendering/rendering_api.h"
 #include "platform/glfw_platform.h"
+#include "platform/headless_platform.h"
+#include "core/input_state.h"
+#include "core/snapshot_exchange.h"
+#include "core/frame_recorder.h"
+#include "core/profiler.h"
 
 #include "input_i.h"
 #include "layer_i.h"
@@ -14,13 +19,47 @@ namespace ix
 
 	Engine* Engine::s_instance = nullptr;
 	Engine::Engine(const EngineSpecification spec)
-		: m_platform(std::make_unique<GlfwPlatform>(spec.windowSpec, spec.name))
-		, m_window(*m_platform)
-		, m_input(*m_platform)
+		: m_jobSystem(std::make_unique<JobSystem>(JobSystemSpecification{ spec.workerThreadCount, spec.pinWorkerThreads }))
+		, m_platform(spec.headless.enabled ? nullptr : std::make_unique<GlfwPlatform>(spec.windowSpec, spec.name))
+		, m_headlessPlatform(spec.headless.enabled ? std::make_unique<HeadlessPlatform>(spec.windowSpec) : nullptr)
+		, m_inputEvents(std::make_unique<InputEventQueue>())
+		, m_inputState(std::make_unique<InputState>(*m_inputEvents))
+		, m_window(m_platform ? static_cast<Window_I&>(*m_platform) : *m_headlessPlatform)
+		, m_input(*m_inputState)
+		, m_pipelined(spec.pipelinedRendering)
+		, m_headless(spec.headless)
+		, m_frameStats(std::make_unique<FrameStats>(spec.frameStats))
 	{
+		if (!spec.replay.recordPath.empty() && !spec.replay.replayPath.empty())
+		{
+			throw std::runtime_error("Engine: Can't record and replay at the same time");
+		}
+		if (!spec.replay.replayPath.empty())
+		{
+			m_replayer = std::make_unique<FrameReplayer>(spec.replay.replayPath);
+			const FrameCaptureHeader& header = m_replayer->getHeader();
+			if (header.width != spec.windowSpec.width || header.height != spec.windowSpec.height)
+			{
+				spdlog::warn("Engine: Capture was recorded at {}x{}, replaying at {}x{}", header.width, header.height,
+					spec.windowSpec.width, spec.windowSpec.height);
+			}
+		}
+		if (!spec.replay.recordPath.empty())
+		{
+			m_recorder = std::make_unique<FrameRecorder>(spec.replay.recordPath, spec.windowSpec.width, spec.windowSpec.height);
+			m_inputState->setEventObserver([this](const InputEvent& event) { m_recorder->recordEvent(event); });
+		}
+
 		if (s_instance) { spdlog::error("Engine instance already exists!"); }
 		s_instance = this;
 		m_renderer = createRenderer(m_window, spec.api);
+
+		// The window may only be touched from the main thread. A replay takes no input from it
+		if (m_platform && !m_replayer) m_platform->setInputEventQueue(m_inputEvents.get());
+		m_inputState->setCursorLockHandler([this](bool lock) {
+			if (m_jobSystem->isMainThread()) m_window.lockCursor(lock);
+			else m_jobSystem->scheduleOnMainThread([this, lock]() { m_window.lockCursor(lock); });
+			});
 	}
 
 	Engine::~Engine() { shutdown();	}
@@ -36,7 +75,10 @@ namespace ix
 		auto* vkContext = static_cast <VulkanContext*>(m_renderer->getAPIContext()); // Subject to change
 		AssetManager::get().init(vkContext);
 
+		m_renderer->setJobSystem(m_jobSystem.get());
+		m_frameStats->setJobSystem(m_jobSystem.get());
 		m_renderer->init();
+		updateViewportExtent();
 
 		SceneManager::init();
 
@@ -48,83 +90,274 @@ namespace ix
 
 	void Engine::run()
 	{
-		spdlog::info("ix::Engine::run() ... ");
+		spdlog::info("ix::Engine::run() ... ({})", m_pipelined ? "pipelined" : "serial");
+
+		if (m_pipelined) runPipelined();
+		else runSerial();
+
+		if (m_headless.enabled && !m_headless.capturePath.empty()) m_renderer->saveFrame(m_headless.capturePath);
+	}
+
+	void Engine::runSerial()
+	{
+		IX_PROFILE_THREAD("Main");
 
 		using clock = std::chrono::high_resolution_clock;
 		auto lastTime = clock::now();
 		double accumulator = 0.0;
-		const double dt = 1.0 / 144.0; // Fixed delta time
+		RenderSnapshot snapshot;
 
 		while (!m_window.isWindowShouldClose())
 		{
 			auto currentTime = clock::now();
 			double frameTime = std::chrono::duration<double>(currentTime - lastTime).count();
 			lastTime = currentTime;
+			updateFrameStats(frameTime);
 			if (frameTime > 0.25) frameTime = 0.25; // prevents spiral
-			accumulator += frameTime;
+			updateFPS(frameTime);
 
-			if (frameTime > 0.0)
+			m_window.pollEvents();
+			m_jobSystem->pumpMainThread();
+			if (!beginReplayFrame(frameTime))
 			{
-				float currentFPS = static_cast<float>(1.0 / frameTime);
-
-				// Smooth the internal value constantly
-				m_smoothedFPS = (m_smoothedFPS * 0.99f) + (currentFPS * 0.01f);
-
-				// Only update the 'display' FPS member every 0.5 seconds
-				m_fpsTimer += frameTime;
-				if (m_fpsTimer >= 0.5)
-				{
-					m_lastFrameFPS = m_smoothedFPS;
-					m_fpsTimer = 0.0;
-				}
+				m_window.requestWindowClose();
+				continue;
 			}
+			m_inputState->processEvents();
 
+			float alpha = simulate(frameTime, accumulator);
+			if (m_closeRequested) m_window.requestWindowClose();
+
+			extractFrame(snapshot, frameTime, alpha);
+			renderFrame(snapshot);
+			updateViewportExtent();
+			countHeadlessFrame();
+		}
+	}
+
+	void Engine::runPipelined()
+	{
+		IX_PROFILE_THREAD("Main / Render");
+
+		m_snapshots = std::make_unique<SnapshotExchange>();
+		m_gameThread = std::thread([this]() { gameThreadLoop(); });
+
+		using clock = std::chrono::high_resolution_clock;
+		auto lastTime = clock::now();
+
+		while (!m_window.isWindowShouldClose())
+		{
 			m_window.pollEvents();
+			m_jobSystem->pumpMainThread();
+			if (m_closeRequested) m_window.requestWindowClose();
+
+			// Short timeout so window events keep flowing while the game thread is busy
+			const RenderSnapshot* snapshot = m_snapshots->acquireRead(std::chrono::milliseconds(2));
+			if (!snapshot) continue;
+
+			renderFrame(*snapshot);
+			m_snapshots->releaseRead();
+			updateViewportExtent();
+			countHeadlessFrame();
+
+			auto currentTime = clock::now();
+			const double frameTime = std::chrono::duration<double>(currentTime - lastTime).count();
+			updateFPS(frameTime);
+			updateFrameStats(frameTime);
+			lastTime = currentTime;
+		}
+
+		m_snapshots->close();
+		if (m_gameThread.joinable()) m_gameThread.join();
+		m_jobSystem->pumpMainThread(); // Drop whatever the game thread left for us
+	}
+
+	void Engine::gameThreadLoop()
+	{
+		IX_PROFILE_THREAD("Game");
 
-			while (accumulator >= dt)
+		using clock = std::chrono::high_resolution_clock;
+		auto lastTime = clock::now();
+		double accumulator = 0.0;
+
+		try
+		{
+			while (!m_closeRequested)
 			{
-				// Process System-level Input
-				processInput();
+				auto currentTime = clock::now();
+				double frameTime = std::chrono::duration<double>(currentTime - lastTime).count();
+				lastTime = currentTime;
+				if (frameTime > 0.25) frameTime = 0.25; // prevents spiral
+				if (!beginReplayFrame(frameTime)) break;
+
+				m_inputState->processEvents();
+				float alpha = simulate(frameTime, accumulator);
 
-				for (auto& layer : m_layers) {
-					layer->onFixedUpdate(static_cast<float>(dt));
-				}
+				// Waits while the render thread still reads this buffer
+				RenderSnapshot* snapshot = m_snapshots->beginWrite();
+				if (!snapshot) break;
 
-				accumulator -= dt;
+				extractFrame(*snapshot, frameTime, alpha);
+				if (!m_snapshots->publish()) break;
 			}
-			auto extent = m_renderer->getSwapchainExtent();
-			float aspect = static_cast<float>(extent.width) / static_cast<float>(extent.height);
-			auto camera = SceneManager::getActiveCameraMatrices(aspect);
-
-			SceneView view{};
-			view.deltaTime = static_cast<float>(frameTime);
-			// TODO: Add total time
-			view.viewMatrix = camera.getView();
-			view.projectionMatrix = camera.getProj();
-			view.clusterProjection = camera.getClusterProj();
-			view.cameraPosition = camera.getPos();
+		}
+		catch (const std::exception& e)
+		{
+			spdlog::error("Engine: Game thread stopped: {}", e.what());
+			m_closeRequested = true;
+			m_snapshots->close();
+		}
+	}
 
-			FrameContext frameCtx;
-			if (m_renderer->beginFrame(frameCtx, view))
-			{ 
+	float Engine::simulate(double frameTime, double& accumulator)
+	{
+		IX_PROFILE_SCOPE("Engine::simulate");
+
+		const double dt = 1.0 / 144.0; // Fixed delta time
+
+		accumulator += frameTime;
+		while (accumulator >= dt)
+		{
+			// Process System-level Input
+			processInput();
+
+			for (auto& layer : m_layers) {
+				layer->onFixedUpdate(static_cast<float>(dt));
+			}
+
+			accumulator -= dt;
+		}
+
+		for (auto& layer : m_layers) layer->onUpdate(static_cast<float>(frameTime));
+
+		// Propagate changed transforms before the renderer reads them
+		auto& scene = SceneManager::getActiveScene();
+		if (m_replayer) m_replayer->applyTransforms(scene);
+		scene.updateTransforms(m_jobSystem.get());
+		if (m_recorder) m_recorder->recordTransforms(scene);
+
+		return static_cast<float>(accumulator / dt);
+	}
+
+	void Engine::extractFrame(RenderSnapshot& snapshot, double frameTime, float alpha)
+	{
+		IX_PROFILE_SCOPE("Engine::extractFrame");
+
+		auto& scene = SceneManager::getActiveScene();
 
-				float alpha = static_cast<float>(accumulator / dt);
+		float aspect = static_cast<float>(m_viewportWidth.load()) / static_cast<float>(m_viewportHeight.load());
+		auto camera = SceneManager::getActiveCameraMatrices(aspect);
 
-				for (auto& layer : m_layers) layer->onUpdate(static_cast<float>(frameTime));
+		m_totalTime += frameTime;
 
-				m_renderer->render(frameCtx, view);
+		SceneView& view = snapshot.view;
+		view.deltaTime = static_cast<float>(frameTime);
+		view.totalTime = static_cast<float>(m_totalTime);
+		view.viewMatrix = camera.getView();
+		view.projectionMatrix = camera.getProj();
+		view.clusterProjection = camera.getClusterProj();
+		view.cameraPosition = camera.getPos();
+		view.skybox = scene.getSkybox();
+		view.skyboxIntensity = scene.getSkyboxIntensity();
+		snapshot.interpolationAlpha = alpha;
 
-				for (auto& layer : m_layers) layer->onRender(alpha);
+		// The recorded view wins over whatever the camera did this time
+		if (m_replayer) view = m_replayer->getFrame().view;
+		if (m_recorder) m_recorder->endFrame(frameTime, view);
+
+		m_renderer->prepareFrame(scene, snapshot);
+	}
+
+	void Engine::renderFrame(const RenderSnapshot& snapshot)
+	{
+		{
+			IX_PROFILE_SCOPE("Engine::renderFrame");
+
+			FrameContext frameCtx;
+			if (m_renderer->beginFrame(frameCtx, snapshot))
+			{
+				for (auto& layer : m_layers) layer->onImGuiRender();
+
+				m_renderer->render(frameCtx, snapshot.view);
+
+				for (auto& layer : m_layers) layer->onRender(snapshot.interpolationAlpha);
 
 				m_renderer->endFrame(frameCtx);
 			}
-			
 		}
+
+		// After the zone closed, so it lands in this frame's drain
+		IX_PROFILE_FRAME();
+	}
+
+	void Engine::updateViewportExtent()
+	{
+		auto extent = m_renderer->getSwapchainExtent();
+		if (extent.width == 0 || extent.height == 0) return; // Minimized, keep the last aspect
+		m_viewportWidth = extent.width;
+		m_viewportHeight = extent.height;
+	}
+
+	void Engine::updateFPS(double frameTime)
+	{
+		if (frameTime <= 0.0) return;
+
+		float currentFPS = static_cast<float>(1.0 / frameTime);
+
+		// Smooth the internal value constantly
+		m_smoothedFPS = (m_smoothedFPS * 0.99f) + (currentFPS * 0.01f);
+
+		// Only update the 'display' FPS member every 0.5 seconds
+		m_fpsTimer += frameTime;
+		if (m_fpsTimer >= 0.5)
+		{
+			m_lastFrameFPS = m_smoothedFPS;
+			m_fpsTimer = 0.0;
+		}
+	}
+
+	void Engine::updateFrameStats(double frameTime)
+	{
+		const RenderStats stats = m_renderer->getStats();
+		m_frameStats->record(FrameMetric::CpuFrame, static_cast<float>(frameTime * 1000.0));
+		m_frameStats->record(FrameMetric::AcquireWait, stats.acquireWaitMs);
+		m_frameStats->record(FrameMetric::FenceWait, stats.fenceWaitMs);
+		if (stats.gpuTimeMs > 0.0f) m_frameStats->record(FrameMetric::GpuFrame, stats.gpuTimeMs);
+		m_frameStats->endFrame();
+	}
+
+	void Engine::countHeadlessFrame()
+	{
+		// A replay ends with its capture
+		if (!m_headless.enabled || m_replayer) return;
+		if (++m_headlessFrames < m_headless.frameCount) return;
+
+		spdlog::info("Engine: Headless run finished after {} frames", m_headlessFrames);
+		m_closeRequested = true;
+		m_window.requestWindowClose();
+	}
+
+	bool Engine::beginReplayFrame(double& frameTime)
+	{
+		if (!m_replayer) return true;
+
+		if (!m_replayer->nextFrame())
+		{
+			spdlog::info("Engine: Replay finished after {} frames", m_replayer->getFramesRead());
+			m_closeRequested = true;
+			return false;
+		}
+
+		frameTime = m_replayer->getFrame().frameTime;
+		m_replayer->beginFrame(SceneManager::getActiveScene());
+		m_replayer->pushEvents(*m_inputEvents);
+		return true;
 	}
 
 	void Engine::setupInputCallbacks()
 	{
-		m_window.setKeyCallback([this](IxKey key, int scacode, KeyAction action, int mods) {
+		// Dispatched by InputState on the simulating thread
+		m_input.setKeyCallback([this](IxKey key, int scacode, KeyAction action, int mods) {
 			if (key == IxKey::LEFT_ALT && action == KeyAction::PRESS) 
 			{
 				toggleCursorLock();
@@ -134,25 +367,33 @@ namespace ix
 
 	void Engine::processInput()
 	{
-		if (m_window.isKeyPressed(IxKey::ESCAPE))
+		if (m_input.isKeyPressed(IxKey::ESCAPE))
 		{
-			m_window.requestWindowClose();
+			// The window is closed from the main thread
+			m_closeRequested = true;
 		}
 	}
 
 	void Engine::toggleCursorLock()
 	{
 		m_cursorLocked = !m_cursorLocked;
-		m_window.lockCursor(m_cursorLocked);
+		m_input.lockCursor(m_cursorLocked);
 	}
 
 	void Engine::shutdown()
 	{
 		if (m_renderer) m_renderer->waitIdle(); // wait for gpu to finish work
+		m_recorder.reset(); // Finishes the capture file
 		m_layers.clear();
 		SceneManager::shutdown();
 		AssetManager::get().clearAssetCache();
 		if (m_renderer)	m_renderer->shutdown();
+		if (m_frameStats)
+		{
+			m_frameStats->flush();
+			m_frameStats->setJobSystem(nullptr);
+		}
+		m_jobSystem.reset();
 		s_instance = nullptr;
 	}
 	
@@ -3,23 +3,53 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <thread>
 
 #include "renderer_i.h"
 #include "window_i.h"
 #include "core/asset_manager.h"
+#include "core/job_system.h"
+#include "core/frame_stats.h"
 
 namespace ix 
 {
 	class Input_I;
 	class Layer_I;
 	class GlfwPlatform;
+	class HeadlessPlatform;
+	class InputEventQueue;
+	class InputState;
+	class SnapshotExchange;
+	class FrameRecorder;
+	class FrameReplayer;
+	struct RenderSnapshot;
 
 
+	struct HeadlessSpecification
+	{
+		bool enabled = false;     // Offscreen back buffer, no window, surface or present queue
+		uint32_t frameCount = 300; // Frames rendered before run() returns
+		std::string capturePath;  // PNG of the last frame, empty to skip the readback
+	};
+
+	struct ReplaySpecification
+	{
+		std::string recordPath; // Capture of every frame's view, input and transform changes, empty to skip
+		std::string replayPath; // Drives the game from a capture instead of the window and the clock
+	};
+
 	struct EngineSpecification
 	{
 		std::string name = "Imaginatrix Engine";
 		WindowSpecification windowSpec;
 		RendererAPI api = RendererAPI::Vulkan;
+		uint32_t workerThreadCount = JobSystemSpecification::AUTO_WORKER_COUNT; // 0 runs every job on the main thread
+		bool pinWorkerThreads = false;
+		bool pipelinedRendering = false; // Simulate frame N+1 on a game thread while the main thread renders frame N
+		FrameStatsSpecification frameStats;
+		HeadlessSpecification headless;
+		ReplaySpecification replay;
 	};
 
 	class Engine
@@ -39,10 +69,12 @@ namespace ix
 
 		static Engine& get() { return *s_instance; }
 		static AssetManager& getAssetManager() { return AssetManager::get(); }
+		JobSystem& getJobSystem() { return *m_jobSystem; }
 		Renderer_I& getRenderer() { return *m_renderer; }
 		Input_I& getInput() { return m_input; }
 		Window_I& getWindow() { return m_window; }
 		float getFPS() const { return m_lastFrameFPS; }
+		FrameStats& getFrameStats() { return *m_frameStats; }
 
 		void setupInputCallbacks();
 		void processInput();
@@ -50,15 +82,59 @@ namespace ix
 
 	private:
 		void shutdown();
+
+		void runSerial();
+		void runPipelined();
+		void gameThreadLoop();
+
+		// Fixed steps and the variable update, returns the interpolation alpha
+		float simulate(double frameTime, double& accumulator);
+		// Game thread side: copies everything the render thread needs out of the ECS
+		void extractFrame(RenderSnapshot& snapshot, double frameTime, float alpha);
+		// Render thread side: only reads the snapshot
+		void renderFrame(const RenderSnapshot& snapshot);
+		void updateViewportExtent();
+		void updateFPS(double frameTime);
+		// Render thread, once per rendered frame with the unclamped frame time
+		void updateFrameStats(double frameTime);
+		// Closes the window once a headless run has rendered its frames
+		void countHeadlessFrame();
+		// Game thread, before the input is processed. Swaps in the capture's frame time and input,
+		// false once the replay ran out
+		bool beginReplayFrame(double& frameTime);
+
 		static Engine* s_instance;
+		std::unique_ptr<JobSystem> m_jobSystem; // Created first, shutdown() destroys it after everything that schedules jobs
 		std::vector<std::shared_ptr<Layer_I>> m_layers;
 		std::unique_ptr<GlfwPlatform> m_platform;
+		std::unique_ptr<HeadlessPlatform> m_headlessPlatform; // Only one of the two exists
+		std::unique_ptr<InputEventQueue> m_inputEvents;
+		std::unique_ptr<InputState> m_inputState;
 		std::unique_ptr<Renderer_I> m_renderer;
 		Window_I& m_window;
-		Input_I& m_input;
+		Input_I& m_input; // Event-driven state, consistent for a whole simulation step
+
+		bool m_pipelined = false;
+		std::unique_ptr<SnapshotExchange> m_snapshots;
+		std::thread m_gameThread;
+		std::atomic<bool> m_closeRequested{ false };
+
+		HeadlessSpecification m_headless;
+		uint32_t m_headlessFrames = 0; // Render thread
+
+		// Game thread, at most one of the two exists
+		std::unique_ptr<FrameRecorder> m_recorder;
+		std::unique_ptr<FrameReplayer> m_replayer;
+
+		// Written by the render thread after each frame, read by the game thread for the camera aspect
+		std::atomic<uint32_t> m_viewportWidth{ 1 };
+		std::atomic<uint32_t> m_viewportHeight{ 1 };
+		double m_totalTime = 0.0;
 
 		bool m_cursorLocked = true;
 
+		std::unique_ptr<FrameStats> m_frameStats;
+
 		float  m_lastFrameFPS = 0.0f;
 		float  m_smoothedFPS = 0.0f; // High-frequency average
 		double m_fpsTimer = 0.0;
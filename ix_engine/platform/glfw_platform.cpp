@@ -1,6 +1,7 @@
 // glfw_platform.cpp
 #include "common/engine_pch.h"
 #include "glfw_platform.h"
+#include "core/input_state.h"
 
 
 namespace ix
@@ -98,6 +99,7 @@ namespace ix
         glfwSetFramebufferSizeCallback(m_window, framebufferResizeCallback);
         glfwSetCursorPosCallback(m_window, cursorPosCallback);
         glfwSetKeyCallback(m_window, keyCallback);
+        glfwSetMouseButtonCallback(m_window, mouseButtonCallback);
 
         if (glfwRawMouseMotionSupported()) {
             glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
@@ -184,6 +186,14 @@ namespace ix
             lock ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL
         );
         m_firstMouse = true;
+
+        if (m_eventQueue)
+        {
+            InputEvent event;
+            event.type = InputEvent::Type::CursorLock;
+            event.locked = lock;
+            m_eventQueue->push(event);
+        }
     }
 
     bool GlfwPlatform::isKeyPressed(IxKey key) const
@@ -234,8 +244,19 @@ namespace ix
             return;
         }
 
-        self->m_accumDX += (x - self->m_lastX);
-        self->m_accumDY += (y - self->m_lastY);
+        if (self->m_eventQueue)
+        {
+            InputEvent event;
+            event.type = InputEvent::Type::MouseMove;
+            event.dx = x - self->m_lastX;
+            event.dy = y - self->m_lastY;
+            self->m_eventQueue->push(event);
+        }
+        else
+        {
+            self->m_accumDX += (x - self->m_lastX);
+            self->m_accumDY += (y - self->m_lastY);
+        }
 
         self->m_lastX = x;
         self->m_lastY = y;
@@ -250,6 +271,17 @@ namespace ix
         if (action == GLFW_PRESS) self->m_keyStates.set(key);
         else if (action == GLFW_RELEASE) self->m_keyStates.reset(key);
 
+        if (self->m_eventQueue)
+        {
+            InputEvent event;
+            event.type = InputEvent::Type::Key;
+            event.code = static_cast<int>(self->fromGlfwKey(key));
+            event.scancode = scancode;
+            event.mods = mods;
+            event.action = self->translateAction(action);
+            self->m_eventQueue->push(event);
+        }
+
         // Dispatch to engine callback
         if (self->m_keyCallback) {
             IxKey ixKey = self->fromGlfwKey(key);
@@ -257,4 +289,17 @@ namespace ix
             self->m_keyCallback(ixKey, scancode, keyAction, mods);
         }
     }
+
+    void GlfwPlatform::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+    {
+        auto* self = static_cast<GlfwPlatform*>(glfwGetWindowUserPointer(window));
+        if (!self || !self->m_eventQueue) return;
+
+        InputEvent event;
+        event.type = InputEvent::Type::MouseButton;
+        event.code = button;
+        event.mods = mods;
+        event.action = self->translateAction(action);
+        self->m_eventQueue->push(event);
+    }
 }
\ No newline at end of file
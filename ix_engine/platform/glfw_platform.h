@@ -10,6 +10,7 @@
 
 namespace ix
 {
+    class InputEventQueue;
 
     class GlfwPlatform : public Window_I, public Input_I
     {
@@ -41,7 +42,9 @@ namespace ix
         bool isMouseButtonPressed(int button) const override;
         void consumeMouseDelta(double& dx, double& dy) override;
         void setKeyCallback(IxKeyCallback callback) override;
- 
+
+        // Forward input to another thread. Callbacks still run on the main thread
+        void setInputEventQueue(InputEventQueue* queue) { m_eventQueue = queue; }
 
     private:
         void initGLFW(const WindowSpecification& spec, const std::string& title);
@@ -53,6 +56,7 @@ namespace ix
         static void framebufferResizeCallback(GLFWwindow* window, int w, int h);
         static void cursorPosCallback(GLFWwindow* window, double x, double y);
         static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+        static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 
     private:
         // Window
@@ -72,6 +76,7 @@ namespace ix
         bool m_firstMouse = true;
 
         IxKeyCallback m_keyCallback;
+        InputEventQueue* m_eventQueue = nullptr;
     };
 
 }
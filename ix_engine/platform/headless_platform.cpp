@@ -0,0 +1,22 @@
+// headless_platform.cpp
+#include "common/engine_pch.h"
+#include "headless_platform.h"
+
+namespace ix
+{
+    HeadlessPlatform::HeadlessPlatform(const WindowSpecification& spec)
+        : m_width(spec.width)
+        , m_height(spec.height)
+    {
+        if (spec.mode != WindowMode::Windowed)
+        {
+            spdlog::warn("HeadlessPlatform: Fullscreen modes need a monitor, rendering {}x{} offscreen", m_width, m_height);
+        }
+    }
+
+    void HeadlessPlatform::getFramebufferSize(int& width, int& height) const
+    {
+        width = static_cast<int>(m_width);
+        height = static_cast<int>(m_height);
+    }
+}
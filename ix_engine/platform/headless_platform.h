@@ -0,0 +1,45 @@
+// headless_platform.h
+#pragma once
+#include <atomic>
+
+#include "window_i.h"
+
+namespace ix
+{
+    // Window without a window: a fixed framebuffer size and a close flag, so the engine and renderer
+    // run unchanged on machines without a display (CI, software Vulkan drivers)
+    class HeadlessPlatform : public Window_I
+    {
+    public:
+        explicit HeadlessPlatform(const WindowSpecification& spec);
+
+        void pollEvents() override {}
+        void waitEvents() override {}
+        bool isWindowShouldClose() const override { return m_shouldClose; }
+        void requestWindowClose() override { m_shouldClose = true; }
+        void getFramebufferSize(int& width, int& height) const override;
+
+        bool wasWindowResized() const override { return false; }
+        void resetWindowResizedFlag() override {}
+        void setWindowResizedFlag(bool wasResized) override {}
+
+        void setUserPointer(void* ptr) override { m_userPointer = ptr; }
+        void* getWindowUserPointer() const override { return m_userPointer; }
+        void* getNativeHandle() const override { return nullptr; }
+        bool isHeadless() const override { return true; }
+
+        // No input, every query reports nothing pressed
+        void lockCursor(bool lock) override {}
+        bool isCursorLocked() const override { return false; }
+        bool isKeyPressed(IxKey key) const override { return false; }
+        bool isMouseButtonPressed(int button) const override { return false; }
+        void consumeMouseDelta(double& dx, double& dy) override { dx = 0.0; dy = 0.0; }
+        void setKeyCallback(IxKeyCallback callback) override {}
+
+    private:
+        uint32_t m_width;
+        uint32_t m_height;
+        std::atomic<bool> m_shouldClose{ false };
+        void* m_userPointer = nullptr;
+    };
+}
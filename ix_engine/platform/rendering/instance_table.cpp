@@ -0,0 +1,378 @@
+// instance_table.cpp
+#include "common/engine_pch.h"
+#include "instance_table.h"
+#include "core/scene.h"
+#include "core/components.h"
+#include "core/asset_manager.h"
+
+namespace ix
+{
+    namespace
+    {
+        constexpr uint32_t MIN_BATCH_CAPACITY = 16;
+        // Relocated batches leave their old range behind; compact once those make up a quarter of the table
+        constexpr uint32_t COMPACTION_DIVISOR = 4;
+        constexpr uint32_t COMPACTION_MIN_SLOTS = 256; // Small tables aren't worth a full re-upload
+    }
+
+    InstanceTable::InstanceTable(uint32_t maxInstances, uint32_t maxBatches)
+        : m_maxInstances(maxInstances), m_maxBatches(maxBatches)
+    {
+    }
+
+    void InstanceTable::clear()
+    {
+        m_sceneId = 0;
+        m_liveCount = 0;
+        m_orphanedSlots = 0;
+        m_batches.clear();
+        m_renderBatches.clear();
+        m_instances.clear();
+        m_slotEntities.clear();
+        m_entitySlots.clear();
+        m_dirtySlots.clear();
+        m_dirtyFlags.clear();
+        m_fullUpload = true;
+    }
+
+    uint32_t InstanceTable::getSlot(entt::entity entity) const
+    {
+        const uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+        if (index >= m_entitySlots.size()) return INVALID_SLOT;
+
+        const uint32_t slot = m_entitySlots[index];
+        if (slot == INVALID_SLOT || m_slotEntities[slot] != entity) return INVALID_SLOT;
+        return slot;
+    }
+
+    void InstanceTable::sync(Scene& scene)
+    {
+        auto& registry = scene.getRegistry();
+        auto& changes = scene.getRenderableChanges();
+
+        if (scene.getId() != m_sceneId)
+        {
+            rebuild(scene);
+            changes.added.clear();
+            changes.removed.clear();
+            return;
+        }
+
+        // Structural changes: removals first so recycled entity indices resolve correctly
+        for (entt::entity entity : changes.removed) removeInstance(entity);
+
+        bool outOfSpace = false;
+        for (entt::entity entity : changes.added)
+        {
+            if (!addInstance(registry, entity))
+            {
+                outOfSpace = true;
+                break;
+            }
+        }
+        changes.added.clear();
+        changes.removed.clear();
+
+        // Ranges are full, or churn orphaned enough of the table that culling walks mostly holes
+        const bool fragmented = getSlotCount() >= COMPACTION_MIN_SLOTS && m_orphanedSlots * COMPACTION_DIVISOR > getSlotCount();
+        if (outOfSpace || fragmented)
+        {
+            rebuild(scene);
+            return;
+        }
+
+        // Moved objects
+        for (entt::entity entity : scene.getChangedTransforms()) updateTransform(registry, entity);
+
+        refreshRenderBatches();
+    }
+
+    void InstanceTable::rebuild(Scene& scene)
+    {
+        clear();
+        m_sceneId = scene.getId();
+
+        auto& registry = scene.getRegistry();
+        auto view = registry.view<MeshComponent, WorldTransformComponent, TransformComponent>();
+
+        std::vector<std::pair<MeshHandle, entt::entity>> entries;
+        for (auto [entity, mesh, world, transform] : view.each())
+        {
+            entries.emplace_back(mesh.meshHandle, entity);
+        }
+        std::sort(entries.begin(), entries.end());
+
+        uint32_t runCount = 0;
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (i == 0 || entries[i].first != entries[i - 1].first) runCount++;
+        }
+
+        // Leave some headroom per batch when it fits, so creation rarely has to relocate a range
+        const size_t padded = entries.size() + entries.size() / 4 + size_t(runCount) * 8;
+        const bool headroom = padded <= m_maxInstances;
+
+        size_t i = 0;
+        uint32_t dropped = 0;
+        while (i < entries.size())
+        {
+            const MeshHandle mesh = entries[i].first;
+            size_t runEnd = i;
+            while (runEnd < entries.size() && entries[runEnd].first == mesh) runEnd++;
+            const uint32_t runSize = static_cast<uint32_t>(runEnd - i);
+
+            const uint32_t first = static_cast<uint32_t>(m_instances.size());
+            const uint32_t remaining = m_maxInstances - first;
+            uint32_t capacity = headroom ? runSize + runSize / 4 + 8 : runSize;
+            capacity = std::min(capacity, remaining);
+
+            if (m_batches.size() >= m_maxBatches || capacity == 0)
+            {
+                dropped += static_cast<uint32_t>(entries.size() - i);
+                break;
+            }
+
+            BatchRange batch;
+            batch.meshHandle = mesh;
+            batch.first = first;
+            batch.capacity = capacity;
+            m_batches.push_back(batch);
+
+            const uint32_t batchIndex = static_cast<uint32_t>(m_batches.size() - 1);
+            m_instances.resize(first + capacity);
+            m_slotEntities.resize(first + capacity, entt::null);
+            m_dirtyFlags.resize(first + capacity, 0);
+            for (uint32_t slot = first; slot < first + capacity; slot++) m_instances[slot].batchID = INVALID_BATCH;
+
+            for (size_t e = i; e < runEnd; e++)
+            {
+                BatchRange& range = m_batches[batchIndex];
+                if (range.count == range.capacity)
+                {
+                    dropped++;
+                    continue;
+                }
+
+                const uint32_t slot = range.first + range.count++;
+                const entt::entity entity = entries[e].second;
+
+                fillInstance(registry, entity, m_instances[slot]);
+                m_instances[slot].batchID = batchIndex;
+                m_slotEntities[slot] = entity;
+
+                const uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+                if (index >= m_entitySlots.size()) m_entitySlots.resize(index + 1, INVALID_SLOT);
+                m_entitySlots[index] = slot;
+                m_liveCount++;
+            }
+
+            i = runEnd;
+        }
+
+        if (dropped > 0)
+        {
+            spdlog::error("InstanceTable: {} instances dropped (limits: {} instances, {} batches)",
+                dropped, m_maxInstances, m_maxBatches);
+        }
+
+        m_fullUpload = true;
+        refreshRenderBatches();
+    }
+
+    bool InstanceTable::addInstance(entt::registry& registry, entt::entity entity)
+    {
+        // Stale or incomplete entities are not renderable (yet)
+        if (!registry.valid(entity) || !registry.all_of<MeshComponent, WorldTransformComponent, TransformComponent>(entity)) return true;
+        if (getSlot(entity) != INVALID_SLOT) return true;
+
+        const MeshHandle mesh = registry.get<MeshComponent>(entity).meshHandle;
+        const uint32_t batchIndex = findOrCreateBatch(mesh);
+        if (batchIndex == INVALID_BATCH) return false;
+
+        if (m_batches[batchIndex].count == m_batches[batchIndex].capacity && !growBatch(batchIndex)) return false;
+
+        BatchRange& batch = m_batches[batchIndex];
+        const uint32_t slot = batch.first + batch.count++;
+
+        fillInstance(registry, entity, m_instances[slot]);
+        m_instances[slot].batchID = batchIndex;
+        m_slotEntities[slot] = entity;
+
+        const uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+        if (index >= m_entitySlots.size()) m_entitySlots.resize(index + 1, INVALID_SLOT);
+        m_entitySlots[index] = slot;
+
+        m_liveCount++;
+        markDirty(slot);
+        return true;
+    }
+
+    void InstanceTable::removeInstance(entt::entity entity)
+    {
+        const uint32_t slot = getSlot(entity);
+        if (slot == INVALID_SLOT) return;
+
+        BatchRange& batch = m_batches[m_instances[slot].batchID];
+        const uint32_t last = batch.first + batch.count - 1;
+
+        // Swap-remove: the last instance of the batch fills the hole
+        if (slot != last) moveSlot(last, slot);
+        releaseSlot(last);
+        batch.count--;
+
+        m_entitySlots[static_cast<uint32_t>(entt::to_entity(entity))] = INVALID_SLOT;
+        m_liveCount--;
+    }
+
+    void InstanceTable::updateTransform(entt::registry& registry, entt::entity entity)
+    {
+        const uint32_t slot = getSlot(entity);
+        if (slot == INVALID_SLOT) return;
+
+        GPUInstanceData& data = m_instances[slot];
+        const uint32_t batchID = data.batchID;
+        fillInstance(registry, entity, data);
+        data.batchID = batchID;
+        markDirty(slot);
+    }
+
+    uint32_t InstanceTable::findOrCreateBatch(MeshHandle mesh)
+    {
+        uint32_t emptyBatch = INVALID_BATCH;
+        for (uint32_t i = 0; i < m_batches.size(); i++)
+        {
+            if (m_batches[i].meshHandle == mesh) return i;
+            if (m_batches[i].count == 0 && emptyBatch == INVALID_BATCH) emptyBatch = i;
+        }
+
+        // Recycle a drained batch (and its range) before opening a new one
+        if (emptyBatch != INVALID_BATCH)
+        {
+            m_batches[emptyBatch].meshHandle = mesh;
+            return emptyBatch;
+        }
+
+        if (m_batches.size() >= m_maxBatches) return INVALID_BATCH;
+
+        BatchRange batch;
+        batch.meshHandle = mesh;
+        batch.first = static_cast<uint32_t>(m_instances.size());
+        batch.capacity = 0;
+        m_batches.push_back(batch);
+        return static_cast<uint32_t>(m_batches.size() - 1);
+    }
+
+    bool InstanceTable::growBatch(uint32_t batchIndex)
+    {
+        BatchRange& batch = m_batches[batchIndex];
+        const uint32_t tail = static_cast<uint32_t>(m_instances.size());
+        const bool atTail = (batch.first + batch.capacity == tail);
+
+        // The range either grows in place (tail batch) or moves to the end of the table
+        const uint32_t newFirst = atTail ? batch.first : tail;
+        uint32_t newCapacity = std::max(batch.capacity * 2, MIN_BATCH_CAPACITY);
+        newCapacity = std::min(newCapacity, m_maxInstances - newFirst);
+        if (newCapacity <= batch.count) return false;
+
+        const uint32_t newEnd = newFirst + newCapacity;
+        GPUInstanceData hole{};
+        hole.batchID = INVALID_BATCH;
+        m_instances.resize(newEnd, hole);
+        m_slotEntities.resize(newEnd, entt::null);
+        m_dirtyFlags.resize(newEnd, 0);
+
+        if (!atTail)
+        {
+            for (uint32_t i = 0; i < batch.count; i++)
+            {
+                moveSlot(batch.first + i, newFirst + i);
+                releaseSlot(batch.first + i);
+            }
+            m_orphanedSlots += batch.capacity;
+            batch.first = newFirst;
+        }
+        batch.capacity = newCapacity;
+        return true;
+    }
+
+    void InstanceTable::moveSlot(uint32_t from, uint32_t to)
+    {
+        const entt::entity entity = m_slotEntities[from];
+        m_instances[to] = m_instances[from];
+        m_slotEntities[to] = entity;
+        m_entitySlots[static_cast<uint32_t>(entt::to_entity(entity))] = to;
+        markDirty(to);
+    }
+
+    void InstanceTable::releaseSlot(uint32_t slot)
+    {
+        m_instances[slot] = GPUInstanceData{};
+        m_instances[slot].batchID = INVALID_BATCH;
+        m_slotEntities[slot] = entt::null;
+        markDirty(slot);
+    }
+
+    void InstanceTable::markDirty(uint32_t slot)
+    {
+        if (m_fullUpload || m_dirtyFlags[slot]) return;
+        m_dirtyFlags[slot] = 1;
+        m_dirtySlots.push_back(slot);
+    }
+
+    void InstanceTable::clearDirty()
+    {
+        for (uint32_t slot : m_dirtySlots) m_dirtyFlags[slot] = 0;
+        m_dirtySlots.clear();
+        m_fullUpload = false;
+    }
+
+    void InstanceTable::gatherChanges(RenderSnapshot& snapshot)
+    {
+        snapshot.instanceSlotCount = getSlotCount();
+        snapshot.batches = m_renderBatches;
+        snapshot.fullInstanceUpload = m_fullUpload;
+        snapshot.instanceSlots.clear();
+        snapshot.instanceData.clear();
+
+        if (m_fullUpload)
+        {
+            snapshot.instanceData.assign(m_instances.begin(), m_instances.end());
+        }
+        else
+        {
+            snapshot.instanceSlots.reserve(m_dirtySlots.size());
+            snapshot.instanceData.reserve(m_dirtySlots.size());
+            for (uint32_t slot : m_dirtySlots)
+            {
+                snapshot.instanceSlots.push_back(slot);
+                snapshot.instanceData.push_back(m_instances[slot]);
+            }
+        }
+        clearDirty();
+    }
+
+    void InstanceTable::refreshRenderBatches()
+    {
+        m_renderBatches.resize(m_batches.size());
+        for (size_t i = 0; i < m_batches.size(); i++)
+        {
+            m_renderBatches[i].meshHandle = m_batches[i].meshHandle;
+            m_renderBatches[i].instanceCount = m_batches[i].count;
+            m_renderBatches[i].firstInstance = m_batches[i].first;
+        }
+    }
+
+    void InstanceTable::fillInstance(entt::registry& registry, entt::entity entity, GPUInstanceData& data) const
+    {
+        const auto& mesh = registry.get<MeshComponent>(entity);
+        const auto& world = registry.get<WorldTransformComponent>(entity);
+        const auto& transform = registry.get<TransformComponent>(entity);
+
+        std::copy(std::begin(world.rows), std::end(world.rows), std::begin(data.modelRows));
+        data.textureIndex = AssetManager::get().getTextureBindlessIndex(mesh.textureHandle);
+
+        float baseRadius = AssetManager::get().getMeshBoundingRadius(mesh.meshHandle);
+        float maxScale = std::max({ transform.scale.x, transform.scale.y, transform.scale.z });
+        data.boundingRadius = baseRadius * maxScale;
+    }
+}
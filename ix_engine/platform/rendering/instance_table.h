@@ -0,0 +1,87 @@
+// instance_table.h
+#pragma once
+#include <entt/entt.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "global_common/ix_global_pods.h"
+#include "common/handles.h"
+
+namespace ix
+{
+    class Scene;
+
+    // CPU mirror of the GPU instance database.
+    // Each mesh batch owns a slot range [first, first + capacity); live instances are packed at the
+    // front of the range. Creation appends, destruction swap-removes, so entity slots stay stable
+    // and per-frame work only depends on what changed. A full batch that isn't at the tail moves there,
+    // and the table compacts once the ranges left behind waste too much of it.
+    class InstanceTable
+    {
+    public:
+        static constexpr uint32_t INVALID_SLOT = ~0u;
+        static constexpr uint32_t INVALID_BATCH = ~0u; // batchID of unused slots, skipped by culling
+
+        InstanceTable(uint32_t maxInstances, uint32_t maxBatches);
+
+        // Applies structural and transform changes of the scene. Rebuilds from scratch on a scene switch
+        void sync(Scene& scene);
+        void clear();
+
+        const std::vector<GPUInstanceData>& getInstances() const { return m_instances; }
+        const std::vector<RenderBatch>& getBatches() const { return m_renderBatches; }
+
+        // Number of slots the culling pass has to walk (high water mark, holes included)
+        uint32_t getSlotCount() const { return static_cast<uint32_t>(m_instances.size()); }
+        uint32_t getLiveCount() const { return m_liveCount; }
+        // Slots in ranges no batch owns anymore, reclaimed by the next compaction
+        uint32_t getOrphanedSlotCount() const { return m_orphanedSlots; }
+        uint32_t getSlot(entt::entity entity) const;
+
+        // Upload tracking
+        bool needsFullUpload() const { return m_fullUpload; }
+        const std::vector<uint32_t>& getDirtySlots() const { return m_dirtySlots; }
+        void clearDirty();
+        // Moves the layout and the slots changed since the last gather into the snapshot, then clears them
+        void gatherChanges(RenderSnapshot& snapshot);
+
+    private:
+        struct BatchRange
+        {
+            MeshHandle meshHandle = 0;
+            uint32_t first = 0;
+            uint32_t count = 0;
+            uint32_t capacity = 0;
+        };
+
+        void rebuild(Scene& scene);
+        bool addInstance(entt::registry& registry, entt::entity entity);
+        void removeInstance(entt::entity entity);
+        void updateTransform(entt::registry& registry, entt::entity entity);
+
+        uint32_t findOrCreateBatch(MeshHandle mesh);
+        bool growBatch(uint32_t batchIndex);
+        void moveSlot(uint32_t from, uint32_t to);
+        void releaseSlot(uint32_t slot);
+        void markDirty(uint32_t slot);
+        void refreshRenderBatches();
+
+        void fillInstance(entt::registry& registry, entt::entity entity, GPUInstanceData& data) const;
+
+        uint32_t m_maxInstances;
+        uint32_t m_maxBatches;
+        uint64_t m_sceneId = 0;
+        uint32_t m_liveCount = 0;
+        uint32_t m_orphanedSlots = 0;
+
+        std::vector<BatchRange> m_batches;
+        std::vector<RenderBatch> m_renderBatches;
+        std::vector<GPUInstanceData> m_instances; // Slot indexed
+        std::vector<entt::entity> m_slotEntities; // Slot -> entity
+        std::vector<uint32_t> m_entitySlots;      // Entity index -> slot
+
+        std::vector<uint32_t> m_dirtySlots;
+        std::vector<uint8_t> m_dirtyFlags;
+        bool m_fullUpload = true;
+    };
+}
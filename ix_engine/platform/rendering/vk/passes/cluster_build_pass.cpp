@@ -13,7 +13,8 @@ namespace ix
 
     void ClusterBuildPass::setup(RenderGraphBuilder& builder)
     {
-        builder.write("ClusterAABBbuffer");
+        builder.write("ClusterAABBbuffer", ResourceUsage::Storage);
+        builder.useAsyncCompute();
         m_cachedPipeline = builder.getPipelineManager()->getComputePipeline("ClusterBuild");
     }
 
@@ -14,39 +14,87 @@ namespace ix
     void ClusterCullingPass::setup(RenderGraphBuilder& builder)
     {
         // Inputs
-        builder.read("ClusterAABBbuffer");
+        builder.read("ClusterAABBbuffer", ResourceUsage::Storage);
 
         // Outputs
-        builder.write("LightGridBuffer");
-        builder.write("LightIndexBuffer");
-        builder.write("AtomicCounter");
+        builder.write("LightGridBuffer", ResourceUsage::Storage);
+        builder.write("LightIndexBuffer", ResourceUsage::Storage);
+        builder.write("AtomicCounter", ResourceUsage::Storage | ResourceUsage::TransferDst); // Reset in the pass
+
+        // Only Forward consumes the light lists, so culling overlaps the depth pre-pass
+        builder.useAsyncCompute();
 
         m_cachedPipeline = builder.getPipelineManager()->getComputePipeline("ClusterCulling");
     }
 
+    // The light half of GPUCullingStats, written on whichever queue this pass runs
+    static constexpr VkDeviceSize STATS_OFFSET = offsetof(GPUCullingStats, maxLightsPerCluster);
+    static constexpr VkDeviceSize STATS_SIZE = sizeof(GPUCullingStats) - STATS_OFFSET;
+
     void ClusterCullingPass::execute(const RenderState& state, RenderGraphRegistry& registry)
     {
         VkCommandBuffer cmd = state.frame.commandBuffer;
 
-        // Reset Atomic Counter to 0
+        // The previous frame's copy has to be done reading the counters before they are reset
+        VkBufferMemoryBarrier statsBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        statsBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        statsBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        statsBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        statsBarrier.buffer = state.frame.cullingStatsBuffer;
+        statsBarrier.offset = STATS_OFFSET;
+        statsBarrier.size = STATS_SIZE;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 1, &statsBarrier, 0, nullptr);
+
+        // Reset Atomic Counter and statistics to 0
         uint32_t zero = 0;
         vkCmdUpdateBuffer(cmd, state.frame.atomicCounterBuffer, 0, sizeof(uint32_t), &zero);
+        vkCmdFillBuffer(cmd, state.frame.cullingStatsBuffer, STATS_OFFSET, STATS_SIZE, 0);
 
         // Barrier: Transfer -> Compute
         // Ensure the reset is finished before the shader tries to increment it
-        VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-        barrier.buffer = state.frame.atomicCounterBuffer;
-        barrier.size = VK_WHOLE_SIZE;
+        VkBufferMemoryBarrier barriers[2]{};
+        barriers[0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barriers[0].buffer = state.frame.atomicCounterBuffer;
+        barriers[0].size = VK_WHOLE_SIZE;
+
+        statsBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barriers[1] = statsBarrier;
 
         vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            0, 0, nullptr, 1, &barrier, 0, nullptr);
+            0, 0, nullptr, 2, barriers, 0, nullptr);
 
         // Dispatch Culling Shader
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cachedPipeline->getHandle());
 
+        // Every pass records into its own command buffer, nothing bound by an earlier pass carries over
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cachedPipeline->getLayout(), 0, 1, &state.frame.globalDescriptorSet, 0, nullptr);
+
         // Grid: 16x9x24
         vkCmdDispatch(cmd, 16, 9, 24);
+
+        // Into this frame's readback slot, next to the frustum half
+        statsBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 1, &statsBarrier, 0, nullptr);
+
+        VkBufferCopy region{ STATS_OFFSET, state.frame.cullingStatsReadbackOffset + STATS_OFFSET, STATS_SIZE };
+        vkCmdCopyBuffer(cmd, state.frame.cullingStatsBuffer, state.frame.cullingStatsReadback, 1, &region);
+
+        VkBufferMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = state.frame.cullingStatsReadback;
+        hostBarrier.offset = region.dstOffset;
+        hostBarrier.size = STATS_SIZE;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
     }
 }
\ No newline at end of file
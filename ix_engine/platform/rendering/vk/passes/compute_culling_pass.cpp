@@ -14,18 +14,38 @@ namespace ix
     void ComputeCullingPass::setup(RenderGraphBuilder& builder) 
     {
   
-        builder.read("InstanceDb"); // Read from the full database
+        builder.read("InstanceDb", ResourceUsage::Storage); // Read from the full database
 
-        builder.write("CulledInstances"); // Write to the filtered list
+        builder.write("CulledInstances", ResourceUsage::Storage); // Write to the filtered list
 
         m_cachedPipeline = builder.getPipelineManager()->getComputePipeline("FrustumCull");
     }
 
+    // The frustum half of GPUCullingStats, the cluster culling pass owns the rest
+    static constexpr VkDeviceSize STATS_SIZE = offsetof(GPUCullingStats, maxLightsPerCluster);
+
     void ComputeCullingPass::execute(const RenderState& state, RenderGraphRegistry& registry)
     {
         VkCommandBuffer cmd = state.frame.commandBuffer;
 
-        VulkanBuffer* culledOut = registry.getBuffer("CulledInstances");
+        // Reset the counters, after the previous frame's copy has read them
+        VkBufferMemoryBarrier statsBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        statsBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        statsBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        statsBarrier.buffer = state.frame.cullingStatsBuffer;
+        statsBarrier.offset = 0;
+        statsBarrier.size = STATS_SIZE;
+
+        statsBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 1, &statsBarrier, 0, nullptr);
+        vkCmdFillBuffer(cmd, state.frame.cullingStatsBuffer, 0, STATS_SIZE, 0);
+
+        statsBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 0, nullptr, 1, &statsBarrier, 0, nullptr);
 
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cachedPipeline->getHandle());
 
@@ -57,17 +77,24 @@ namespace ix
         uint32_t groupCount = (state.frame.instanceCount + 63) / 64;
         vkCmdDispatch(cmd, groupCount, 1, 1);
 
-        // Barrier
-        VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
-        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
-        barrier.buffer = culledOut->getBuffer();
-        barrier.offset = 0;
-        barrier.size = VK_WHOLE_SIZE;
-
-        vkCmdPipelineBarrier(cmd,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
-            0, 0, nullptr, 1, &barrier, 0, nullptr);
+        // Into this frame's readback slot, the renderer reads it once the slot comes around again
+        statsBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        statsBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 1, &statsBarrier, 0, nullptr);
+
+        VkBufferCopy region{ 0, state.frame.cullingStatsReadbackOffset, STATS_SIZE };
+        vkCmdCopyBuffer(cmd, state.frame.cullingStatsBuffer, state.frame.cullingStatsReadback, 1, &region);
+
+        VkBufferMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = state.frame.cullingStatsReadback;
+        hostBarrier.offset = region.dstOffset;
+        hostBarrier.size = STATS_SIZE;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
     }
 }
\ No newline at end of file
@@ -21,7 +21,12 @@ namespace ix
 
     void DepthPrePass::setup(RenderGraphBuilder& builder)
     {
-        builder.write("DepthBuffer");
+        builder.createImage("DepthBuffer", { builder.getContext()->getDepthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT });
+        RGResourceview depthBuffer = builder.write("DepthBuffer", ResourceUsage::DepthAttachment);
+        VkClearValue clearDepth{};
+        clearDepth.depthStencil = { 1.0f, 0 };
+        builder.setClearValue(depthBuffer, clearDepth);
+        m_culledInstances = builder.read("CulledInstances", ResourceUsage::IndirectArgs | ResourceUsage::Storage);
         m_cachedPipeline = builder.getPipelineManager()->getGraphicsPipeline("DepthPrePass");
     }
 
@@ -29,35 +34,9 @@ namespace ix
     {
         if (!m_cachedPipeline || state.frame.instanceCount == 0) return;
 
+        // The graph began depth-only rendering with the viewport set
         VkCommandBuffer cmd = state.frame.commandBuffer;
-        auto& depthState = registry.getResourceState("DepthBuffer");
-        VulkanImage* depthImage = depthState.physicalImage;
-        VulkanBuffer* culledBuffer = registry.getBuffer("CulledInstances");
-
-        VkExtent2D extent = depthImage->getExtent();
-
-        // Setup Depth-Only Rendering
-        VkRenderingAttachmentInfo depthAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
-        depthAttachment.imageView = depthImage->getView();
-        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
-        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear to 1.0
-        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
-
-        VkRenderingInfo renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO };
-        renderingInfo.renderArea = { {0, 0}, extent };
-        renderingInfo.layerCount = 1;
-        renderingInfo.colorAttachmentCount = 0; // Explicitly 0
-        renderingInfo.pColorAttachments = nullptr;
-        renderingInfo.pDepthAttachment = &depthAttachment;
-
-        vkCmdBeginRendering(cmd, &renderingInfo);
-
-        // Standard Dynamic States
-        VkViewport viewport{ 0.0f, 0.0f, (float)extent.width, (float)extent.height, 0.0f, 1.0f };
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
-        VkRect2D scissor{ {0, 0}, extent };
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        VulkanBuffer* culledBuffer = registry.getBuffer(m_culledInstances);
 
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_cachedPipeline->getHandle());
 
@@ -78,7 +57,5 @@ namespace ix
         // Draw everything
         vkCmdDrawIndexedIndirect(cmd, culledBuffer->getBuffer(), 0,
             state.frame.renderBatches->size(), sizeof(GPUIndirectCommand));
-
-        vkCmdEndRendering(cmd);
     }
 }
\ No newline at end of file
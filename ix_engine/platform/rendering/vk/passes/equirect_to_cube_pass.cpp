@@ -8,7 +8,6 @@
 
 #include "engine.h"
 #include "core/asset_manager.h"
-#include "core/scene_manager.h"
 #include "core/components.h"
 #include "global_common/ix_global_pods.h"
 
@@ -18,13 +17,16 @@ namespace ix
 
     EquirectToCubemapPass::EquirectToCubemapPass(const std::string& name) : RenderGraphPass_I(name) {}
 
-    void EquirectToCubemapPass::setup(RenderGraphBuilder& builder) {}
+    void EquirectToCubemapPass::setup(RenderGraphBuilder& builder)
+    {
+        // The cubemap is an asset, the graph only needs to order this before the skybox
+        builder.writeVirtual("EnvironmentCubemap");
+    }
 
     void EquirectToCubemapPass::execute(const RenderState& state, RenderGraphRegistry& registry)
     {
         VkCommandBuffer cmd = state.frame.commandBuffer;
-        auto& scene = SceneManager::getActiveScene();
-        TextureHandle skyHandle = scene.getSkybox();
+        TextureHandle skyHandle = state.view.skybox;
 
         if (skyHandle == 0) return;
 
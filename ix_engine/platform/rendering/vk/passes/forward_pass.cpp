@@ -18,11 +18,13 @@ namespace ix
 
     void ForwardPass::setup(RenderGraphBuilder& builder) 
     {
-        builder.write("BackBuffer");
-        builder.read("DepthBuffer");
+        RGResourceview backBuffer = builder.write("BackBuffer", ResourceUsage::ColorAttachment);
+        builder.setClearValue(backBuffer, { {{ 0.1f, 0.1f, 0.1f, 1.0f }} });
+        builder.read("DepthBuffer", ResourceUsage::DepthAttachment);
 
-        builder.read("LightGridBuffer");
-        builder.read("LightIndexBuffer");
+        builder.read("LightGridBuffer", ResourceUsage::Storage);
+        builder.read("LightIndexBuffer", ResourceUsage::Storage);
+        m_culledInstances = builder.read("CulledInstances", ResourceUsage::IndirectArgs | ResourceUsage::Storage);
 
         m_cachedPipeline = builder.getPipelineManager()->getGraphicsPipeline("ForwardPass");
     }
@@ -31,47 +33,9 @@ namespace ix
     {
         if (!m_cachedPipeline || state.frame.instanceCount == 0) return;
 
+        // The graph began rendering to the back and depth buffers, with the viewport set
         VkCommandBuffer cmd = state.frame.commandBuffer;
-        auto& colorState = registry.getResourceState("BackBuffer");
-        auto& depthState = registry.getResourceState("DepthBuffer");
-
-        VulkanBuffer* culledBuffer = registry.getBuffer("CulledInstances");
-        VulkanImage* targetImage = colorState.physicalImage;
-        VulkanImage* depthImage = depthState.physicalImage;
-
-        if (!targetImage || !depthImage) return;
-
-        VkExtent2D extent = targetImage->getExtent();
-
-        // Rendering Attachments Setup
-        VkRenderingAttachmentInfo colorAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
-        colorAttachment.imageView = targetImage->getView();
-        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachment.clearValue = { {{ 0.1f, 0.1f, 0.1f, 1.0f }} };
-
-        VkRenderingAttachmentInfo depthAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
-        depthAttachment.imageView = depthImage->getView();
-        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
-        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
-
-        VkRenderingInfo renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO };
-        renderingInfo.renderArea = { {0, 0}, extent };
-        renderingInfo.layerCount = 1;
-        renderingInfo.colorAttachmentCount = 1;
-        renderingInfo.pColorAttachments = &colorAttachment;
-        renderingInfo.pDepthAttachment = &depthAttachment;
-
-        vkCmdBeginRendering(cmd, &renderingInfo);
-
-        // Set Dynamic States
-        VkViewport viewport{ 0.0f, 0.0f, (float)extent.width, (float)extent.height, 0.0f, 1.0f };
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
-        VkRect2D scissor{ {0, 0}, extent };
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        VulkanBuffer* culledBuffer = registry.getBuffer(m_culledInstances);
 
         // Bind Pipeline
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_cachedPipeline->getHandle());
@@ -107,8 +71,6 @@ namespace ix
             sizeof(GPUIndirectCommand)
         );
 
-        vkCmdEndRendering(cmd);
-
         // Log
         static bool debug_log_once = true;
         if (debug_log_once) {
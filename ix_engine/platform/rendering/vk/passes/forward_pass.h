@@ -19,6 +19,7 @@ namespace ix
 
     private:
         VulkanPipeline* m_cachedPipeline = nullptr;
+        RGResourceview m_culledInstances;
     };
 }
 
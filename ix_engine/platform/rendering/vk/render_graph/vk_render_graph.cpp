@@ -3,14 +3,29 @@
 #include "vk_render_graph.h"
 #include "platform/rendering/vk/vk_image.h"
 #include "platform/rendering/vk/vk_buffer.h"
+#include "platform/rendering/vk/vk_command_pools.h"
+#include "platform/rendering/vk/vk_gpu_profiler.h"
 #include "global_common/ix_global_pods.h"
+#include "core/job_system.h"
+#include "core/profiler.h"
+
+#include <queue>
 
 namespace ix 
 {
+    static VkImageSubresourceRange fullRange(const VulkanImage& image)
+    {
+        return {
+            static_cast<VkImageAspectFlags>(image.isDepthFormat() ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT),
+            0, 1, 0, image.getLayerCount()
+        };
+    }
+
     void RenderGraph::addPass(std::unique_ptr<RenderGraphPass_I> pass) 
     
     {
         m_compiledPasses.push_back({ std::move(pass), {} });
+        m_topologyDirty = true;
     }
 
     void RenderGraph::importImage(const std::string& name, VulkanImage* image) 
@@ -20,97 +35,883 @@ namespace ix
 
     void RenderGraph::compile(const RenderGraphCompileConfig& config)
     {
+        IX_PROFILE_SCOPE("RenderGraph::compile");
+
         for (auto& entry : m_compiledPasses) 
         {
             entry.requests.clear();
             PassType pType = entry.pass->getPassType();
             RenderGraphBuilder builder(m_registry, entry.requests, config, pType);
             entry.pass->setup(builder);
+            entry.asyncCompute = builder.usesAsyncCompute();
+        }
+
+        m_backBuffer = m_registry.getHandle(BACK_BUFFER);
+
+        buildExecutionOrder();
+        for (uint32_t position = 0; position < m_executionOrder.size(); position++)
+        {
+            m_compiledPasses[m_executionOrder[position]].profileScope = position;
         }
+        scheduleQueues(config);
+        allocateTransients(config);
+
+        for (auto& entry : m_compiledPasses) resolveAccesses(entry);
+        assignAliasPredecessors();
+        assignQueueTransfers();
+        resolveAttachments();
+
+        m_compiled = true;
+        m_topologyDirty = false;
     }
 
-    void RenderGraph::execute(const RenderState& state) 
+    void RenderGraph::resize(const RenderGraphCompileConfig& config)
     {
-        for (auto& entry : m_compiledPasses) 
+        if (!m_compiled) return;
+
+        // Swapchain-sized transients change size, so the memory blocks (and who aliases whom) can too
+        allocateTransients(config);
+        assignAliasPredecessors();
+    }
+
+    void RenderGraph::scheduleQueues(const RenderGraphCompileConfig& config)
+    {
+        const bool hasAsyncQueue = config.context->hasAsyncCompute();
+        for (uint32_t index : m_executionOrder)
         {
-    
-            for (const auto& request : entry.requests) 
+            PassEntry& entry = m_compiledPasses[index];
+            if (entry.asyncCompute && !hasAsyncQueue)
             {
-                transitionResource(state.frame.commandBuffer, request);
+                spdlog::info("RenderGraph: No async compute queue, '{}' runs on the graphics queue", entry.pass->getName());
+                entry.asyncCompute = false;
             }
+        }
 
-            entry.pass->execute(state, m_registry);
+        auto touchedOnGraphics = [&](RGResourceHandle handle, bool writesOnly) {
+            for (uint32_t index : m_executionOrder)
+            {
+                const PassEntry& entry = m_compiledPasses[index];
+                if (entry.asyncCompute) continue;
+                for (const auto& request : entry.requests)
+                {
+                    if (request.handle == handle && (!writesOnly || request.access == AccessType::Write)) return true;
+                }
+            }
+            return false;
+            };
+
+        // The compute queue runs ahead of the frame's graphics work, so an async pass can't consume or
+        // share anything graphics passes write. Images only travel compute -> graphics within a frame, and
+        // transients would alias memory across queues. Demoting a pass can make its readers depend on graphics too
+        bool demoted = true;
+        while (demoted)
+        {
+            demoted = false;
+            for (uint32_t index : m_executionOrder)
+            {
+                PassEntry& entry = m_compiledPasses[index];
+                if (!entry.asyncCompute) continue;
+
+                const char* reason = nullptr;
+                for (const auto& request : entry.requests)
+                {
+                    const ResourceState& state = m_registry.getResourceState(request.handle);
+                    if (state.isTransient()) reason = "uses a transient resource";
+                    else if (state.type == RGResourceType::Image && (state.hasHistory() || state.isHistoryCopy)) reason = "uses an image that outlives the frame";
+                    else if (touchedOnGraphics(request.handle, true)) reason = "shares a resource with graphics writers";
+                    else if (request.access == AccessType::Read && state.type == RGResourceType::Image && touchedOnGraphics(request.handle, false))
+                        reason = "reads an image graphics passes use";
+                    if (reason) break;
+                }
+                if (!reason) continue;
+
+                spdlog::warn("RenderGraph: '{}' {}, it runs on the graphics queue", entry.pass->getName(), reason);
+                entry.asyncCompute = false;
+                demoted = true;
+            }
+        }
+
+        m_graphicsOrder.clear();
+        m_asyncOrder.clear();
+        for (uint32_t index : m_executionOrder)
+        {
+            (m_compiledPasses[index].asyncCompute ? m_asyncOrder : m_graphicsOrder).push_back(index);
+        }
+
+        m_graphicsFamily = config.context->getGraphicsFamily();
+        m_computeFamily = config.context->getComputeFamily();
+        if (!m_asyncOrder.empty()) spdlog::info("RenderGraph: {} passes on the async compute queue", m_asyncOrder.size());
+    }
+
+    void RenderGraph::assignQueueTransfers()
+    {
+        m_sharedResources.clear();
+        m_queueReleases.clear();
+        m_asyncWaitStages = VK_PIPELINE_STAGE_2_NONE;
+        m_graphicsSplit = m_graphicsOrder.size();
+        if (m_asyncOrder.empty()) return;
+
+        const uint32_t resourceCount = m_registry.getResourceCount();
+        std::vector<bool> onCompute(resourceCount, false);
+        std::vector<bool> writtenOnCompute(resourceCount, false);
+        for (uint32_t index : m_asyncOrder)
+        {
+            for (const auto& access : m_compiledPasses[index].accesses)
+            {
+                onCompute[access.resource] = true;
+                if (access.writeAccess != VK_ACCESS_2_NONE) writtenOnCompute[access.resource] = true;
+            }
+        }
+
+        // The first graphics pass to use what the compute queue wrote waits on the semaphore and acquires it.
+        // Everything before the first such pass, or the first use of the swapchain image, waits for neither
+        std::vector<bool> seen(resourceCount, false);
+        for (size_t position = 0; position < m_graphicsOrder.size(); position++)
+        {
+            for (auto& access : m_compiledPasses[m_graphicsOrder[position]].accesses)
+            {
+                if (access.resource == m_backBuffer) m_graphicsSplit = std::min(m_graphicsSplit, position);
+                if (!onCompute[access.resource] || seen[access.resource]) continue;
+                seen[access.resource] = true;
+                m_sharedResources.push_back(access.resource);
+                if (!writtenOnCompute[access.resource]) continue;
+
+                access.acquire = true;
+                m_asyncWaitStages |= access.stages;
+                m_graphicsSplit = std::min(m_graphicsSplit, position);
+                if (m_registry.getResourceState(access.resource).type == RGResourceType::Image) m_queueReleases.push_back(access);
+            }
+        }
+
+        // Graphics stages tracked before the split mean nothing on the compute queue
+        for (RGResourceHandle resource = 0; resource < resourceCount; resource++)
+        {
+            if (onCompute[resource]) m_registry.resetSyncState(resource);
         }
     }
 
-    void RenderGraph::transitionResource(VkCommandBuffer cmd, const ResourceRequest& request)
+    void RenderGraph::resolveAttachments()
     {
-        auto& state = m_registry.getResourceState(request.name);
+        const uint32_t resourceCount = m_registry.getResourceCount();
+        std::vector<uint32_t> firstUse(resourceCount, UINT32_MAX);
+        std::vector<uint32_t> lastUse(resourceCount, 0);
+        for (uint32_t position = 0; position < m_executionOrder.size(); position++)
+        {
+            for (const auto& access : m_compiledPasses[m_executionOrder[position]].accesses)
+            {
+                firstUse[access.resource] = std::min(firstUse[access.resource], position);
+                lastUse[access.resource] = position;
+            }
+        }
 
-        if (state.physicalImage)
+        for (uint32_t position = 0; position < m_executionOrder.size(); position++)
         {
-            VulkanImage* img = state.physicalImage;
-            VkImageLayout targetLayout;
-            bool isDepth = img->isDepthFormat();
+            PassEntry& entry = m_compiledPasses[m_executionOrder[position]];
+            entry.colorAttachments.clear();
+            entry.depthAttachment = {};
+
+            for (const auto& access : entry.accesses)
+            {
+                const bool color = access.layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                const bool depth = access.layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+                if (!color && !depth) continue;
+
+                const ResourceState& state = m_registry.getResourceState(access.resource);
+                const RGResourceHandle resource = access.resource;
+
+                // Transients start every frame undefined, and so does the acquired swapchain image
+                const bool persistent = !state.isTransient() && resource != m_backBuffer;
+
+                PassAttachment attachment{ resource };
+                attachment.info.imageLayout = access.layout;
+                attachment.info.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+                const ResourceRequest* clear = nullptr;
+                for (const auto& request : entry.requests)
+                {
+                    if (request.handle == resource && request.clearValue) clear = &request;
+                }
 
-            if (isDepth) {
-                if (request.passType == PassType::Graphics) {
-                    // In graphics passes, depth is always an attachment
-                    targetLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+                if (firstUse[resource] != position)
+                {
+                    attachment.info.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
                 }
-                else {
-                    // In compute/sampling, depth is a texture
-                    targetLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                else if (clear)
+                {
+                    attachment.info.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                    attachment.info.clearValue = *clear->clearValue;
+                }
+                else
+                {
+                    attachment.info.loadOp = persistent ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                }
+
+                if (access.writeAccess == VK_ACCESS_2_NONE) attachment.info.storeOp = VK_ATTACHMENT_STORE_OP_NONE;
+                else if (state.isTransient() && lastUse[resource] == position) attachment.info.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+                if (depth)
+                {
+                    if (entry.depthAttachment.resource != INVALID_RESOURCE)
+                    {
+                        throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' binds two depth attachments");
+                    }
+                    entry.depthAttachment = attachment;
+                }
+                else
+                {
+                    if (entry.colorAttachments.size() == MAX_COLOR_ATTACHMENTS)
+                    {
+                        throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' binds too many color attachments");
+                    }
+                    entry.colorAttachments.push_back(attachment);
                 }
             }
-            else { // Color Image
-                if (request.access == AccessType::Write) {
-                    targetLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        }
+    }
+
+    void RenderGraph::assignAliasPredecessors()
+    {
+        // The first pass to touch a transient each frame inherits the memory from the previous occupant
+        std::vector<bool> seen(m_registry.getResourceCount(), false);
+        for (uint32_t index : m_executionOrder)
+        {
+            for (auto& access : m_compiledPasses[index].accesses)
+            {
+                if (!m_registry.getResourceState(access.resource).isTransient() || seen[access.resource]) continue;
+                seen[access.resource] = true;
+                access.aliasPredecessor = m_transients.getAliasPredecessor(access.resource);
+            }
+        }
+    }
+
+    void RenderGraph::allocateTransients(const RenderGraphCompileConfig& config)
+    {
+        // Culled passes don't count, a transient only they use is never created
+        std::vector<uint32_t> lifetimeOf(m_registry.getResourceCount(), UINT32_MAX);
+        std::vector<TransientLifetime> lifetimes;
+        m_historyResources.clear();
+        for (uint32_t position = 0; position < m_executionOrder.size(); position++)
+        {
+            for (const auto& request : m_compiledPasses[m_executionOrder[position]].requests)
+            {
+                const ResourceState& state = m_registry.getResourceState(request.handle);
+                if (state.hasHistory() && std::find(m_historyResources.begin(), m_historyResources.end(), request.handle) == m_historyResources.end())
+                {
+                    m_historyResources.push_back(request.handle);
+                }
+                if (!state.isTransient()) continue;
+
+                uint32_t& lifetime = lifetimeOf[request.handle];
+                if (lifetime == UINT32_MAX)
+                {
+                    lifetime = static_cast<uint32_t>(lifetimes.size());
+                    lifetimes.push_back({ request.handle, position, position });
                 }
-                else {
-                    targetLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                else
+                {
+                    lifetimes[lifetime].last = position;
                 }
             }
+        }
+
+        m_transients.build(*config.context, m_registry, lifetimes, m_historyResources, config.swapchainExtent);
+    }
+
+    void RenderGraph::buildExecutionOrder()
+    {
+        const uint32_t passCount = static_cast<uint32_t>(m_compiledPasses.size());
+
+        auto accesses = [](const PassEntry& entry, RGResourceHandle handle, AccessType access) {
+            for (const auto& request : entry.requests)
+            {
+                if (request.handle == handle && request.access == access) return true;
+            }
+            return false;
+            };
+
+        // Writers of every resource in addPass order, and validation
+        std::vector<std::vector<uint32_t>> writers(m_registry.getResourceCount());
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            const PassEntry& entry = m_compiledPasses[i];
+            bool writesAnything = false;
+
+            for (const auto& request : entry.requests)
+            {
+                if (!m_registry.getResourceState(request.handle).isDeclared)
+                {
+                    throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' uses undeclared resource '" + request.name + "'");
+                }
+                if (request.access != AccessType::Write) continue;
+                if (m_registry.getResourceState(request.handle).isHistoryCopy)
+                {
+                    throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' writes '" + request.name + "', previous frames are read-only");
+                }
+
+                writesAnything = true;
+                auto& resourceWriters = writers[request.handle];
+                if (resourceWriters.empty() || resourceWriters.back() != i) resourceWriters.push_back(i);
+            }
+
+            if (!writesAnything)
+            {
+                throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' declares no outputs");
+            }
+        }
+
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            for (const auto& request : m_compiledPasses[i].requests)
+            {
+                const ResourceState& state = m_registry.getResourceState(request.handle);
+                if (request.access == AccessType::Read && (state.isVirtual || state.isTransient()) && writers[request.handle].empty())
+                {
+                    throw std::runtime_error("RenderGraph: Pass '" + m_compiledPasses[i].pass->getName() + "' reads '" + request.name + "' which no pass writes");
+                }
+            }
+        }
+
+        // Writers a pass consumes: all of them for pure readers, the earlier ones for read-modify-write
+        auto producersOf = [&](uint32_t pass, RGResourceHandle handle) {
+            std::vector<uint32_t> producers;
+            const bool alsoWrites = accesses(m_compiledPasses[pass], handle, AccessType::Write);
+            for (uint32_t writer : writers[handle])
+            {
+                if (writer == pass || (alsoWrites && writer > pass)) continue;
+                producers.push_back(writer);
+            }
+            return producers;
+            };
+
+        // Culling: walk back from the passes that write a sink
+        // Resources with history are read by later frames
+        std::vector<bool> isSink(m_registry.getResourceCount(), false);
+        for (RGResourceHandle handle = 0; handle < m_registry.getResourceCount(); handle++)
+        {
+            if (m_registry.getResourceState(handle).hasHistory()) isSink[handle] = true;
+        }
+        if (m_backBuffer != INVALID_RESOURCE) isSink[m_backBuffer] = true;
+        for (const auto& name : m_exports)
+        {
+            RGResourceHandle handle = m_registry.getHandle(name);
+            if (handle != INVALID_RESOURCE) isSink[handle] = true;
+        }
+
+        std::vector<bool> live(passCount, false);
+        std::vector<uint32_t> stack;
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            for (const auto& request : m_compiledPasses[i].requests)
+            {
+                if (request.access == AccessType::Write && isSink[request.handle])
+                {
+                    live[i] = true;
+                }
+            }
+            if (live[i]) stack.push_back(i);
+        }
+        while (!stack.empty())
+        {
+            const uint32_t pass = stack.back();
+            stack.pop_back();
+            for (const auto& request : m_compiledPasses[pass].requests)
+            {
+                if (request.access != AccessType::Read) continue;
+                for (uint32_t producer : producersOf(pass, request.handle))
+                {
+                    if (live[producer]) continue;
+                    live[producer] = true;
+                    stack.push_back(producer);
+                }
+            }
+        }
+
+        // Edges between live passes: writer -> writer in addPass order, writer -> reader
+        std::vector<std::vector<uint32_t>> dependents(passCount);
+        std::vector<uint32_t> dependencyCount(passCount, 0);
+        auto addEdge = [&](uint32_t from, uint32_t to) {
+            if (from == to || !live[from] || !live[to]) return;
+            if (std::find(dependents[from].begin(), dependents[from].end(), to) != dependents[from].end()) return;
+            dependents[from].push_back(to);
+            dependencyCount[to]++;
+            };
+
+        for (const auto& resourceWriters : writers)
+        {
+            for (size_t k = 1; k < resourceWriters.size(); k++) addEdge(resourceWriters[k - 1], resourceWriters[k]);
+        }
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            for (const auto& request : m_compiledPasses[i].requests)
+            {
+                if (request.access != AccessType::Read) continue;
+                for (uint32_t producer : producersOf(i, request.handle)) addEdge(producer, i);
+            }
+        }
+
+        // Kahn's algorithm, ties broken by addPass order so the result is stable
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+        uint32_t liveCount = 0;
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            if (!live[i]) continue;
+            liveCount++;
+            if (dependencyCount[i] == 0) ready.push(i);
+        }
+
+        m_executionOrder.clear();
+        while (!ready.empty())
+        {
+            const uint32_t pass = ready.top();
+            ready.pop();
+            m_executionOrder.push_back(pass);
+
+            for (uint32_t dependent : dependents[pass])
+            {
+                if (--dependencyCount[dependent] == 0) ready.push(dependent);
+            }
+        }
 
-            if (img->getLayout() != targetLayout) {
-                img->transition(cmd, targetLayout);
-                state.currentLayout = targetLayout;
+        if (m_executionOrder.size() != liveCount)
+        {
+            std::string cycle;
+            for (uint32_t i = 0; i < passCount; i++)
+            {
+                if (live[i] && dependencyCount[i] > 0) cycle += " '" + m_compiledPasses[i].pass->getName() + "'";
             }
+            throw std::runtime_error("RenderGraph: Dependency cycle between passes" + cycle);
+        }
+
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            if (!live[i]) spdlog::warn("RenderGraph: Culled pass '{}', none of its outputs are used", m_compiledPasses[i].pass->getName());
+        }
+        spdlog::info("RenderGraph: Compiled {} of {} passes", liveCount, passCount);
+    }
+
+    void RenderGraph::execute(const RenderState& state) 
+    {
+        IX_PROFILE_SCOPE("RenderGraph::execute");
+
+        for (RGResourceHandle resource : m_historyResources) m_registry.rotateHistory(resource);
+
+        // Compute first, the graphics passes acquire what it releases
+        if (!m_asyncOrder.empty()) executeAsync(state);
+
+        // Secondary buffers come from per-thread pools, so recording has to start on a job system thread
+        JobSystem* jobs = state.system.jobSystem;
+        if (jobs && state.system.commandPools && jobs->isMainThread() && m_graphicsOrder.size() > 1)
+        {
+            executeParallel(state);
+        }
+        else
+        {
+            executeSerial(state);
+        }
+    }
+
+    void RenderGraph::executeAsync(const RenderState& state)
+    {
+        IX_PROFILE_SCOPE("RenderGraph::executeAsync");
+
+        VkCommandBuffer cmd = state.frame.computeCommandBuffer;
+        if (cmd == VK_NULL_HANDLE)
+        {
+            spdlog::error("RenderGraph: Async compute passes are scheduled but the frame has no compute command buffer");
+            return;
+        }
+
+        // The submission waits for the graphics work that last used this frame's copies, and the shared images are rewritten here
+        for (RGResourceHandle resource : m_sharedResources)
+        {
+            m_registry.resetSyncState(resource);
+            if (VulkanImage* image = m_registry.getResourceState(resource).physicalImage) image->setLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+        }
+
+        FrameContext frame = state.frame;
+        frame.commandBuffer = cmd;
+        RenderState passState{ state.system, frame, state.view };
+        for (uint32_t index : m_asyncOrder)
+        {
+            auto& entry = m_compiledPasses[index];
+            recordBarriers(cmd, entry);
+            recordPass(passState, entry);
+        }
+
+        // Release the images to the graphics family, buffers are shared concurrently and need no transfer
+        m_imageBarriers.clear();
+        for (const auto& access : m_queueReleases)
+        {
+            const ResourceState& resource = m_registry.getResourceState(access.resource);
+            VulkanImage* image = resource.physicalImage;
+            if (!image) continue;
+
+            VkImageMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+            barrier.srcStageMask = resource.writeStages | resource.readStages;
+            barrier.srcAccessMask = resource.writeAccess;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barrier.dstAccessMask = VK_ACCESS_2_NONE;
+            barrier.oldLayout = image->getLayout();
+            barrier.newLayout = access.layout;
+            barrier.srcQueueFamilyIndex = m_computeFamily;
+            barrier.dstQueueFamilyIndex = m_graphicsFamily;
+            barrier.image = image->getHandle();
+            barrier.subresourceRange = fullRange(*image);
+            m_imageBarriers.push_back(barrier);
+        }
+
+        if (m_imageBarriers.empty()) return;
+
+        VkDependencyInfo dependency{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(m_imageBarriers.size());
+        dependency.pImageMemoryBarriers = m_imageBarriers.data();
+        vkCmdPipelineBarrier2(cmd, &dependency);
+    }
+
+    void RenderGraph::executeSerial(const RenderState& state)
+    {
+        FrameContext tail = state.frame;
+        if (tail.tailCommandBuffer != VK_NULL_HANDLE) tail.commandBuffer = tail.tailCommandBuffer;
+        RenderState tailState{ state.system, tail, state.view };
+
+        for (size_t i = 0; i < m_graphicsOrder.size(); i++) 
+        {
+            const RenderState& passState = i < m_graphicsSplit ? state : tailState;
+            auto& entry = m_compiledPasses[m_graphicsOrder[i]];
+            recordBarriers(passState.frame.commandBuffer, entry);
+            recordPass(passState, entry);
+        }
+    }
+
+    void RenderGraph::executeParallel(const RenderState& state)
+    {
+        IX_PROFILE_SCOPE("RenderGraph::executeParallel");
+
+        JobSystem& jobs = *state.system.jobSystem;
+        VulkanCommandPools& pools = *state.system.commandPools;
+
+        // Every pass records into its own secondary buffer. Pass bodies never read the tracked
+        // layouts, so they can be recorded before the barriers between them
+        m_secondaryBuffers.assign(m_graphicsOrder.size(), VK_NULL_HANDLE);
+
+        JobCounter counter;
+        for (size_t i = 0; i < m_graphicsOrder.size(); i++)
+        {
+            jobs.schedule([this, &state, &pools, i]() {
+                FrameContext frame = state.frame;
+                frame.commandBuffer = pools.beginSecondary(frame.frameIndex);
+
+                RenderState passState{ state.system, frame, state.view };
+                recordPass(passState, m_compiledPasses[m_graphicsOrder[i]]);
+
+                vkEndCommandBuffer(frame.commandBuffer);
+                m_secondaryBuffers[i] = frame.commandBuffer;
+                }, &counter);
+        }
+        jobs.wait(counter);
+
+        // The primary buffers only hold the barriers and execute the passes in order
+        VkCommandBuffer tail = state.frame.tailCommandBuffer != VK_NULL_HANDLE ? state.frame.tailCommandBuffer : state.frame.commandBuffer;
+        for (size_t i = 0; i < m_graphicsOrder.size(); i++)
+        {
+            VkCommandBuffer primary = i < m_graphicsSplit ? state.frame.commandBuffer : tail;
+            recordBarriers(primary, m_compiledPasses[m_graphicsOrder[i]]);
+            vkCmdExecuteCommands(primary, 1, &m_secondaryBuffers[i]);
+        }
+    }
+
+    void RenderGraph::recordPass(const RenderState& state, PassEntry& entry)
+    {
+        IX_PROFILE_SCOPE("RenderGraph::recordPass");
+
+        VkCommandBuffer cmd = state.frame.commandBuffer;
+        VulkanGpuProfiler* profiler = state.system.gpuProfiler;
+
+        const uint32_t colorCount = static_cast<uint32_t>(entry.colorAttachments.size());
+        const bool hasDepth = entry.depthAttachment.resource != INVALID_RESOURCE;
+        if (colorCount == 0 && !hasDepth)
+        {
+            if (profiler) profiler->beginScope(cmd, entry.profileScope, entry.pass->getName(), entry.asyncCompute);
+            entry.pass->execute(state, m_registry);
+            if (profiler) profiler->endScope(cmd, entry.profileScope);
             return;
         }
 
-        if (state.physicalBuffer)
+        // Copies on the stack, passes may be recorded on several threads
+        VkRenderingAttachmentInfo colors[MAX_COLOR_ATTACHMENTS];
+        VkRenderingAttachmentInfo depth = entry.depthAttachment.info;
+        VkExtent2D extent{};
+        auto bind = [&](const PassAttachment& attachment, VkRenderingAttachmentInfo& info) {
+            VulkanImage* image = m_registry.getResourceState(attachment.resource).physicalImage;
+            if (!image) return false;
+            info.imageView = image->getView();
+            if (extent.width == 0) extent = image->getExtent();
+            return true;
+            };
+
+        for (uint32_t i = 0; i < colorCount; i++)
         {
-            VkAccessFlags targetAccess = (request.access == AccessType::Write)
-                ? (VK_ACCESS_SHADER_WRITE_BIT)
-                : (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+            colors[i] = entry.colorAttachments[i].info;
+            if (!bind(entry.colorAttachments[i], colors[i])) return;
+        }
+        if (hasDepth && !bind(entry.depthAttachment, depth)) return;
+
+        VkRenderingInfo renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO };
+        renderingInfo.renderArea = { {0, 0}, extent };
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = colorCount;
+        renderingInfo.pColorAttachments = colors;
+        renderingInfo.pDepthAttachment = hasDepth ? &depth : nullptr;
 
-            // Read-after-Write check
-            // If the buffer was written to previously and we are now reading (or writing again)
-            if (state.currentAccess & VK_ACCESS_SHADER_WRITE_BIT)
+        // Queries begun outside the rendering scope must end outside it, so the scope includes load and store
+        if (profiler) profiler->beginScope(cmd, entry.profileScope, entry.pass->getName(), entry.asyncCompute);
+        vkCmdBeginRendering(cmd, &renderingInfo);
+
+        VkViewport viewport{ 0.0f, 0.0f, (float)extent.width, (float)extent.height, 0.0f, 1.0f };
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        VkRect2D scissor{ {0, 0}, extent };
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        entry.pass->execute(state, m_registry);
+
+        vkCmdEndRendering(cmd);
+        if (profiler) profiler->endScope(cmd, entry.profileScope);
+    }
+
+    void RenderGraph::resolveAccesses(PassEntry& entry)
+    {
+        entry.accesses.clear();
+
+        for (const auto& request : entry.requests)
+        {
+            const ResourceState& state = m_registry.getResourceState(request.handle);
+            if (state.isVirtual) continue;
+
+            const bool graphics = request.passType == PassType::Graphics;
+            const bool write = request.access == AccessType::Write;
+            VulkanImage* image = state.physicalImage;
+
+            ResourceUsage usage = request.usage;
+            if (usage == ResourceUsage::Default)
+            {
+                if (!image) usage = ResourceUsage::Storage;
+                else if (graphics && image->isDepthFormat()) usage = ResourceUsage::DepthAttachment;
+                else if (graphics && write) usage = ResourceUsage::ColorAttachment;
+                else usage = write ? ResourceUsage::Storage : ResourceUsage::Sampled;
+            }
+
+            const VkPipelineStageFlags2 shaderStages = graphics
+                ? (VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT)
+                : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+            ResourceAccess resolved{ request.handle };
+            if (hasUsage(usage, ResourceUsage::ColorAttachment))
+            {
+                resolved.stages |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                resolved.readAccess |= VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+                if (write) resolved.writeAccess |= VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+                resolved.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            }
+            if (hasUsage(usage, ResourceUsage::DepthAttachment))
+            {
+                // Depth is stored by every pass that binds it, so even a depth test counts as a write
+                resolved.stages |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+                resolved.readAccess |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+                resolved.writeAccess |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                resolved.layout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+            }
+            if (hasUsage(usage, ResourceUsage::Sampled))
             {
-                VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
-                barrier.srcAccessMask = state.currentAccess;
-                barrier.dstAccessMask = targetAccess;
+                resolved.stages |= shaderStages;
+                resolved.readAccess |= VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+                resolved.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            }
+            if (hasUsage(usage, ResourceUsage::Storage))
+            {
+                resolved.stages |= shaderStages;
+                resolved.readAccess |= VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+                if (write) resolved.writeAccess |= VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+                resolved.layout = VK_IMAGE_LAYOUT_GENERAL;
+            }
+            if (hasUsage(usage, ResourceUsage::IndirectArgs))
+            {
+                resolved.stages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+                resolved.readAccess |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+            }
+            if (hasUsage(usage, ResourceUsage::TransferDst))
+            {
+                resolved.stages |= VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                resolved.writeAccess |= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                resolved.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            }
+            if (!image) resolved.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            // A pass can only see an image in one layout
+            auto existing = std::find_if(entry.accesses.begin(), entry.accesses.end(),
+                [&](const ResourceAccess& access) { return access.resource == request.handle; });
+            if (existing == entry.accesses.end())
+            {
+                entry.accesses.push_back(resolved);
+                continue;
+            }
+            if (image && existing->layout != resolved.layout)
+            {
+                throw std::runtime_error("RenderGraph: Pass '" + entry.pass->getName() + "' uses '" + request.name + "' in two different layouts");
+            }
+            existing->stages |= resolved.stages;
+            existing->readAccess |= resolved.readAccess;
+            existing->writeAccess |= resolved.writeAccess;
+        }
+    }
+
+    void RenderGraph::recordBarriers(VkCommandBuffer cmd, const PassEntry& entry)
+    {
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+
+        for (const auto& access : entry.accesses)
+        {
+            ResourceState& state = m_registry.getResourceState(access.resource);
+            VulkanImage* image = state.physicalImage;
+            if (!image && !state.physicalBuffer)
+            {
+                spdlog::error("RenderGraph: Resource '{}' has no physical image or buffer bound!", state.name);
+                continue;
+            }
+
+            if (access.aliasPredecessor != INVALID_RESOURCE)
+            {
+                // Wait for the last use of the shared memory, the contents are discarded
+                const ResourceState& previous = m_registry.getResourceState(access.aliasPredecessor);
+                const VkPipelineStageFlags2 previousStages = previous.writeStages | previous.readStages;
+                const VkAccessFlags2 previousAccess = previous.writeAccess;
+
+                state.writeStages = previousStages;
+                state.writeAccess = previousAccess;
+                state.readStages = VK_PIPELINE_STAGE_2_NONE;
+                state.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+                state.visibleAccess = VK_ACCESS_2_NONE;
+                if (image) image->setLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+            }
+
+            if (access.acquire)
+            {
+                // The semaphore wait made the compute queue's writes visible, images still need the acquire half
+                const bool writes = access.writeAccess != VK_ACCESS_2_NONE;
+                const VkAccessFlags2 dstAccess = access.readAccess | access.writeAccess;
+                if (image)
+                {
+                    VkImageMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                    barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                    barrier.dstStageMask = access.stages;
+                    barrier.dstAccessMask = dstAccess;
+                    barrier.oldLayout = image->getLayout();
+                    barrier.newLayout = access.layout;
+                    barrier.srcQueueFamilyIndex = m_computeFamily;
+                    barrier.dstQueueFamilyIndex = m_graphicsFamily;
+                    barrier.image = image->getHandle();
+                    barrier.subresourceRange = fullRange(*image);
+                    m_imageBarriers.push_back(barrier);
+
+                    image->setLayout(access.layout);
+                    state.currentLayout = access.layout;
+                }
+
+                // Like a layout transition for images, like a plain read or write for buffers
+                const bool tracksWrite = image || writes;
+                state.writeStages = tracksWrite ? access.stages : VK_PIPELINE_STAGE_2_NONE;
+                state.writeAccess = access.writeAccess;
+                state.readStages = tracksWrite ? VK_PIPELINE_STAGE_2_NONE : access.stages;
+                state.visibleStages = writes ? VK_PIPELINE_STAGE_2_NONE : access.stages;
+                state.visibleAccess = writes ? VK_ACCESS_2_NONE : dstAccess;
+                continue;
+            }
+
+            const bool layoutChange = image && image->getLayout() != access.layout;
+            const bool writes = access.writeAccess != VK_ACCESS_2_NONE;
+
+            VkPipelineStageFlags2 srcStages;
+            if (layoutChange || writes)
+            {
+                // Write after read/write: wait for every earlier access, flush the last write
+                srcStages = state.writeStages | state.readStages;
+                if (srcStages == VK_PIPELINE_STAGE_2_NONE && !layoutChange)
+                {
+                    state.writeStages = access.stages;
+                    state.writeAccess = access.writeAccess;
+                    state.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+                    state.visibleAccess = VK_ACCESS_2_NONE;
+                    continue;
+                }
+            }
+            else
+            {
+                // Read after write, once per stage and access. Read after read needs no barrier
+                const bool visible = (access.stages & ~state.visibleStages) == 0 && (access.readAccess & ~state.visibleAccess) == 0;
+                state.readStages |= access.stages;
+                if (state.writeStages == VK_PIPELINE_STAGE_2_NONE || visible) continue;
+                srcStages = state.writeStages;
+            }
+
+            const VkAccessFlags2 dstAccess = access.readAccess | access.writeAccess;
+            if (image)
+            {
+                VkImageMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = srcStages;
+                barrier.srcAccessMask = state.writeAccess;
+                barrier.dstStageMask = access.stages;
+                barrier.dstAccessMask = dstAccess;
+                barrier.oldLayout = image->getLayout();
+                barrier.newLayout = access.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = image->getHandle();
+                barrier.subresourceRange = fullRange(*image);
+                m_imageBarriers.push_back(barrier);
+
+                image->setLayout(access.layout);
+                state.currentLayout = access.layout;
+            }
+            else
+            {
+                VkBufferMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = srcStages;
+                barrier.srcAccessMask = state.writeAccess;
+                barrier.dstStageMask = access.stages;
+                barrier.dstAccessMask = dstAccess;
                 barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
                 barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
                 barrier.buffer = state.physicalBuffer->getBuffer();
                 barrier.offset = 0;
                 barrier.size = VK_WHOLE_SIZE;
-
-                vkCmdPipelineBarrier(
-                    cmd,
-                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
-                    0, 0, nullptr, 1, &barrier, 0, nullptr
-                );
+                m_bufferBarriers.push_back(barrier);
             }
 
-            state.currentAccess = targetAccess;
-            return;
+            if (layoutChange || writes)
+            {
+                // A layout transition acts as a write the barrier already made visible to this pass
+                state.writeStages = access.stages;
+                state.writeAccess = access.writeAccess;
+                state.readStages = VK_PIPELINE_STAGE_2_NONE;
+                state.visibleStages = writes ? VK_PIPELINE_STAGE_2_NONE : access.stages;
+                state.visibleAccess = writes ? VK_ACCESS_2_NONE : dstAccess;
+            }
+            else
+            {
+                state.visibleStages |= access.stages;
+                state.visibleAccess |= access.readAccess;
+            }
         }
 
-        spdlog::error("RenderGraph: Resource '{}' has no physical image or buffer bound!", request.name);
+        if (m_imageBarriers.empty() && m_bufferBarriers.empty()) return;
+
+        VkDependencyInfo dependency{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(m_imageBarriers.size());
+        dependency.pImageMemoryBarriers = m_imageBarriers.data();
+        dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(m_bufferBarriers.size());
+        dependency.pBufferMemoryBarriers = m_bufferBarriers.data();
+        vkCmdPipelineBarrier2(cmd, &dependency);
     }
 
     RenderGraphPass_I* RenderGraph::getPass(const std::string& name) const
@@ -3,7 +3,10 @@
 #include "render_graph_pass_i.h"
 #include "vk_render_graph_registry.h"
 #include "vk_render_graph_builder.h"
+#include "vk_render_graph_transients.h"
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace ix 
@@ -11,34 +14,121 @@ namespace ix
     struct RenderGraphCompileConfig;
     struct RenderState;
 
+    // Every request a pass makes on one resource, merged and resolved to sync2 masks at compile time
+    struct ResourceAccess
+    {
+        RGResourceHandle resource = INVALID_RESOURCE;
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+        VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; // Images only
+        RGResourceHandle aliasPredecessor = INVALID_RESOURCE; // First use of a transient: whose memory it takes over
+        bool acquire = false; // First graphics use of what the compute queue wrote this frame
+    };
+
+    // Load/store ops are inferred at compile time, the image view is filled in per frame
+    struct PassAttachment
+    {
+        RGResourceHandle resource = INVALID_RESOURCE;
+        VkRenderingAttachmentInfo info{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    };
+
     struct PassEntry 
     {
         std::unique_ptr<RenderGraphPass_I> pass;
         std::vector<ResourceRequest> requests;
+        std::vector<ResourceAccess> accesses;
+        std::vector<PassAttachment> colorAttachments; // Declaration order, matches the shader outputs
+        PassAttachment depthAttachment;
+        bool asyncCompute = false; // Recorded into the compute queue's command buffer
+        uint32_t profileScope = 0; // Position in the execution order, indexes the GPU profiler's queries
     };
 
+    // Passes are ordered by the resources they declare: every writer of a resource runs before the
+    // passes that only read it, and writers of the same resource keep their addPass order. Passes
+    // whose writes never reach the BackBuffer or an exported resource are culled.
+    // Before each pass, all the barriers it needs are batched into a single vkCmdPipelineBarrier2;
+    // reads of data a previous barrier already made visible get none.
+    // Transient resources are created at compile time and alias memory when their lifetimes don't overlap.
+    // Resources with history keep one copy per frame and rotate them each frame, older copies are read-only.
+    // Resources are named during setup and compile only; execution works on dense handles.
+    // Graphics passes with attachments run inside a rendering scope the graph begins: first uses clear
+    // or discard, later ones load, and only what a later pass or the next frame reads is stored.
+    // Async compute passes are submitted ahead of the frame's graphics work on the compute queue. Graphics
+    // passes before the first one that uses their output or the BackBuffer are recorded into the frame's
+    // command buffer and wait for nothing; the rest go into tailCommandBuffer, whose submission waits at
+    // getAsyncWaitStages() and acquires the images the compute queue wrote.
     class RenderGraph 
     {
     public:
+        static constexpr const char* BACK_BUFFER = "BackBuffer";
+        static constexpr uint32_t MAX_COLOR_ATTACHMENTS = 8;
+
+        // Adding a pass changes the topology, the graph has to be compiled again
         void addPass(std::unique_ptr<RenderGraphPass_I> pass);
+        // Runs every pass setup() and orders the passes. Throws on undeclared resources and dependency cycles
         void compile(const RenderGraphCompileConfig& config);
+        // Keeps the compiled passes and only recreates the transient resources at the new swapchain extent
+        void resize(const RenderGraphCompileConfig& config);
+        bool needsCompile() const { return m_topologyDirty; }
         void execute(const RenderState& state);
 
+        // The renderer submits state.frame.computeCommandBuffer first when this is set
+        bool hasAsyncWork() const { return !m_asyncOrder.empty(); }
+        VkPipelineStageFlags2 getAsyncWaitStages() const { return m_asyncWaitStages; }
+
         // Helper to get swapchain into the graph
         void importImage(const std::string& name, VulkanImage* image);
-        void importBuffer(const std::string& name, VulkanBuffer* buffer) 
+        RGResourceHandle importBuffer(const std::string& name, VulkanBuffer* buffer) 
         {
-            m_registry.registerExternalBuffer(name, buffer);
+            return m_registry.registerExternalBuffer(name, buffer);
         }
+        // Per-frame copy of an imported buffer, no lookup
+        void bindBuffer(RGResourceHandle handle, VulkanBuffer* buffer) { m_registry.bindBuffer(handle, buffer); }
+        // Per-frame swapchain image, no lookup. Only valid after compile
+        void setBackBuffer(VulkanImage* image) { m_registry.bindImage(m_backBuffer, image); }
+
+        // Keeps the passes writing this resource alive even if nothing in the graph reads it
+        void exportResource(const std::string& name) { m_exports.insert(name); }
 
-        // Get a pass by its name
+        // Get a pass by its name (culled passes included)
         RenderGraphPass_I* getPass(const std::string& name) const;
+        const std::vector<uint32_t>& getExecutionOrder() const { return m_executionOrder; }
 
         void clearExternalResources() { m_registry.clearExternalResources(); }
     private:
-        void transitionResource(VkCommandBuffer cmd, const ResourceRequest& request);
+        void buildExecutionOrder();
+        void scheduleQueues(const RenderGraphCompileConfig& config);
+        void assignQueueTransfers();
+        void resolveAttachments();
+        void allocateTransients(const RenderGraphCompileConfig& config);
+        void assignAliasPredecessors();
+        void resolveAccesses(PassEntry& entry);
+        void recordBarriers(VkCommandBuffer cmd, const PassEntry& entry);
+        void recordPass(const RenderState& state, PassEntry& entry);
+        void executeAsync(const RenderState& state);
+        void executeSerial(const RenderState& state);
+        void executeParallel(const RenderState& state);
 
         RenderGraphRegistry m_registry;
+        RenderGraphTransientPool m_transients;
         std::vector<PassEntry> m_compiledPasses;
+        std::vector<uint32_t> m_executionOrder; // Indices into m_compiledPasses, culled passes left out
+        std::vector<uint32_t> m_graphicsOrder;  // m_executionOrder split by queue
+        std::vector<uint32_t> m_asyncOrder;
+        std::vector<RGResourceHandle> m_sharedResources; // Used on both queues
+        std::vector<RGResourceHandle> m_historyResources; // Rotated at the start of every frame
+        std::vector<ResourceAccess> m_queueReleases;     // Images the compute queue hands to graphics, as acquired
+        VkPipelineStageFlags2 m_asyncWaitStages = VK_PIPELINE_STAGE_2_NONE;
+        size_t m_graphicsSplit = 0; // Position in m_graphicsOrder where the tail command buffer takes over
+        uint32_t m_graphicsFamily = VK_QUEUE_FAMILY_IGNORED;
+        uint32_t m_computeFamily = VK_QUEUE_FAMILY_IGNORED;
+        std::unordered_set<std::string> m_exports;
+        RGResourceHandle m_backBuffer = INVALID_RESOURCE;
+        bool m_compiled = false;
+        bool m_topologyDirty = false;
+        std::vector<VkCommandBuffer> m_secondaryBuffers; // Per pass, parallel recording only
+        std::vector<VkImageMemoryBarrier2> m_imageBarriers;   // Scratch for recordBarriers
+        std::vector<VkBufferMemoryBarrier2> m_bufferBarriers;
     };
 }
\ No newline at end of file
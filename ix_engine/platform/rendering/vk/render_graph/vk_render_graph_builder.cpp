@@ -16,14 +16,61 @@ namespace ix
     {
     }
 
-    void RenderGraphBuilder::write(const std::string& name) 
+    RGResourceview RenderGraphBuilder::request(const std::string& name, AccessType access, ResourceUsage usage)
     {
-        m_currentPassRequests.emplace_back(name, AccessType::Write, m_passType);
+        // The producer may be set up after this pass, the name only gets a handle here.
+        // Compile reports names nothing declared
+        RGResourceHandle handle = m_registry.reserve(name);
+        m_currentPassRequests.emplace_back(name, handle, access, m_passType, usage);
+        return { handle, m_registry.getResourceState(handle).type };
     }
 
-    void RenderGraphBuilder::read(const std::string& name) 
+    RGResourceview RenderGraphBuilder::write(const std::string& name, ResourceUsage usage) 
     {
-        m_currentPassRequests.emplace_back(name, AccessType::Read, m_passType);
+        return request(name, AccessType::Write, usage);
+    }
+
+    RGResourceview RenderGraphBuilder::read(const std::string& name, ResourceUsage usage, uint32_t framesAgo) 
+    {
+        if (framesAgo == 0) return request(name, AccessType::Read, usage);
+        return request(RenderGraphRegistry::historyName(name, framesAgo), AccessType::Read, usage);
+    }
+
+    void RenderGraphBuilder::setClearValue(RGResourceview view, const VkClearValue& value)
+    {
+        for (auto it = m_currentPassRequests.rbegin(); it != m_currentPassRequests.rend(); ++it)
+        {
+            if (it->handle != view.handle) continue;
+            it->clearValue = value;
+            return;
+        }
+        spdlog::warn("RenderGraphBuilder: Clear value for a resource the pass doesn't use");
+    }
+
+    RGResourceview RenderGraphBuilder::createImage(const std::string& name, const RGImageDesc& desc)
+    {
+        return { m_registry.registerTransientImage(name, desc), RGResourceType::Image };
+    }
+
+    RGResourceview RenderGraphBuilder::createBuffer(const std::string& name, const RGBufferDesc& desc)
+    {
+        return { m_registry.registerTransientBuffer(name, desc), RGResourceType::Buffer };
+    }
+
+    RGResourceview RenderGraphBuilder::writeVirtual(const std::string& name)
+    {
+        m_registry.registerVirtualResource(name);
+        return write(name);
+    }
+
+    void RenderGraphBuilder::useAsyncCompute()
+    {
+        if (m_passType != PassType::Compute)
+        {
+            spdlog::warn("RenderGraphBuilder: Only compute passes can run on the async compute queue");
+            return;
+        }
+        m_asyncCompute = true;
     }
 
     void RenderGraphBuilder::importExternalImage(const std::string& name, VulkanImage* image) 
@@ -1,13 +1,14 @@
 // vk_render_graph_builder.h
 #pragma once
+#include <optional>
 #include <string>
 #include <vector>
 #include "global_common/ix_global_pods.h"
 #include "render_graph_pass_i.h"
+#include "vk_render_graph_registry.h"
 
 namespace ix 
 {
-    class RenderGraphRegistry;
     class VulkanImage;
 
     enum class AccessType { 
@@ -15,10 +16,28 @@ namespace ix
         Write 
     };
 
+    // How a pass touches a resource. Together with the pass type this gives the exact
+    // stages, access masks and image layout the graph synchronizes against
+    enum class ResourceUsage : uint32_t {
+        Default         = 0,      // Attachment for graphics images, sampled/storage otherwise
+        ColorAttachment = 1 << 0,
+        DepthAttachment = 1 << 1,
+        Sampled         = 1 << 2,
+        Storage         = 1 << 3,
+        IndirectArgs    = 1 << 4,
+        TransferDst     = 1 << 5,  // vkCmdUpdateBuffer/vkCmdFillBuffer inside the pass
+    };
+
+    inline ResourceUsage operator|(ResourceUsage a, ResourceUsage b) { return static_cast<ResourceUsage>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b)); }
+    inline bool hasUsage(ResourceUsage usage, ResourceUsage flag) { return (static_cast<uint32_t>(usage) & static_cast<uint32_t>(flag)) != 0; }
+
     struct ResourceRequest {
         std::string name;
+        RGResourceHandle handle; // Reserved on first mention, compile checks it was declared
         AccessType access;
         PassType passType;
+        ResourceUsage usage = ResourceUsage::Default;
+        std::optional<VkClearValue> clearValue; // Attachments: clear instead of discard on first use
     };
 
     class RenderGraphBuilder 
@@ -30,16 +49,38 @@ namespace ix
             const RenderGraphCompileConfig& config,
             PassType passType);
 
-        void write(const std::string& name);
-        void read(const std::string& name);
+        // The returned views are what execute() looks resources up with. A resource has to be imported or
+        // declared by some pass by the time the graph compiles, in any addPass order. The view's type is
+        // only known once declared, so a pass set up before the producer gets Image for a buffer
+        RGResourceview write(const std::string& name, ResourceUsage usage = ResourceUsage::Default);
+        // framesAgo > 0 reads an older copy of a resource created with historyFrames >= framesAgo.
+        // It orders nothing: the copy was written in an earlier frame, and is undefined until then
+        RGResourceview read(const std::string& name, ResourceUsage usage = ResourceUsage::Default, uint32_t framesAgo = 0);
+        // The graph begins rendering around graphics passes. An attachment's first use in the frame
+        // clears it with this value; without one, contents that don't survive the frame are discarded
+        void setClearValue(RGResourceview view, const VkClearValue& value);
+        // Declares a graph-owned resource, backed by memory only between its first and last use.
+        // Its contents don't survive the frame, and the declaring pass still has to write it.
+        // With historyFrames set it gets memory of its own per copy instead, and survives that many frames
+        RGResourceview createImage(const std::string& name, const RGImageDesc& desc);
+        RGResourceview createBuffer(const std::string& name, const RGBufferDesc& desc);
+        // Declares and writes a resource with no physical backing, for work tracked outside the graph
+        RGResourceview writeVirtual(const std::string& name);
         void importExternalImage(const std::string& name, VulkanImage* image);
+        // Compute passes only: run on the dedicated compute queue, next to the graphics work.
+        // Falls back to the graphics queue when the device has none or the pass depends on graphics work
+        void useAsyncCompute();
+        bool usesAsyncCompute() const { return m_asyncCompute; }
         VulkanPipelineManager* getPipelineManager() const { return m_config.pipelineManager; }
         VulkanContext* getContext() const { return m_config.context; }
 
     private:
+        RGResourceview request(const std::string& name, AccessType access, ResourceUsage usage);
+
         RenderGraphRegistry& m_registry;
         std::vector<ResourceRequest>& m_currentPassRequests;
         const RenderGraphCompileConfig& m_config;
         PassType m_passType;
+        bool m_asyncCompute = false;
     };
 }
\ No newline at end of file
@@ -6,54 +6,162 @@
 
 namespace ix
 {
-    void RenderGraphRegistry::registerExternalImage(const std::string& name, VulkanImage* image)
+    static void resetSynchronization(ResourceState& state)
     {
-        auto& state = m_resources[name];
+        state.currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        state.writeStages = VK_PIPELINE_STAGE_2_NONE;
+        state.writeAccess = VK_ACCESS_2_NONE;
+        state.readStages = VK_PIPELINE_STAGE_2_NONE;
+        state.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+        state.visibleAccess = VK_ACCESS_2_NONE;
+    }
 
-        state.physicalImage = image;
-        if (image) {
-     
-            state.currentLayout = image->getLayout();
+    // Everything that belongs to the physical resource rather than to the name
+    static void moveContents(ResourceState& to, const ResourceState& from)
+    {
+        to.physicalImage = from.physicalImage;
+        to.physicalBuffer = from.physicalBuffer;
+        to.currentLayout = from.currentLayout;
+        to.writeStages = from.writeStages;
+        to.writeAccess = from.writeAccess;
+        to.readStages = from.readStages;
+        to.visibleStages = from.visibleStages;
+        to.visibleAccess = from.visibleAccess;
+    }
+
+    RGResourceHandle RenderGraphRegistry::reserve(const std::string& name)
+    {
+        auto [it, inserted] = m_handles.try_emplace(name, static_cast<RGResourceHandle>(m_resources.size()));
+        if (inserted)
+        {
+            m_resources.emplace_back();
+            m_resources.back().name = name;
         }
+        return it->second;
     }
-    void RenderGraphRegistry::registerExternalBuffer(const std::string& name, VulkanBuffer* buffer) 
+
+    RGResourceHandle RenderGraphRegistry::declare(const std::string& name, RGResourceType type)
     {
-        auto& state = m_resources[name];
-        state.physicalBuffer = buffer;
-        state.currentAccess = 0;
-        state.currentStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        RGResourceHandle handle = reserve(name);
+        m_resources[handle].type = type;
+        m_resources[handle].isDeclared = true;
+        return handle;
+    }
+
+    RGResourceHandle RenderGraphRegistry::registerExternalImage(const std::string& name, VulkanImage* image)
+    {
+        RGResourceHandle handle = declare(name, RGResourceType::Image);
+        bindImage(handle, image);
+        return handle;
+    }
+
+    RGResourceHandle RenderGraphRegistry::registerExternalBuffer(const std::string& name, VulkanBuffer* buffer)
+    {
+        RGResourceHandle handle = declare(name, RGResourceType::Buffer);
+        bindBuffer(handle, buffer);
+        return handle;
+    }
+
+    RGResourceHandle RenderGraphRegistry::registerVirtualResource(const std::string& name)
+    {
+        RGResourceHandle handle = declare(name, RGResourceType::Image);
+        m_resources[handle].isVirtual = true;
+        return handle;
+    }
+
+    RGResourceHandle RenderGraphRegistry::registerTransientImage(const std::string& name, const RGImageDesc& desc)
+    {
+        RGResourceHandle handle = declare(name, RGResourceType::Image);
+        std::vector<RGResourceHandle> history = declareHistory(name, desc.historyFrames, RGResourceType::Image);
+        auto& state = m_resources[handle];
+        state.transientImage = desc;
+        state.physicalImage = nullptr;
+        state.history = std::move(history);
+        resetSynchronization(state);
+        return handle;
+    }
+
+    RGResourceHandle RenderGraphRegistry::registerTransientBuffer(const std::string& name, const RGBufferDesc& desc)
+    {
+        RGResourceHandle handle = declare(name, RGResourceType::Buffer);
+        std::vector<RGResourceHandle> history = declareHistory(name, desc.historyFrames, RGResourceType::Buffer);
+        auto& state = m_resources[handle];
+        state.transientBuffer = desc;
+        state.physicalBuffer = nullptr;
+        state.history = std::move(history);
+        resetSynchronization(state);
+        return handle;
     }
 
-    ResourceState& RenderGraphRegistry::getResourceState(const std::string& name) 
+    std::vector<RGResourceHandle> RenderGraphRegistry::declareHistory(const std::string& name, uint32_t frames, RGResourceType type)
     {
-        if (m_resources.find(name) == m_resources.end()) {
-            spdlog::error("RenderGraphRegistry: Resource {} does not exist!", name);
+        std::vector<RGResourceHandle> history;
+        for (uint32_t framesAgo = 1; framesAgo <= frames; framesAgo++)
+        {
+            RGResourceHandle older = declare(historyName(name, framesAgo), type);
+            m_resources[older].physicalImage = nullptr;
+            m_resources[older].physicalBuffer = nullptr;
+            m_resources[older].isHistoryCopy = true;
+            resetSynchronization(m_resources[older]);
+            history.push_back(older);
         }
-        return m_resources[name];
+        return history;
     }
-    VulkanBuffer* RenderGraphRegistry::getBuffer(const std::string& name) 
+
+    void RenderGraphRegistry::rotateHistory(RGResourceHandle handle)
     {
-        if (m_resources.find(name) != m_resources.end()) {
-            return m_resources[name].physicalBuffer;
+        const std::vector<RGResourceHandle>& history = m_resources[handle].history;
+        if (history.empty()) return;
+
+        ResourceState oldest;
+        moveContents(oldest, m_resources[history.back()]);
+        for (size_t i = history.size() - 1; i > 0; i--)
+        {
+            moveContents(m_resources[history[i]], m_resources[history[i - 1]]);
         }
-        return nullptr;
+        moveContents(m_resources[history.front()], m_resources[handle]);
+        moveContents(m_resources[handle], oldest);
     }
 
-    VulkanImage* RenderGraphRegistry::getImage(const std::string& name) 
+    void RenderGraphRegistry::bindImage(RGResourceHandle handle, VulkanImage* image)
     {
-        if (m_resources.find(name) != m_resources.end()) {
-            return m_resources[name].physicalImage;
+        auto& state = m_resources[handle];
+
+        // A new image, or one transitioned outside the graph (present): wait on whatever used it
+        if (state.physicalImage != image || (image && image->getLayout() != state.currentLayout))
+        {
+            resetSynchronization(state);
+            state.writeStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
         }
-        return nullptr;
+
+        state.physicalImage = image;
+        if (image) {
+     
+            state.currentLayout = image->getLayout();
+        }
+    }
+
+    void RenderGraphRegistry::bindBuffer(RGResourceHandle handle, VulkanBuffer* buffer)
+    {
+        auto& state = m_resources[handle];
+        if (state.physicalBuffer != buffer) resetSynchronization(state);
+        state.physicalBuffer = buffer;
+    }
+
+    void RenderGraphRegistry::resetSyncState(RGResourceHandle handle)
+    {
+        resetSynchronization(m_resources[handle]);
     }
 
-    bool RenderGraphRegistry::exists(const std::string& name) const 
+    RGResourceHandle RenderGraphRegistry::getHandle(const std::string& name) const
     {
-        return m_resources.find(name) != m_resources.end();
+        auto it = m_handles.find(name);
+        return it != m_handles.end() ? it->second : INVALID_RESOURCE;
     }
 
     void RenderGraphRegistry::clearExternalResources() 
     {
         m_resources.clear();
+        m_handles.clear();
     }
-}
\ No newline at end of file
+}
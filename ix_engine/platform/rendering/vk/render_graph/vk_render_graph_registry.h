@@ -1,38 +1,102 @@
 // vk_render_graph_registry.h
 #pragma once
+#include <optional>
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <vulkan/vulkan.h>
+#include "render_graph_pass_i.h"
 
 namespace ix 
 {
     class VulkanImage;
     class VulkanBuffer;
 
+    // Graph-owned image, created at compile time. A zero extent follows the swapchain
+    struct RGImageDesc
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImageUsageFlags usage = 0;
+        VkExtent2D extent = { 0, 0 };
+        float scale = 1.0f; // Of the swapchain extent, when extent is zero
+        uint32_t historyFrames = 0; // Previous frames kept readable, see RenderGraphBuilder::read
+    };
+
+    // Graph-owned device local buffer, created at compile time
+    struct RGBufferDesc
+    {
+        VkDeviceSize size = 0;
+        VkBufferUsageFlags usage = 0;
+        uint32_t historyFrames = 0;
+    };
+
     struct ResourceState 
     {
+        std::string name; // Debug output only
+        RGResourceType type = RGResourceType::Image;
         VulkanImage* physicalImage = nullptr;
         VulkanBuffer* physicalBuffer = nullptr;
         VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        VkAccessFlags currentAccess = 0;
-        VkPipelineStageFlags currentStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+        // Synchronization since the last write (or layout transition)
+        VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+        VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;    // Every stage that read it
+        VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE; // Stages a barrier already covered
+        VkAccessFlags2 visibleAccess = VK_ACCESS_2_NONE;
+
+        bool isDeclared = false; // False while only named by requests, compile rejects those
+        bool isVirtual = false; // Only orders passes, nothing to transition
+        std::optional<RGImageDesc> transientImage;   // Set for graph-owned resources
+        std::optional<RGBufferDesc> transientBuffer;
+        std::vector<RGResourceHandle> history;       // Graph-owned with history: the older copies, newest first
+        bool isHistoryCopy = false;                  // One of those older copies, read-only
+
+        // Graph-owned and gone after the frame. Resources with history keep their memory instead
+        bool isTransient() const { return (transientImage.has_value() || transientBuffer.has_value()) && history.empty(); }
+        bool hasHistory() const { return !history.empty(); }
     };
 
     class RenderGraphRegistry 
     {
     public:
-        void registerExternalImage(const std::string& name, VulkanImage* image);
-        void registerExternalBuffer(const std::string& name, VulkanBuffer* buffer);
+        // Declaring a resource gives it a handle, an index that stays valid until clearExternalResources
+        RGResourceHandle registerExternalImage(const std::string& name, VulkanImage* image);
+        RGResourceHandle registerExternalBuffer(const std::string& name, VulkanBuffer* buffer);
+        RGResourceHandle registerVirtualResource(const std::string& name);
+        // Physical resources are bound once the graph allocates them. With history, the older
+        // copies are declared too, named by historyName
+        RGResourceHandle registerTransientImage(const std::string& name, const RGImageDesc& desc);
+        RGResourceHandle registerTransientBuffer(const std::string& name, const RGBufferDesc& desc);
+        static std::string historyName(const std::string& name, uint32_t framesAgo) { return name + "[-" + std::to_string(framesAgo) + "]"; }
+
+        // Start of a frame: the oldest copy becomes the current one, every other copy moves a frame back.
+        // Physical resources travel with their synchronization state
+        void rotateHistory(RGResourceHandle handle);
+
+        // Rebind an already declared resource
+        void bindImage(RGResourceHandle handle, VulkanImage* image);
+        void bindBuffer(RGResourceHandle handle, VulkanBuffer* buffer);
+        // Forget every tracked access, for when something outside the graph already synchronized it
+        void resetSyncState(RGResourceHandle handle);
 
-        ResourceState& getResourceState(const std::string& name);
-        VulkanImage* getImage(const std::string& name);
-        VulkanBuffer* getBuffer(const std::string& name);
+        // Handle for a name that may be declared later, by a pass set up after the one asking
+        RGResourceHandle reserve(const std::string& name);
+        // INVALID_RESOURCE when nothing declared or reserved the name. Hashes, so setup and compile only
+        RGResourceHandle getHandle(const std::string& name) const;
+
+        ResourceState& getResourceState(RGResourceHandle handle) { return m_resources[handle]; }
+        VulkanImage* getImage(RGResourceview view) const { return m_resources[view.handle].physicalImage; }
+        VulkanBuffer* getBuffer(RGResourceview view) const { return m_resources[view.handle].physicalBuffer; }
+        uint32_t getResourceCount() const { return static_cast<uint32_t>(m_resources.size()); }
 
-        bool exists(const std::string& name) const;
         void clearExternalResources();
 
     private:
-        std::unordered_map<std::string, ResourceState> m_resources;
+        RGResourceHandle declare(const std::string& name, RGResourceType type);
+        std::vector<RGResourceHandle> declareHistory(const std::string& name, uint32_t frames, RGResourceType type);
+
+        std::vector<ResourceState> m_resources; // Indexed by handle
+        std::unordered_map<std::string, RGResourceHandle> m_handles;
     };
 }
-
@@ -0,0 +1,234 @@
+// vk_render_graph_transients.cpp
+#include "common/engine_pch.h"
+#include "vk_render_graph_transients.h"
+#include "vk_render_graph_registry.h"
+#include "platform/rendering/vk/vk_context.h"
+#include "platform/rendering/vk/vk_image.h"
+#include "platform/rendering/vk/vk_buffer.h"
+
+#include <vk_mem_alloc.h>
+
+namespace ix
+{
+    static VkExtent2D resolveExtent(const RGImageDesc& desc, VkExtent2D swapchainExtent)
+    {
+        if (desc.extent.width != 0 && desc.extent.height != 0) return desc.extent;
+        return {
+            std::max(1u, static_cast<uint32_t>(swapchainExtent.width * desc.scale)),
+            std::max(1u, static_cast<uint32_t>(swapchainExtent.height * desc.scale))
+        };
+    }
+
+    RenderGraphTransientPool::~RenderGraphTransientPool()
+    {
+        release();
+    }
+
+    void RenderGraphTransientPool::build(VulkanContext& context, RenderGraphRegistry& registry, const std::vector<TransientLifetime>& lifetimes,
+        const std::vector<RGResourceHandle>& historyResources, VkExtent2D swapchainExtent)
+    {
+        release();
+        m_context = &context;
+
+        for (RGResourceHandle resource : historyResources) createHistory(registry, resource, swapchainExtent);
+
+        struct Candidate
+        {
+            uint32_t lifetime = 0;
+            const RGImageDesc* image = nullptr;
+            const RGBufferDesc* buffer = nullptr;
+            VkExtent2D extent{};
+            VkMemoryRequirements requirements{};
+        };
+
+        struct Block
+        {
+            VkMemoryRequirements requirements{};
+            bool holdsImages = false;
+            std::vector<uint32_t> occupants; // Indices into candidates
+        };
+
+        std::vector<Candidate> candidates;
+        candidates.reserve(lifetimes.size());
+        VkDeviceSize requestedSize = 0;
+
+        for (uint32_t i = 0; i < lifetimes.size(); i++)
+        {
+            const ResourceState& state = registry.getResourceState(lifetimes[i].resource);
+
+            Candidate candidate;
+            candidate.lifetime = i;
+            if (state.transientImage)
+            {
+                candidate.image = &*state.transientImage;
+                candidate.extent = resolveExtent(*candidate.image, swapchainExtent);
+                candidate.requirements = VulkanImage::getMemoryRequirements(context, candidate.extent, candidate.image->format, candidate.image->usage);
+            }
+            else if (state.transientBuffer)
+            {
+                candidate.buffer = &*state.transientBuffer;
+                candidate.requirements = VulkanBuffer::getMemoryRequirements(context, candidate.buffer->size, candidate.buffer->usage);
+            }
+            else
+            {
+                continue;
+            }
+
+            requestedSize += candidate.requirements.size;
+            candidates.push_back(candidate);
+        }
+
+        // Biggest first, so smaller resources fit into the blocks that already exist
+        std::vector<uint32_t> bySize(candidates.size());
+        for (uint32_t i = 0; i < bySize.size(); i++) bySize[i] = i;
+        std::stable_sort(bySize.begin(), bySize.end(), [&](uint32_t a, uint32_t b) {
+            return candidates[a].requirements.size > candidates[b].requirements.size;
+            });
+
+        auto overlaps = [&](uint32_t a, uint32_t b) {
+            const TransientLifetime& first = lifetimes[candidates[a].lifetime];
+            const TransientLifetime& second = lifetimes[candidates[b].lifetime];
+            return first.first <= second.last && second.first <= first.last;
+            };
+
+        // Images and buffers get separate blocks, so buffer-image granularity never matters
+        std::vector<Block> blocks;
+        for (uint32_t index : bySize)
+        {
+            const Candidate& candidate = candidates[index];
+            const bool isImage = candidate.image != nullptr;
+
+            Block* target = nullptr;
+            for (auto& block : blocks)
+            {
+                if (block.holdsImages != isImage) continue;
+                if ((block.requirements.memoryTypeBits & candidate.requirements.memoryTypeBits) == 0) continue;
+
+                bool free = true;
+                for (uint32_t occupant : block.occupants)
+                {
+                    if (overlaps(occupant, index)) { free = false; break; }
+                }
+                if (free) { target = &block; break; }
+            }
+
+            if (!target)
+            {
+                blocks.push_back({ candidate.requirements, isImage, {} });
+                target = &blocks.back();
+            }
+            else
+            {
+                target->requirements.size = std::max(target->requirements.size, candidate.requirements.size);
+                target->requirements.alignment = std::max(target->requirements.alignment, candidate.requirements.alignment);
+                target->requirements.memoryTypeBits &= candidate.requirements.memoryTypeBits;
+            }
+            target->occupants.push_back(index);
+        }
+
+        for (auto& block : blocks)
+        {
+            VmaAllocationCreateInfo allocInfo{};
+            allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            VmaAllocationInfo allocationInfo{};
+            if (vmaAllocateMemory(context.getAllocator(), &block.requirements, &allocInfo, &allocation, &allocationInfo) != VK_SUCCESS)
+            {
+                throw std::runtime_error("RenderGraphTransientPool: Failed to allocate transient memory!");
+            }
+            m_memory.push_back(allocation);
+            m_allocatedSize += block.requirements.size;
+            // Counted once per block, the resources placed in it don't own their memory
+            context.getMemoryTracker().add(MemoryCategory::RenderTargets, allocationInfo.size);
+
+            // In first use order, each occupant takes the memory over from the one before it
+            std::sort(block.occupants.begin(), block.occupants.end(), [&](uint32_t a, uint32_t b) {
+                return lifetimes[candidates[a].lifetime].first < lifetimes[candidates[b].lifetime].first;
+                });
+
+            for (size_t i = 0; i < block.occupants.size(); i++)
+            {
+                const Candidate& candidate = candidates[block.occupants[i]];
+                const RGResourceHandle resource = lifetimes[candidate.lifetime].resource;
+                const uint32_t previous = block.occupants[(i + block.occupants.size() - 1) % block.occupants.size()];
+                m_predecessors[resource] = lifetimes[candidates[previous].lifetime].resource;
+
+                if (candidate.image)
+                {
+                    m_images.push_back(std::make_unique<VulkanImage>(context, candidate.extent, candidate.image->format, candidate.image->usage, allocation));
+                    registry.bindImage(resource, m_images.back().get());
+                }
+                else
+                {
+                    m_buffers.push_back(std::make_unique<VulkanBuffer>(context, candidate.buffer->size, candidate.buffer->usage, allocation));
+                    registry.bindBuffer(resource, m_buffers.back().get());
+                }
+            }
+        }
+
+        if (!historyResources.empty())
+        {
+            spdlog::info("RenderGraph: {} resources with history, {} KB", historyResources.size(), m_historySize / 1024);
+        }
+        if (!candidates.empty())
+        {
+            spdlog::info("RenderGraph: {} transient resources in {} memory blocks, {} KB ({} KB without aliasing)",
+                candidates.size(), blocks.size(), m_allocatedSize / 1024, requestedSize / 1024);
+        }
+    }
+
+    void RenderGraphTransientPool::createHistory(RenderGraphRegistry& registry, RGResourceHandle resource, VkExtent2D swapchainExtent)
+    {
+        // Copy the handles, binding goes through the registry
+        const ResourceState& state = registry.getResourceState(resource);
+        std::vector<RGResourceHandle> copies = state.history;
+        copies.insert(copies.begin(), resource);
+
+        for (RGResourceHandle copy : copies)
+        {
+            if (state.transientImage)
+            {
+                const RGImageDesc& desc = *state.transientImage;
+                const VkExtent2D extent = resolveExtent(desc, swapchainExtent);
+                m_images.push_back(std::make_unique<VulkanImage>(*m_context, extent, desc.format, desc.usage));
+                m_images.back()->setMemoryTag(MemoryCategory::RenderTargets);
+                m_historySize += VulkanImage::getMemoryRequirements(*m_context, extent, desc.format, desc.usage).size;
+                registry.bindImage(copy, m_images.back().get());
+            }
+            else
+            {
+                const RGBufferDesc& desc = *state.transientBuffer;
+                m_buffers.push_back(std::make_unique<VulkanBuffer>(*m_context, desc.size, 1, desc.usage, VMA_MEMORY_USAGE_GPU_ONLY));
+                m_buffers.back()->setMemoryTag(MemoryCategory::RenderTargets);
+                m_historySize += desc.size;
+                registry.bindBuffer(copy, m_buffers.back().get());
+            }
+        }
+    }
+
+    void RenderGraphTransientPool::release()
+    {
+        // Resources first, they are bound to the memory
+        m_images.clear();
+        m_buffers.clear();
+
+        for (VmaAllocation allocation : m_memory)
+        {
+            VmaAllocationInfo allocationInfo{};
+            vmaGetAllocationInfo(m_context->getAllocator(), allocation, &allocationInfo);
+            m_context->getMemoryTracker().remove(MemoryCategory::RenderTargets, allocationInfo.size);
+            vmaFreeMemory(m_context->getAllocator(), allocation);
+        }
+        m_memory.clear();
+        m_predecessors.clear();
+        m_allocatedSize = 0;
+        m_historySize = 0;
+    }
+
+    RGResourceHandle RenderGraphTransientPool::getAliasPredecessor(RGResourceHandle resource) const
+    {
+        auto it = m_predecessors.find(resource);
+        return it != m_predecessors.end() ? it->second : resource;
+    }
+}
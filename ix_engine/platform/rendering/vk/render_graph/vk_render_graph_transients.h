@@ -0,0 +1,62 @@
+// vk_render_graph_transients.h
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "render_graph_pass_i.h"
+
+struct VmaAllocation_T;
+typedef struct VmaAllocation_T* VmaAllocation;
+
+namespace ix
+{
+    class VulkanContext;
+    class VulkanImage;
+    class VulkanBuffer;
+    class RenderGraphRegistry;
+    struct RGImageDesc;
+
+    // Positions in the execution order between which a transient resource is alive
+    struct TransientLifetime
+    {
+        RGResourceHandle resource = INVALID_RESOURCE;
+        uint32_t first = 0;
+        uint32_t last = 0;
+    };
+
+    // Owns the render graph's transient images and buffers. Resources whose lifetimes don't overlap
+    // share a memory block, so a block is only as large as its biggest occupant.
+    class RenderGraphTransientPool
+    {
+    public:
+        RenderGraphTransientPool() = default;
+        ~RenderGraphTransientPool();
+
+        RenderGraphTransientPool(const RenderGraphTransientPool&) = delete;
+        RenderGraphTransientPool& operator=(const RenderGraphTransientPool&) = delete;
+
+        // Replaces the previous resources and binds the new ones in the registry. The GPU must be idle.
+        // Resources with history get a dedicated allocation per copy, they outlive the frame
+        void build(VulkanContext& context, RenderGraphRegistry& registry, const std::vector<TransientLifetime>& lifetimes,
+            const std::vector<RGResourceHandle>& historyResources, VkExtent2D swapchainExtent);
+        void release();
+
+        // The resource that last used this one's memory before its first use in a frame.
+        // Itself when it has a block alone, since the previous frame then used it last
+        RGResourceHandle getAliasPredecessor(RGResourceHandle resource) const;
+
+        VkDeviceSize getAllocatedSize() const { return m_allocatedSize; }
+
+    private:
+        void createHistory(RenderGraphRegistry& registry, RGResourceHandle resource, VkExtent2D swapchainExtent);
+
+        VulkanContext* m_context = nullptr;
+        std::vector<std::unique_ptr<VulkanImage>> m_images;
+        std::vector<std::unique_ptr<VulkanBuffer>> m_buffers;
+        std::vector<VmaAllocation> m_memory;
+        std::unordered_map<RGResourceHandle, RGResourceHandle> m_predecessors;
+        VkDeviceSize m_allocatedSize = 0; // Aliased blocks only
+        VkDeviceSize m_historySize = 0;
+    };
+}
@@ -5,6 +5,18 @@
 
 namespace ix 
 {
+    // With async compute both queues touch buffers, concurrent sharing spares them ownership transfers
+    static void setSharingMode(VkBufferCreateInfo& bufferInfo, const VulkanContext& context, uint32_t (&families)[2])
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (!context.hasAsyncCompute()) return;
+
+        families[0] = context.getGraphicsFamily();
+        families[1] = context.getComputeFamily();
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = families;
+    }
 
     VulkanBuffer::VulkanBuffer(VulkanContext& context,
         VkDeviceSize instanceSize,
@@ -20,15 +32,58 @@ namespace ix
         VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
         bufferInfo.size = m_bufferSize;
         bufferInfo.usage = usageFlags;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        uint32_t families[2];
+        setSharingMode(bufferInfo, m_context, families);
 
         VmaAllocationCreateInfo vmaAllocInfo{};
         vmaAllocInfo.usage = memoryUsage;
         vmaAllocInfo.flags = allocFlags;
 
-        if (vmaCreateBuffer(m_allocator, &bufferInfo, &vmaAllocInfo, &m_buffer, &m_allocation, nullptr) != VK_SUCCESS) {
+        VmaAllocationInfo allocationInfo{};
+        if (vmaCreateBuffer(m_allocator, &bufferInfo, &vmaAllocInfo, &m_buffer, &m_allocation, &allocationInfo) != VK_SUCCESS) {
             throw std::runtime_error("VulkanBuffer: Failed to create buffer!");
         }
+
+        // Upload sources default to staging, everything else gets tagged by its owner
+        m_category = usageFlags == VK_BUFFER_USAGE_TRANSFER_SRC_BIT ? MemoryCategory::Staging : MemoryCategory::Other;
+        m_allocationSize = allocationInfo.size;
+        m_context.getMemoryTracker().add(m_category, m_allocationSize);
+    }
+
+    VulkanBuffer::VulkanBuffer(VulkanContext& context, VkDeviceSize size, VkBufferUsageFlags usageFlags, VmaAllocation memory)
+        : m_context(context), m_bufferSize(size), m_instanceSize(size)
+    {
+        m_allocator = m_context.getAllocator();
+
+        VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size = m_bufferSize;
+        bufferInfo.usage = usageFlags;
+        uint32_t families[2];
+        setSharingMode(bufferInfo, m_context, families);
+
+        if (vkCreateBuffer(m_context.device(), &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+            throw std::runtime_error("VulkanBuffer: Failed to create aliased buffer!");
+        }
+        // m_allocation stays null, so the destructor leaves the memory alone
+        if (vmaBindBufferMemory(m_allocator, memory, m_buffer) != VK_SUCCESS) {
+            throw std::runtime_error("VulkanBuffer: Failed to bind aliased buffer memory!");
+        }
+    }
+
+    VkMemoryRequirements VulkanBuffer::getMemoryRequirements(VulkanContext& context, VkDeviceSize size, VkBufferUsageFlags usageFlags)
+    {
+        VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size = size;
+        bufferInfo.usage = usageFlags;
+        uint32_t families[2];
+        setSharingMode(bufferInfo, context, families);
+
+        VkDeviceBufferMemoryRequirements query{ VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS };
+        query.pCreateInfo = &bufferInfo;
+
+        VkMemoryRequirements2 requirements{ VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+        vkGetDeviceBufferMemoryRequirements(context.device(), &query, &requirements);
+        return requirements.memoryRequirements;
     }
 
     VulkanBuffer::~VulkanBuffer() 
@@ -39,6 +94,7 @@ namespace ix
                 unmap();
             }
             vmaDestroyBuffer(m_allocator, m_buffer, m_allocation);
+            if (m_allocationSize > 0) m_context.getMemoryTracker().remove(m_category, m_allocationSize);
 
             m_buffer = VK_NULL_HANDLE;
             m_allocation = VK_NULL_HANDLE;
@@ -58,6 +114,11 @@ namespace ix
         }
     }
 
+    void VulkanBuffer::invalidate(VkDeviceSize size, VkDeviceSize offset)
+    {
+        vmaInvalidateAllocation(m_allocator, m_allocation, offset, size);
+    }
+
     void VulkanBuffer::writeToBuffer(void* data, VkDeviceSize size, VkDeviceSize offset) 
     {
         if (size == VK_WHOLE_SIZE) {
@@ -112,6 +173,20 @@ namespace ix
             });
     }
 
+    void VulkanBuffer::setMemoryTag(MemoryCategory category, const char* name)
+    {
+        if (m_allocation == VK_NULL_HANDLE) return;
+
+        if (category != m_category)
+        {
+            VulkanMemoryTracker& tracker = m_context.getMemoryTracker();
+            tracker.remove(m_category, m_allocationSize);
+            tracker.add(category, m_allocationSize);
+            m_category = category;
+        }
+        if (name) vmaSetAllocationName(m_allocator, m_allocation, name);
+    }
+
     VkBuffer VulkanBuffer::getBuffer() const 
     {
         return m_buffer;
@@ -2,6 +2,7 @@
 #pragma once
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
+#include "vk_memory_tracker.h"
 
 namespace ix
 {
@@ -18,6 +19,10 @@ namespace ix
             VmaMemoryUsage memoryUsage,
             VmaAllocationCreateFlags allocFlags = 0);
 
+        // Placed in memory owned by someone else (render graph aliasing), destroyed without freeing it
+        VulkanBuffer(VulkanContext& context, VkDeviceSize size, VkBufferUsageFlags usageFlags, VmaAllocation memory);
+        static VkMemoryRequirements getMemoryRequirements(VulkanContext& context, VkDeviceSize size, VkBufferUsageFlags usageFlags);
+
         ~VulkanBuffer();
 
         VulkanBuffer(const VulkanBuffer&) = delete;
@@ -30,6 +35,8 @@ namespace ix
 
         VkResult map(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
         void unmap();
+        // Makes GPU writes visible to a mapped pointer on non-coherent memory
+        void invalidate(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
 
         void writeToBuffer(void* data, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
         void uploadData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
@@ -41,6 +48,10 @@ namespace ix
 
         VkBuffer getBuffer() const;
         VkDeviceSize getBufferSize() const { return m_bufferSize; }
+        void* getMappedData() const { return m_mappedPtr; }
+
+        // Moves the allocation to another memory category and names it in VMA's statistics
+        void setMemoryTag(MemoryCategory category, const char* name = nullptr);
 
     private:
         VulkanContext& m_context;
@@ -52,5 +63,8 @@ namespace ix
         void* m_mappedPtr = nullptr;
         VkDeviceSize m_bufferSize;
         VkDeviceSize m_instanceSize;
+
+        MemoryCategory m_category = MemoryCategory::Other;
+        VkDeviceSize m_allocationSize = 0; // Zero when the memory belongs to someone else
     };
 }
\ No newline at end of file
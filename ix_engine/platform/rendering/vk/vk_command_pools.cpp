@@ -0,0 +1,80 @@
+// vk_command_pools.cpp
+#include "common/engine_pch.h"
+#include "vk_command_pools.h"
+#include "vk_context.h"
+#include "core/job_system.h"
+
+namespace ix
+{
+    VulkanCommandPools::VulkanCommandPools(VulkanContext& context, uint32_t threadCount, uint32_t framesInFlight)
+        : m_context(context), m_threadCount(threadCount), m_framesInFlight(framesInFlight)
+    {
+        VkCommandPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+        poolInfo.queueFamilyIndex = m_context.getGraphicsFamily();
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        m_pools.resize(size_t(m_threadCount) * m_framesInFlight);
+        for (auto& threadPool : m_pools)
+        {
+            if (vkCreateCommandPool(m_context.device(), &poolInfo, nullptr, &threadPool.pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("VulkanCommandPools: Failed to create command pool!");
+            }
+        }
+    }
+
+    VulkanCommandPools::~VulkanCommandPools()
+    {
+        // Destroying a pool frees its buffers
+        for (auto& threadPool : m_pools) vkDestroyCommandPool(m_context.device(), threadPool.pool, nullptr);
+    }
+
+    void VulkanCommandPools::resetFrame(uint32_t frameIndex)
+    {
+        for (uint32_t thread = 0; thread < m_threadCount; thread++)
+        {
+            ThreadPool& threadPool = m_pools[size_t(frameIndex) * m_threadCount + thread];
+            if (threadPool.used == 0) continue;
+
+            vkResetCommandPool(m_context.device(), threadPool.pool, 0);
+            threadPool.used = 0;
+        }
+    }
+
+    VkCommandBuffer VulkanCommandPools::beginSecondary(uint32_t frameIndex)
+    {
+        const uint32_t thread = JobSystem::getCurrentThreadIndex();
+        if (thread >= m_threadCount)
+        {
+            throw std::runtime_error("VulkanCommandPools: Secondary buffers must be recorded on a job system thread!");
+        }
+
+        ThreadPool& threadPool = m_pools[size_t(frameIndex) * m_threadCount + thread];
+        if (threadPool.used == threadPool.buffers.size())
+        {
+            VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            allocInfo.commandPool = threadPool.pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer buffer;
+            if (vkAllocateCommandBuffers(m_context.device(), &allocInfo, &buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("VulkanCommandPools: Failed to allocate secondary command buffer!");
+            }
+            threadPool.buffers.push_back(buffer);
+        }
+
+        VkCommandBuffer cmd = threadPool.buffers[threadPool.used++];
+
+        // Passes open their own dynamic rendering scope, nothing is inherited
+        VkCommandBufferInheritanceInfo inheritance{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+
+        VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+        vkBeginCommandBuffer(cmd, &beginInfo);
+
+        return cmd;
+    }
+}
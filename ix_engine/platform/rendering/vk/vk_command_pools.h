@@ -0,0 +1,42 @@
+// vk_command_pools.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace ix
+{
+    class VulkanContext;
+
+    // One command pool per (frame in flight, job system thread), so secondary command buffers can be
+    // recorded on any job thread without locking. Buffers are kept and reused across frames.
+    class VulkanCommandPools
+    {
+    public:
+        VulkanCommandPools(VulkanContext& context, uint32_t threadCount, uint32_t framesInFlight);
+        ~VulkanCommandPools();
+
+        VulkanCommandPools(const VulkanCommandPools&) = delete;
+        VulkanCommandPools& operator=(const VulkanCommandPools&) = delete;
+
+        // Recycles every buffer of the frame. Only once the frame's fence has signalled
+        void resetFrame(uint32_t frameIndex);
+
+        // Begins a secondary buffer from the calling thread's pool. Must run on a job system thread
+        VkCommandBuffer beginSecondary(uint32_t frameIndex);
+
+        uint32_t getThreadCount() const { return m_threadCount; }
+
+    private:
+        struct ThreadPool
+        {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> buffers;
+            uint32_t used = 0;
+        };
+
+        VulkanContext& m_context;
+        uint32_t m_threadCount;
+        uint32_t m_framesInFlight;
+        std::vector<ThreadPool> m_pools; // [frame * m_threadCount + thread]
+    };
+}
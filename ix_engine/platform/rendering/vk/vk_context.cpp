@@ -1,6 +1,7 @@
 #include "common/engine_pch.h"
 #include "vk_context.h"
 #include "vk_instance.h"
+#include "vk_memory_tracker.h"
 #include "window_i.h"
 
 #include <set>
@@ -13,10 +14,11 @@ namespace ix
 
     VulkanContext::VulkanContext(VulkanInstance& instance, Window_I& window)
         : m_window(window) 
+        , m_headless(window.isHeadless())
         , m_instanceHandle(instance.get())
     {
 
-        createSurface(instance.get());
+        if (!m_headless) createSurface(instance.get());
         pickPhysicalDevice(instance.get());
         checkCapabilities();
         createLogicalDevice();
@@ -27,6 +29,7 @@ namespace ix
     VulkanContext::~VulkanContext()
     {
         if (m_immCommandPool != VK_NULL_HANDLE) vkDestroyCommandPool(m_logicalDevice, m_immCommandPool, nullptr);
+        m_memoryTracker.reset();
         if (m_allocator) vmaDestroyAllocator(m_allocator);
         if (m_logicalDevice) vkDestroyDevice(m_logicalDevice, nullptr);
         if (m_surface) vkDestroySurfaceKHR(m_instanceHandle, m_surface, nullptr);
@@ -51,10 +54,12 @@ namespace ix
         allocatorInfo.device = m_logicalDevice;
         allocatorInfo.instance = instance;
         allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+        if (m_capabilities.hasMemoryBudget) allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
 
         if (vmaCreateAllocator(&allocatorInfo, &m_allocator) != VK_SUCCESS) {
             throw std::runtime_error("VulkanContext: Failed to create VMA allocator!");
         }
+        m_memoryTracker = std::make_unique<VulkanMemoryTracker>(m_allocator);
     }
 
     void VulkanContext::pickPhysicalDevice(VkInstance instance) 
@@ -95,12 +100,16 @@ namespace ix
     {
         // Feature structures
         VkPhysicalDeviceVulkan13Features features13{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES };
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+        VkPhysicalDeviceHostQueryResetFeatures hostQueryReset{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES };
         VkPhysicalDeviceDescriptorIndexingFeatures indexing{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES };
         VkPhysicalDeviceFeatures2 features2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
 
         // Build pNext chain to query everything at once
         features2.pNext = &indexing;
-        indexing.pNext = &features13;
+        indexing.pNext = &timeline;
+        timeline.pNext = &hostQueryReset;
+        hostQueryReset.pNext = &features13;
 
         if (m_physicalDevice == VK_NULL_HANDLE) return;
 
@@ -111,6 +120,20 @@ namespace ix
 
         m_capabilities.hasMultiDrawIndirect = (features2.features.multiDrawIndirect == VK_TRUE);
 
+        m_capabilities.hasTimelineSemaphores = (timeline.timelineSemaphore == VK_TRUE);
+
+        m_capabilities.hasPipelineStatistics = (features2.features.pipelineStatisticsQuery == VK_TRUE);
+        m_capabilities.hasHostQueryReset = (hostQueryReset.hostQueryReset == VK_TRUE);
+
+        // Optional, the driver's heap budgets instead of VMA's estimate
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, extensions.data());
+        m_capabilities.hasMemoryBudget = std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties& extension) {
+            return strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0;
+            });
+
         m_capabilities.hasBindlessIndexing = (indexing.runtimeDescriptorArray == VK_TRUE &&
             indexing.descriptorBindingPartiallyBound == VK_TRUE);
 
@@ -118,12 +141,17 @@ namespace ix
         VkPhysicalDeviceProperties props;
         vkGetPhysicalDeviceProperties(m_physicalDevice, &props);
         m_capabilities.maxAnisotropy = props.limits.maxSamplerAnisotropy;
+        m_capabilities.timestampPeriod = props.limits.timestampComputeAndGraphics ? props.limits.timestampPeriod : 0.0f;
 
         // Log the results
         spdlog::info("Vulkan Capabilities Check:");
         spdlog::info("  Dynamic Rendering: {}", m_capabilities.hasDynamicRendering);
         spdlog::info("  Multi-Draw Indirect: {}", m_capabilities.hasMultiDrawIndirect);
         spdlog::info("  Bindless Indexing: {}", m_capabilities.hasBindlessIndexing);
+        spdlog::info("  Timeline Semaphores: {}", m_capabilities.hasTimelineSemaphores);
+        spdlog::info("  Pipeline Statistics: {}", m_capabilities.hasPipelineStatistics);
+        spdlog::info("  Host Query Reset: {}", m_capabilities.hasHostQueryReset);
+        spdlog::info("  Memory Budget: {}", m_capabilities.hasMemoryBudget);
     }
 
     void VulkanContext::createLogicalDevice() 
@@ -133,6 +161,10 @@ namespace ix
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = { m_queueFamilyIndices.graphicsFamily, m_queueFamilyIndices.presentFamily };
 
+        // Async compute is only worth it on a separate family, and without timelines we can't sync it
+        const bool useAsyncCompute = m_queueFamilyIndices.computeFamilyHasValue && m_capabilities.hasTimelineSemaphores;
+        if (useAsyncCompute) uniqueQueueFamilies.insert(m_queueFamilyIndices.computeFamily);
+
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies) {
             VkDeviceQueueCreateInfo qci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
@@ -147,9 +179,18 @@ namespace ix
         features13.dynamicRendering = m_capabilities.hasDynamicRendering;
         features13.synchronization2 = VK_TRUE;
 
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+        timeline.pNext = &features13;
+        timeline.timelineSemaphore = m_capabilities.hasTimelineSemaphores;
+
+        // Resetting queries from the CPU keeps the GPU profiler out of the command buffers
+        VkPhysicalDeviceHostQueryResetFeatures hostQueryReset{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES };
+        hostQueryReset.pNext = &timeline;
+        hostQueryReset.hostQueryReset = m_capabilities.hasHostQueryReset;
+
         // Enable Descriptor Indexing (Bindless)
         VkPhysicalDeviceDescriptorIndexingFeatures indexing{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES };
-        indexing.pNext = &features13;
+        indexing.pNext = &hostQueryReset;
         if (m_capabilities.hasBindlessIndexing) {
             indexing.runtimeDescriptorArray = VK_TRUE;
             indexing.descriptorBindingPartiallyBound = VK_TRUE;
@@ -163,6 +204,7 @@ namespace ix
         deviceFeatures.pNext = &indexing;
         deviceFeatures.features.samplerAnisotropy = VK_TRUE;
         deviceFeatures.features.multiDrawIndirect = m_capabilities.hasMultiDrawIndirect;
+        deviceFeatures.features.pipelineStatisticsQuery = m_capabilities.hasPipelineStatistics;
 
         VkDeviceCreateInfo dci{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
         dci.pNext = &deviceFeatures;
@@ -179,6 +221,12 @@ namespace ix
 
         vkGetDeviceQueue(m_logicalDevice, m_queueFamilyIndices.graphicsFamily, 0, &m_graphicsQueue);
         vkGetDeviceQueue(m_logicalDevice, m_queueFamilyIndices.presentFamily, 0, &m_presentQueue);
+
+        if (useAsyncCompute)
+        {
+            vkGetDeviceQueue(m_logicalDevice, m_queueFamilyIndices.computeFamily, 0, &m_computeQueue);
+            spdlog::info("Vulkan: Async compute on queue family {}", m_queueFamilyIndices.computeFamily);
+        }
     }
 
     QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) const
@@ -190,19 +238,28 @@ namespace ix
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
         for (uint32_t i = 0; i < queueFamilies.size(); i++) {
-            if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                indices.graphicsFamily = i;
-                indices.graphicsFamilyHasValue = true;
-            }
+            if (!indices.isComplete()) {
+                if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                    indices.graphicsFamily = i;
+                    indices.graphicsFamilyHasValue = true;
+                }
 
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
-            if (presentSupport) {
-                indices.presentFamily = i;
-                indices.presentFamilyHasValue = true; 
+                // Headless never presents, the graphics family stands in so the rest of the setup is unchanged
+                VkBool32 presentSupport = false;
+                if (m_headless) presentSupport = indices.graphicsFamilyHasValue;
+                else vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+                if (presentSupport) {
+                    indices.presentFamily = i;
+                    indices.presentFamilyHasValue = true; 
+                }
             }
 
-            if (indices.isComplete()) break;
+            if (!indices.computeFamilyHasValue &&
+                (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+                !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                indices.computeFamily = i;
+                indices.computeFamilyHasValue = true;
+            }
         }
         return indices;
     }
@@ -214,9 +271,9 @@ namespace ix
 
         QueueFamilyIndices indices = findQueueFamilies(device);
         bool extensionsSupported = checkDeviceExtensionSupport(device);
-        bool swapChainAdequate = false;
+        bool swapChainAdequate = m_headless;
 
-        if (extensionsSupported) {
+        if (extensionsSupported && !m_headless) {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
         }
@@ -274,6 +331,7 @@ namespace ix
         std::vector<VkExtensionProperties> availableExtensions(extensionCount);
         vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
         std::set<std::string> requiredExtensions(m_deviceExtensions.begin(), m_deviceExtensions.end());
+        if (m_headless) requiredExtensions.erase(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
         for (const auto& extension : availableExtensions) {
             requiredExtensions.erase(extension.extensionName);
         }
@@ -296,6 +354,8 @@ namespace ix
         uint32_t minor = VK_API_VERSION_MINOR(props.apiVersion);
 
         for (const char* extName : m_deviceExtensions) {
+            if (m_headless && strcmp(extName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0) continue;
+
             // Check if the extension is available on this hardware
             bool found = false;
             for (const auto& available : availableExtensions) {
@@ -323,6 +383,8 @@ namespace ix
             }
         }
 
+        if (m_capabilities.hasMemoryBudget) activeExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
         return activeExtensions;
     }
 
@@ -345,6 +407,8 @@ namespace ix
             return;
         }
 
+        std::lock_guard<std::mutex> immLock(m_immMutex);
+
         VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandPool = m_immCommandPool;
@@ -371,7 +435,10 @@ namespace ix
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &cmd;
 
-        vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, fence);
+        {
+            std::lock_guard<std::mutex> queueLock(m_queueMutex);
+            vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, fence);
+        }
 
         // Wait for the fence (more robust than QueueWaitIdle)
         vkWaitForFences(m_logicalDevice, 1, &fence, VK_TRUE, UINT64_MAX);
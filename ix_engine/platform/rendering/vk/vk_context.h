@@ -2,6 +2,8 @@
 #pragma once
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <memory>
+#include <mutex>
 
 
 struct VmaAllocator_T;
@@ -12,6 +14,7 @@ namespace ix
 {
 
     class VulkanInstance;
+    class VulkanMemoryTracker;
     struct Window_I;
 
 
@@ -21,7 +24,12 @@ namespace ix
         bool hasBindlessIndexing = false;
         bool hasMultiDrawIndirect = false;
         bool hasRayTracing = false;
+        bool hasTimelineSemaphores = false;
+        bool hasPipelineStatistics = false;
+        bool hasHostQueryReset = false;
+        bool hasMemoryBudget = false;
         float maxAnisotropy = 1.0f;
+        float timestampPeriod = 0.0f; // Nanoseconds per tick, zero without timestamp support
     };
 
     struct SwapChainSupportDetails
@@ -35,8 +43,10 @@ namespace ix
     {
         uint32_t graphicsFamily;
         uint32_t presentFamily;
+        uint32_t computeFamily;  // Dedicated (no graphics bit), optional
         bool graphicsFamilyHasValue = false;
         bool presentFamilyHasValue = false;
+        bool computeFamilyHasValue = false;
         bool isComplete() const { return graphicsFamilyHasValue && presentFamilyHasValue; }
     };
 
@@ -46,14 +56,18 @@ namespace ix
         VulkanContext(VulkanInstance& instance, Window_I& window);
         ~VulkanContext();
 
-        // Public helper
+        // Public helper. Safe to call from any thread
         void immediateSubmit(std::function<void(VkCommandBuffer cmd)>&& func) const;
 
+        // Guards vkQueueSubmit/vkQueuePresentKHR, the graphics queue is shared between threads
+        std::mutex& getQueueMutex() const { return m_queueMutex; }
+
 
         // Getters and setters
         VkDevice device() const { return m_logicalDevice; }
         VkPhysicalDevice physicalDevice() const { return m_physicalDevice; }
         VkSurfaceKHR surface() const { return m_surface; }
+        bool isHeadless() const { return m_headless; } // No surface, no present queue, no swapchain extension
         VkQueue graphicsQueue() const { return m_graphicsQueue; }
         const VulkanCapabilities& getCaps() const { return m_capabilities; }
         VkCommandPool getImmCommandPool() const { return m_immCommandPool; }
@@ -63,7 +77,13 @@ namespace ix
         uint32_t getGraphicsFamily() const { return m_queueFamilyIndices.graphicsFamily; }
         VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
         VkQueue getPresentQueue() const { return m_presentQueue; }
+
+        // Async compute needs a dedicated compute family and timeline semaphores to sync it with graphics
+        bool hasAsyncCompute() const { return m_computeQueue != VK_NULL_HANDLE; }
+        uint32_t getComputeFamily() const { return m_queueFamilyIndices.computeFamily; }
+        VkQueue getComputeQueue() const { return m_computeQueue; }
         VmaAllocator getAllocator() const { return m_allocator; }
+        VulkanMemoryTracker& getMemoryTracker() const { return *m_memoryTracker; }
 
         VkFormat getSwapchainFormat() const { return m_swapchainFormat; }
         VkFormat getDepthFormat() const { return m_depthFormat; }
@@ -86,9 +106,11 @@ namespace ix
 
     private:
         Window_I& m_window;
+        bool m_headless = false;
         VkSurfaceKHR m_surface = VK_NULL_HANDLE;
         VkInstance m_instanceHandle;
         VmaAllocator m_allocator = VK_NULL_HANDLE;
+        std::unique_ptr<VulkanMemoryTracker> m_memoryTracker;
 
         VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
         VkDevice m_logicalDevice = VK_NULL_HANDLE;
@@ -97,8 +119,11 @@ namespace ix
         QueueFamilyIndices m_queueFamilyIndices;
         VkQueue m_graphicsQueue = VK_NULL_HANDLE;
         VkQueue m_presentQueue = VK_NULL_HANDLE;
+        VkQueue m_computeQueue = VK_NULL_HANDLE;
 
         VkCommandPool m_immCommandPool = VK_NULL_HANDLE;
+        mutable std::mutex m_immMutex;   // m_immCommandPool
+        mutable std::mutex m_queueMutex;
         void createImmCommandPool();
 
         VkFormat m_swapchainFormat = VK_FORMAT_UNDEFINED;
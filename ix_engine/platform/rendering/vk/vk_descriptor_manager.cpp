@@ -44,6 +44,7 @@ namespace ix
 
     bool VulkanDescriptorManager::allocate(VkDescriptorSet* set, VkDescriptorSetLayout layout) 
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
         if (m_currentPool == VK_NULL_HANDLE) {
             m_currentPool = getPool();
             m_usedPools.push_back(m_currentPool);
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include <deque>
+#include <mutex>
 
 namespace ix
 {
@@ -42,6 +43,7 @@ namespace ix
         VkDescriptorPool createPool(int count, PoolSizes sizes);
 
         VulkanContext& m_context;
+        std::mutex m_mutex; // allocate() is called from pass recording jobs
         VkDescriptorPool m_currentPool{ VK_NULL_HANDLE };
         PoolSizes m_poolSizes;
         std::vector<VkDescriptorPool> m_usedPools;
@@ -0,0 +1,280 @@
+// vk_gpu_profiler.cpp
+#include "common/engine_pch.h"
+#include "vk_gpu_profiler.h"
+#include "vk_context.h"
+#include "core/profiler.h"
+
+#include <nlohmann/json.hpp>
+
+namespace ix
+{
+    // Results come back in bit order
+    static constexpr VkQueryPipelineStatisticFlags STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+    static constexpr uint32_t STATISTICS_COUNT = 4;
+
+    static uint64_t timestampMask(uint32_t validBits)
+    {
+        if (validBits == 0) return 0;
+        return validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    }
+
+    bool VulkanGpuProfiler::isSupported(const VulkanContext& context)
+    {
+        return context.getCaps().timestampPeriod > 0.0f && context.getCaps().hasHostQueryReset;
+    }
+
+    VulkanGpuProfiler::VulkanGpuProfiler(VulkanContext& context, uint32_t framesInFlight)
+        : m_context(context)
+    {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice(), &familyCount, families.data());
+
+        m_timestampPeriod = context.getCaps().timestampPeriod;
+        m_graphicsMask = timestampMask(families[context.getGraphicsFamily()].timestampValidBits);
+        if (context.hasAsyncCompute()) m_computeMask = timestampMask(families[context.getComputeFamily()].timestampValidBits);
+        m_hasStatistics = context.getCaps().hasPipelineStatistics;
+
+        VkQueryPoolCreateInfo timestampInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        timestampInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        timestampInfo.queryCount = MAX_SCOPES * 2;
+
+        VkQueryPoolCreateInfo statisticsInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsInfo.queryCount = MAX_SCOPES;
+        statisticsInfo.pipelineStatistics = STATISTICS;
+
+        m_frames.resize(framesInFlight);
+        for (auto& frame : m_frames)
+        {
+            if (vkCreateQueryPool(context.device(), &timestampInfo, nullptr, &frame.timestamps) != VK_SUCCESS)
+            {
+                throw std::runtime_error("VulkanGpuProfiler: Failed to create timestamp query pool!");
+            }
+            if (m_hasStatistics && vkCreateQueryPool(context.device(), &statisticsInfo, nullptr, &frame.statistics) != VK_SUCCESS)
+            {
+                throw std::runtime_error("VulkanGpuProfiler: Failed to create pipeline statistics query pool!");
+            }
+
+            // Queries start out undefined, and a frame may not use every scope
+            vkResetQueryPool(context.device(), frame.timestamps, 0, MAX_SCOPES * 2);
+            if (frame.statistics) vkResetQueryPool(context.device(), frame.statistics, 0, MAX_SCOPES);
+            frame.scopes.resize(MAX_SCOPES);
+        }
+
+#if defined(IX_ENABLE_PROFILER)
+        calibrate();
+#endif
+    }
+
+    void VulkanGpuProfiler::calibrate()
+    {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        VkQueryPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = 1;
+        if (vkCreateQueryPool(m_context.device(), &poolInfo, nullptr, &pool) != VK_SUCCESS) return;
+        vkResetQueryPool(m_context.device(), pool, 0, 1);
+
+        // The timestamp lands somewhere between the two CPU reads, the midpoint is off by about a submit
+        const uint64_t before = Profiler::now();
+        m_context.immediateSubmit([pool](VkCommandBuffer cmd) {
+            vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, pool, 0);
+            });
+        const uint64_t after = Profiler::now();
+
+        uint64_t timestamp = 0;
+        if (vkGetQueryPoolResults(m_context.device(), pool, 0, 1, sizeof(timestamp), &timestamp, sizeof(timestamp),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS)
+        {
+            m_calibrationTimestamp = timestamp;
+            m_calibrationNs = before + (after - before) / 2;
+        }
+        vkDestroyQueryPool(m_context.device(), pool, nullptr);
+    }
+
+    uint64_t VulkanGpuProfiler::toProfilerNs(uint64_t timestamp, uint64_t mask) const
+    {
+        const uint64_t ticks = (timestamp - m_calibrationTimestamp) & mask;
+        return m_calibrationNs + static_cast<uint64_t>(double(ticks) * m_timestampPeriod);
+    }
+
+    VulkanGpuProfiler::~VulkanGpuProfiler()
+    {
+        stopCapture();
+        for (auto& frame : m_frames)
+        {
+            vkDestroyQueryPool(m_context.device(), frame.timestamps, nullptr);
+            if (frame.statistics) vkDestroyQueryPool(m_context.device(), frame.statistics, nullptr);
+        }
+    }
+
+    void VulkanGpuProfiler::beginFrame(uint32_t frameIndex)
+    {
+        m_currentFrame = frameIndex;
+        FrameQueries& frame = m_frames[frameIndex];
+        if (frame.pending)
+        {
+            collect(frame);
+            if (isCapturing()) writeCapture();
+
+            vkResetQueryPool(m_context.device(), frame.timestamps, 0, MAX_SCOPES * 2);
+            if (frame.statistics) vkResetQueryPool(m_context.device(), frame.statistics, 0, MAX_SCOPES);
+            for (auto& scope : frame.scopes) scope.recorded = false;
+        }
+        frame.pending = true;
+    }
+
+    void VulkanGpuProfiler::beginScope(VkCommandBuffer cmd, uint32_t scope, const std::string& name, bool asyncCompute)
+    {
+        if (scope >= MAX_SCOPES) return;
+        if (asyncCompute && m_computeMask == 0) return;
+
+        // Each scope has its own record, passes recorded on other threads never touch it
+        FrameQueries& frame = m_frames[m_currentFrame];
+        ScopeRecord& record = frame.scopes[scope];
+        if (record.name != name) record.name = name;
+        record.recorded = true;
+        record.asyncCompute = asyncCompute;
+        record.statistics = frame.statistics != VK_NULL_HANDLE && !asyncCompute; // Graphics queue only
+
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, frame.timestamps, scope * 2);
+        if (record.statistics) vkCmdBeginQuery(cmd, frame.statistics, scope, 0);
+    }
+
+    void VulkanGpuProfiler::endScope(VkCommandBuffer cmd, uint32_t scope)
+    {
+        if (scope >= MAX_SCOPES) return;
+
+        FrameQueries& frame = m_frames[m_currentFrame];
+        const ScopeRecord& record = frame.scopes[scope];
+        if (!record.recorded) return;
+
+        if (record.statistics) vkCmdEndQuery(cmd, frame.statistics, scope);
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, frame.timestamps, scope * 2 + 1);
+    }
+
+    void VulkanGpuProfiler::collect(FrameQueries& frame)
+    {
+        m_results.clear();
+        m_totalMs = 0.0;
+        m_frameNumber++;
+
+        for (uint32_t i = 0; i < MAX_SCOPES; i++)
+        {
+            const ScopeRecord& record = frame.scopes[i];
+            if (!record.recorded) continue;
+
+            // No WAIT bit: the fence already signalled, anything not available is skipped rather than waited for
+            uint64_t timestamps[2]{};
+            if (vkGetQueryPoolResults(m_context.device(), frame.timestamps, i * 2, 2, sizeof(timestamps), timestamps,
+                sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+            {
+                continue;
+            }
+
+            GpuPassTiming timing;
+            timing.name = record.name;
+            timing.asyncCompute = record.asyncCompute;
+            const uint64_t mask = record.asyncCompute ? m_computeMask : m_graphicsMask;
+            timing.gpuMs = double((timestamps[1] - timestamps[0]) & mask) * m_timestampPeriod / 1e6;
+
+            uint64_t statistics[STATISTICS_COUNT]{};
+            if (record.statistics && vkGetQueryPoolResults(m_context.device(), frame.statistics, i, 1, sizeof(statistics), statistics,
+                sizeof(statistics), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+            {
+                timing.primitives = statistics[0];
+                timing.vertexInvocations = statistics[1];
+                timing.fragmentInvocations = statistics[2];
+                timing.computeInvocations = statistics[3];
+            }
+
+#if defined(IX_ENABLE_PROFILER)
+            if (Profiler::get().isRecording())
+            {
+                Profiler::get().recordGpu(timing.name, timing.asyncCompute, toProfilerNs(timestamps[0], mask), toProfilerNs(timestamps[1], mask));
+            }
+#endif
+
+            // Async passes overlap the graphics ones, the frame total is graphics queue time
+            if (!timing.asyncCompute) m_totalMs += timing.gpuMs;
+            m_results.push_back(std::move(timing));
+        }
+    }
+
+    bool VulkanGpuProfiler::startCapture(const std::string& path)
+    {
+        stopCapture();
+
+        const bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        if (json)
+        {
+            m_json = std::make_unique<nlohmann::json>(nlohmann::json::array());
+        }
+        else
+        {
+            m_csv.open(path, std::ios::trunc);
+            if (!m_csv.is_open())
+            {
+                spdlog::error("VulkanGpuProfiler: Failed to open capture file {}", path);
+                return false;
+            }
+            m_csv << "frame,pass,queue,gpu_ms,primitives,vertex_invocations,fragment_invocations,compute_invocations\n";
+        }
+
+        m_capturePath = path;
+        spdlog::info("VulkanGpuProfiler: Capturing pass timings to {}", path);
+        return true;
+    }
+
+    void VulkanGpuProfiler::stopCapture()
+    {
+        if (!isCapturing()) return;
+
+        if (m_json)
+        {
+            std::ofstream file(m_capturePath, std::ios::trunc);
+            if (file.is_open()) file << m_json->dump(2);
+            else spdlog::error("VulkanGpuProfiler: Failed to write capture file {}", m_capturePath);
+            m_json.reset();
+        }
+        m_csv.close();
+
+        spdlog::info("VulkanGpuProfiler: Capture written to {}", m_capturePath);
+        m_capturePath.clear();
+    }
+
+    void VulkanGpuProfiler::writeCapture()
+    {
+        if (m_json)
+        {
+            nlohmann::json passes = nlohmann::json::array();
+            for (const auto& timing : m_results)
+            {
+                passes.push_back({
+                    { "name", timing.name },
+                    { "queue", timing.asyncCompute ? "compute" : "graphics" },
+                    { "gpuMs", timing.gpuMs },
+                    { "primitives", timing.primitives },
+                    { "vertexInvocations", timing.vertexInvocations },
+                    { "fragmentInvocations", timing.fragmentInvocations },
+                    { "computeInvocations", timing.computeInvocations }
+                    });
+            }
+            m_json->push_back({ { "frame", m_frameNumber }, { "gpuMs", m_totalMs }, { "passes", std::move(passes) } });
+            return;
+        }
+
+        for (const auto& timing : m_results)
+        {
+            m_csv << m_frameNumber << ',' << timing.name << ',' << (timing.asyncCompute ? "compute" : "graphics") << ','
+                << timing.gpuMs << ',' << timing.primitives << ',' << timing.vertexInvocations << ','
+                << timing.fragmentInvocations << ',' << timing.computeInvocations << '\n';
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// vk_gpu_profiler.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+
+namespace ix
+{
+    class VulkanContext;
+
+    // GPU time and pipeline statistics of one render graph pass
+    struct GpuPassTiming
+    {
+        std::string name;
+        double gpuMs = 0.0;
+        uint64_t primitives = 0;           // Input assembly, graphics queue only
+        uint64_t vertexInvocations = 0;
+        uint64_t fragmentInvocations = 0;
+        uint64_t computeInvocations = 0;
+        bool asyncCompute = false;
+    };
+
+    // Timestamp and pipeline statistics queries around render graph passes. Every frame in flight has
+    // its own query pools, read back once that frame's fence has signalled, so nothing waits on the GPU.
+    // Scopes are indexed by the caller (execution order position), so passes can be recorded on any thread
+    class VulkanGpuProfiler
+    {
+    public:
+        static constexpr uint32_t MAX_SCOPES = 64;
+
+        VulkanGpuProfiler(VulkanContext& context, uint32_t framesInFlight);
+        ~VulkanGpuProfiler();
+
+        VulkanGpuProfiler(const VulkanGpuProfiler&) = delete;
+        VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+
+        // Needs graphics queue timestamps and host query reset
+        static bool isSupported(const VulkanContext& context);
+
+        // Collects what this frame slot recorded last time and resets its queries. Call right before
+        // recording, once the slot's fence (and compute submission) has signalled
+        void beginFrame(uint32_t frameIndex);
+
+        void beginScope(VkCommandBuffer cmd, uint32_t scope, const std::string& name, bool asyncCompute);
+        void endScope(VkCommandBuffer cmd, uint32_t scope);
+
+        // Latest complete frame, in execution order. MAX_FRAMES_IN_FLIGHT frames old
+        const std::vector<GpuPassTiming>& getResults() const { return m_results; }
+        double getTotalMs() const { return m_totalMs; }
+        bool hasPipelineStatistics() const { return m_hasStatistics; }
+
+        // Appends every collected frame to a .csv file (streamed) or a .json file (written on stop)
+        bool startCapture(const std::string& path);
+        void stopCapture();
+        bool isCapturing() const { return !m_capturePath.empty(); }
+
+    private:
+        struct ScopeRecord
+        {
+            std::string name;
+            bool recorded = false;
+            bool asyncCompute = false;
+            bool statistics = false;
+        };
+
+        struct FrameQueries
+        {
+            VkQueryPool timestamps = VK_NULL_HANDLE; // Begin and end per scope
+            VkQueryPool statistics = VK_NULL_HANDLE; // One per scope, null without pipelineStatisticsQuery
+            std::vector<ScopeRecord> scopes;
+            bool pending = false;                    // Handed out for recording, not collected yet
+        };
+
+        void collect(FrameQueries& frame);
+        void writeCapture();
+        void calibrate();
+        uint64_t toProfilerNs(uint64_t timestamp, uint64_t mask) const;
+
+        VulkanContext& m_context;
+        std::vector<FrameQueries> m_frames;
+        uint32_t m_currentFrame = 0;
+        uint64_t m_frameNumber = 0;
+
+        double m_timestampPeriod = 1.0; // Nanoseconds per tick
+        uint64_t m_graphicsMask = ~0ull;
+        uint64_t m_computeMask = 0;     // Zero when the async compute queue has no timestamps
+        bool m_hasStatistics = false;
+
+        // One GPU timestamp and the CPU profiler's clock at the same moment, places passes in CPU traces
+        uint64_t m_calibrationTimestamp = 0;
+        uint64_t m_calibrationNs = 0;
+
+        std::vector<GpuPassTiming> m_results;
+        double m_totalMs = 0.0;
+
+        std::string m_capturePath;
+        std::ofstream m_csv;
+        std::unique_ptr<nlohmann::json> m_json; // Frames captured so far, .json captures only
+    };
+}
@@ -21,30 +21,22 @@ namespace ix
         , m_layerCount(layerCount)
         , m_isCube(createCube)
     {
-        VkImageCreateInfo imgInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
-        imgInfo.imageType = VK_IMAGE_TYPE_2D;
-        imgInfo.extent = { extent.width, extent.height, 1 };
-        imgInfo.mipLevels = 1;
-        imgInfo.arrayLayers = m_layerCount;
-        imgInfo.format = format;
-        imgInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imgInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imgInfo.usage = usage;
-        imgInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imgInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        if (m_isCube)
-        {
-            imgInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-        }
+        VkImageCreateInfo imgInfo = makeCreateInfo(extent, format, usage, m_layerCount, m_isCube);
 
         VmaAllocationCreateInfo allocInfo{};
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
         allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
 
-        if (vmaCreateImage(m_context.getAllocator(), &imgInfo, &allocInfo, &m_handle, &m_allocation, nullptr) != VK_SUCCESS) {
+        VmaAllocationInfo allocationInfo{};
+        if (vmaCreateImage(m_context.getAllocator(), &imgInfo, &allocInfo, &m_handle, &m_allocation, &allocationInfo) != VK_SUCCESS) {
             throw std::runtime_error("VulkanImage: Failed to create image via VMA!");
         }
 
+        const VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        m_category = (usage & attachmentUsage) ? MemoryCategory::RenderTargets : MemoryCategory::Textures;
+        m_allocationSize = allocationInfo.size;
+        m_context.getMemoryTracker().add(m_category, m_allocationSize);
+
         createView();
     }
 
@@ -58,6 +50,56 @@ namespace ix
         createView();
     }
 
+    VulkanImage::VulkanImage(VulkanContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, VmaAllocation memory)
+        : m_context(context)
+        , m_format(format)
+        , m_extent(extent)
+        , m_isBorrowed(false)
+    {
+        VkImageCreateInfo imgInfo = makeCreateInfo(extent, format, usage, m_layerCount, false);
+        if (vkCreateImage(m_context.device(), &imgInfo, nullptr, &m_handle) != VK_SUCCESS) {
+            throw std::runtime_error("VulkanImage: Failed to create aliased image!");
+        }
+        // m_allocation stays null, so the destructor leaves the memory alone
+        if (vmaBindImageMemory(m_context.getAllocator(), memory, m_handle) != VK_SUCCESS) {
+            throw std::runtime_error("VulkanImage: Failed to bind aliased image memory!");
+        }
+
+        createView();
+    }
+
+    VkMemoryRequirements VulkanImage::getMemoryRequirements(VulkanContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage)
+    {
+        VkImageCreateInfo imgInfo = makeCreateInfo(extent, format, usage, 1, false);
+
+        VkDeviceImageMemoryRequirements query{ VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS };
+        query.pCreateInfo = &imgInfo;
+
+        VkMemoryRequirements2 requirements{ VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+        vkGetDeviceImageMemoryRequirements(context.device(), &query, &requirements);
+        return requirements.memoryRequirements;
+    }
+
+    VkImageCreateInfo VulkanImage::makeCreateInfo(VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, uint32_t layerCount, bool createCube)
+    {
+        VkImageCreateInfo imgInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+        imgInfo.imageType = VK_IMAGE_TYPE_2D;
+        imgInfo.extent = { extent.width, extent.height, 1 };
+        imgInfo.mipLevels = 1;
+        imgInfo.arrayLayers = layerCount;
+        imgInfo.format = format;
+        imgInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imgInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imgInfo.usage = usage;
+        imgInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imgInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (createCube)
+        {
+            imgInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        }
+        return imgInfo;
+    }
+
     void VulkanImage::createView()
     {
         // Determine if this is a Depth or Color image based on format
@@ -217,6 +259,20 @@ namespace ix
             m_format == VK_FORMAT_D16_UNORM_S8_UINT;
     }
 
+    void VulkanImage::setMemoryTag(MemoryCategory category, const char* name)
+    {
+        if (m_allocation == VK_NULL_HANDLE) return;
+
+        if (category != m_category)
+        {
+            VulkanMemoryTracker& tracker = m_context.getMemoryTracker();
+            tracker.remove(m_category, m_allocationSize);
+            tracker.add(category, m_allocationSize);
+            m_category = category;
+        }
+        if (name) vmaSetAllocationName(m_context.getAllocator(), m_allocation, name);
+    }
+
     VulkanImage::~VulkanImage()
     {
         if (m_view != VK_NULL_HANDLE) {
@@ -229,6 +285,7 @@ namespace ix
 
         if (!m_isBorrowed && m_handle != VK_NULL_HANDLE) {
             vmaDestroyImage(m_context.getAllocator(), m_handle, m_allocation);
+            if (m_allocationSize > 0) m_context.getMemoryTracker().remove(m_category, m_allocationSize);
             m_handle = VK_NULL_HANDLE;
             m_allocation = nullptr;
         }
@@ -1,6 +1,7 @@
 // vk_image.h
 #pragma once
 #include <vulkan/vulkan.h>
+#include "vk_memory_tracker.h"
 
 
 struct VmaAllocation_T;
@@ -23,9 +24,15 @@ namespace ix
 
         VulkanImage(VulkanContext& context, VkImage handle, VkFormat format, VkExtent2D extent);
 
+        // Placed in memory owned by someone else (render graph aliasing), destroyed without freeing it
+        VulkanImage(VulkanContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, VmaAllocation memory);
+        static VkMemoryRequirements getMemoryRequirements(VulkanContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage);
+
         ~VulkanImage();
 
         void transition(VkCommandBuffer cmd, VkImageLayout newLayout);
+        // For barriers recorded elsewhere (render graph)
+        void setLayout(VkImageLayout layout) { m_currentLayout = layout; }
         void copyFromBuffer(VkCommandBuffer cmd, VkBuffer buffer) const;
         void uploadData(void* pixels, uint32_t size);
         VkImageView createAdditionalView(VkImageViewType type, uint32_t layerCount);
@@ -36,11 +43,16 @@ namespace ix
         VkFormat getFormat() const { return m_format; }
         VkExtent2D getExtent() const { return m_extent; }
         VkImageLayout getLayout() const { return m_currentLayout; }
+        uint32_t getLayerCount() const { return m_layerCount; }
         VkDescriptorImageInfo getImageInfo(VkSampler sampler, VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
         VkDescriptorImageInfo getDescriptorInfo(VkSampler sampler) const;
         bool isDepthFormat() const;
 
+        // Moves the allocation to another memory category and names it in VMA's statistics
+        void setMemoryTag(MemoryCategory category, const char* name = nullptr);
+
     private:
+        static VkImageCreateInfo makeCreateInfo(VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, uint32_t layerCount, bool createCube);
         void createView();
 
         VulkanContext& m_context;
@@ -56,6 +68,9 @@ namespace ix
         uint32_t m_layerCount = 1;
         bool m_isCube = false;
 
+        MemoryCategory m_category = MemoryCategory::Textures;
+        VkDeviceSize m_allocationSize = 0; // Zero for borrowed and aliased images
+
 
     };
 }
\ No newline at end of file
@@ -5,11 +5,11 @@
 
 namespace ix {
 
-    VulkanInstance::VulkanInstance(const char* appName) {
+    VulkanInstance::VulkanInstance(const char* appName, bool headless) {
 #ifdef NDEBUG
         m_enableValidation = false;
 #endif
-        createInstance(appName);
+        createInstance(appName, headless);
         if (m_enableValidation) {
             setupDebugMessenger();
         }
@@ -23,7 +23,7 @@ namespace ix {
         vkDestroyInstance(m_instance, nullptr);
     }
 
-    void VulkanInstance::createInstance(const char* appName) {
+    void VulkanInstance::createInstance(const char* appName, bool headless) {
         VkApplicationInfo appInfo{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
         appInfo.pApplicationName = appName;
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
@@ -31,9 +31,12 @@ namespace ix {
         appInfo.apiVersion = VK_API_VERSION_1_3;
 
         // Extensions
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        std::vector<const char*> extensions;
+        if (!headless) {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (m_enableValidation) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -8,7 +8,8 @@ namespace ix
     class VulkanInstance 
     {
     public:
-        VulkanInstance(const char* appName);
+        // Headless instances skip the window system's surface extensions
+        VulkanInstance(const char* appName, bool headless = false);
         ~VulkanInstance();
 
         VkInstance get() const { return m_instance; }
@@ -19,7 +20,7 @@ namespace ix
         VkDebugUtilsMessengerEXT m_debugMessenger = VK_NULL_HANDLE;
         bool m_enableValidation = true;
 
-        void createInstance(const char* appName);
+        void createInstance(const char* appName, bool headless);
         void setupDebugMessenger();
     };
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+// vk_memory_tracker.cpp
+#include "common/engine_pch.h"
+#include "vk_memory_tracker.h"
+
+#include <vk_mem_alloc.h>
+
+namespace ix
+{
+    VulkanMemoryTracker::VulkanMemoryTracker(VmaAllocator allocator)
+        : m_allocator(allocator)
+    {
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_allocator, &memoryProperties);
+        m_overBudget.assign(memoryProperties->memoryHeapCount, false);
+    }
+
+    const char* VulkanMemoryTracker::getCategoryName(MemoryCategory category)
+    {
+        switch (category)
+        {
+        case MemoryCategory::Geometry: return "Geometry";
+        case MemoryCategory::Textures: return "Textures";
+        case MemoryCategory::RenderTargets: return "Render Targets";
+        case MemoryCategory::Staging: return "Staging";
+        case MemoryCategory::InstanceData: return "Instance Data";
+        case MemoryCategory::FrameData: return "Frame Data";
+        case MemoryCategory::Other: return "Other";
+        default: return "Unknown";
+        }
+    }
+
+    void VulkanMemoryTracker::add(MemoryCategory category, VkDeviceSize bytes)
+    {
+        Counter& counter = m_counters[static_cast<uint32_t>(category)];
+        counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void VulkanMemoryTracker::remove(MemoryCategory category, VkDeviceSize bytes)
+    {
+        Counter& counter = m_counters[static_cast<uint32_t>(category)];
+        counter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        counter.allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MemoryCategoryUsage VulkanMemoryTracker::getUsage(MemoryCategory category) const
+    {
+        const Counter& counter = m_counters[static_cast<uint32_t>(category)];
+        return { counter.bytes.load(std::memory_order_relaxed), counter.allocations.load(std::memory_order_relaxed) };
+    }
+
+    std::vector<MemoryHeapBudget> VulkanMemoryTracker::getHeapBudgets() const
+    {
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_allocator, &memoryProperties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+        vmaGetHeapBudgets(m_allocator, budgets);
+
+        std::vector<MemoryHeapBudget> heaps(memoryProperties->memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++)
+        {
+            heaps[i].usage = budgets[i].usage;
+            heaps[i].budget = budgets[i].budget;
+            heaps[i].allocated = budgets[i].statistics.blockBytes;
+            heaps[i].deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+        return heaps;
+    }
+
+    void VulkanMemoryTracker::update(uint32_t frameIndex)
+    {
+        // Budgets are refreshed once per frame index
+        vmaSetCurrentFrameIndex(m_allocator, frameIndex);
+
+        const std::vector<MemoryHeapBudget> heaps = getHeapBudgets();
+        for (uint32_t i = 0; i < heaps.size(); i++)
+        {
+            if (heaps[i].budget == 0) continue;
+
+            const bool over = heaps[i].usage > static_cast<VkDeviceSize>(heaps[i].budget * WARNING_FRACTION);
+            if (over && !m_overBudget[i])
+            {
+                spdlog::warn("VulkanMemoryTracker: Heap {} ({}) at {} of {} MB budget", i, heaps[i].deviceLocal ? "device" : "host",
+                    heaps[i].usage / (1024 * 1024), heaps[i].budget / (1024 * 1024));
+            }
+            m_overBudget[i] = over;
+        }
+    }
+
+    bool VulkanMemoryTracker::dumpJson(const std::string& path) const
+    {
+        nlohmann::json dump;
+
+        nlohmann::json categories = nlohmann::json::object();
+        for (uint32_t i = 0; i < CATEGORY_COUNT; i++)
+        {
+            const MemoryCategoryUsage usage = getUsage(static_cast<MemoryCategory>(i));
+            categories[getCategoryName(static_cast<MemoryCategory>(i))] = { { "bytes", usage.bytes }, { "allocations", usage.allocations } };
+        }
+        dump["categories"] = std::move(categories);
+
+        nlohmann::json heaps = nlohmann::json::array();
+        for (const auto& heap : getHeapBudgets())
+        {
+            heaps.push_back({ { "deviceLocal", heap.deviceLocal }, { "usage", heap.usage }, { "budget", heap.budget }, { "allocated", heap.allocated } });
+        }
+        dump["heaps"] = std::move(heaps);
+
+        char* statsString = nullptr;
+        vmaBuildStatsString(m_allocator, &statsString, VK_TRUE);
+        dump["vma"] = nlohmann::json::parse(statsString, nullptr, false);
+        vmaFreeStatsString(m_allocator, statsString);
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            spdlog::error("VulkanMemoryTracker: Failed to open {}", path);
+            return false;
+        }
+        file << dump.dump(2);
+        spdlog::info("VulkanMemoryTracker: Memory dump written to {}", path);
+        return true;
+    }
+}
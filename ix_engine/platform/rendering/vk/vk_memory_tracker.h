@@ -0,0 +1,76 @@
+// vk_memory_tracker.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct VmaAllocator_T;
+typedef struct VmaAllocator_T* VmaAllocator;
+
+namespace ix
+{
+    enum class MemoryCategory : uint32_t
+    {
+        Geometry,      // Global VBO/IBO
+        Textures,      // Sampled images, HDR sources and cubemaps
+        RenderTargets, // Attachments, render graph transients and history
+        Staging,       // Upload buffers
+        InstanceData,  // Instance database and culling output
+        FrameData,     // Per-frame uniforms, lights and clusters
+        Other,
+        Count
+    };
+
+    struct MemoryCategoryUsage
+    {
+        VkDeviceSize bytes = 0;
+        uint32_t allocations = 0;
+    };
+
+    struct MemoryHeapBudget
+    {
+        VkDeviceSize usage = 0;  // Whole process, includes other APIs with VK_EXT_memory_budget
+        VkDeviceSize budget = 0; // What the process can use before the driver starts evicting
+        VkDeviceSize allocated = 0; // VMA's own allocations in the heap
+        bool deviceLocal = false;
+    };
+
+    // Bytes per category and per-heap budgets. Buffers and images register their allocations here, any
+    // thread may allocate. With VK_EXT_memory_budget the budgets are the driver's, otherwise VMA estimates them
+    class VulkanMemoryTracker
+    {
+    public:
+        static constexpr uint32_t CATEGORY_COUNT = static_cast<uint32_t>(MemoryCategory::Count);
+        static constexpr float WARNING_FRACTION = 0.9f;
+
+        explicit VulkanMemoryTracker(VmaAllocator allocator);
+
+        void add(MemoryCategory category, VkDeviceSize bytes);
+        void remove(MemoryCategory category, VkDeviceSize bytes);
+
+        MemoryCategoryUsage getUsage(MemoryCategory category) const;
+        std::vector<MemoryHeapBudget> getHeapBudgets() const;
+
+        // Once per frame. Advances VMA's frame index and warns when a heap gets close to its budget
+        void update(uint32_t frameIndex);
+
+        // Categories, heap budgets and VMA's detailed statistics (every block and allocation)
+        bool dumpJson(const std::string& path) const;
+
+        static const char* getCategoryName(MemoryCategory category);
+
+    private:
+        struct Counter
+        {
+            std::atomic<uint64_t> bytes{ 0 };
+            std::atomic<uint32_t> allocations{ 0 };
+        };
+
+        VmaAllocator m_allocator;
+        std::array<Counter, CATEGORY_COUNT> m_counters;
+        std::vector<bool> m_overBudget; // Per heap, warns once per crossing
+    };
+}
@@ -138,7 +138,10 @@ namespace ix
 
 	void VulkanPipelineManager::reloadPipelines() 
 	{
-		vkDeviceWaitIdle(m_context.device());
+		{
+			std::lock_guard<std::mutex> queueLock(m_context.getQueueMutex());
+			vkDeviceWaitIdle(m_context.device());
+		}
 
 		m_stateCache.clear();
 		m_namedCache.clear();
@@ -11,6 +11,7 @@
 #include "vk_pipeline.h"
 #include "vk_pipeline_manager.h"
 #include "vk_descriptor_manager.h"
+#include "vk_command_pools.h"
 
 #include "platform/rendering/vk/render_graph/vk_render_graph.h"
 #include "platform/rendering/vk/passes/depth_pre_pass.h"
@@ -21,23 +22,30 @@
 #include "platform/rendering/vk/passes/imgui_pass.h"
 #include "platform/rendering/vk/passes/cluster_build_pass.h"
 #include "platform/rendering/vk/passes/cluster_culling_pass.h"
+#include "platform/rendering/vk/vk_gpu_profiler.h"
+#include "platform/rendering/vk/vk_memory_tracker.h"
 
 
 #include "core/asset_manager.h"
-#include "core/scene_manager.h"
+#include "core/scene.h"
 #include "core/components.h"
+#include "core/job_system.h"
+#include "core/profiler.h"
 
 
 #include <imgui.h>
 #include <imgui_impl_vulkan.h>
 #include <imgui_impl_glfw.h>
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
 
 namespace ix
 {
 	VulkanRenderer::VulkanRenderer(Window_I& window) 
 		: m_window(window)
-		, m_instance(std::make_unique<VulkanInstance>("Imaginatrix Renderer"))
+		, m_instance(std::make_unique<VulkanInstance>("Imaginatrix Renderer", window.isHeadless()))
 		, m_context(std::make_unique<VulkanContext>(*m_instance, m_window))
 		, m_pipelineManager(std::make_unique<VulkanPipelineManager>(*m_context))
 		, m_renderGraph(std::make_unique<RenderGraph>())
@@ -57,6 +65,20 @@ namespace ix
 		createCommandBuffers();
 		createDescriptorAndPipelineLayouts();
 
+		if (m_jobSystem && m_jobSystem->getWorkerCount() > 0)
+		{
+			m_secondaryPools = std::make_unique<VulkanCommandPools>(*m_context, m_jobSystem->getThreadCount(), MAX_FRAMES_IN_FLIGHT);
+		}
+
+		if (VulkanGpuProfiler::isSupported(*m_context))
+		{
+			m_gpuProfiler = std::make_unique<VulkanGpuProfiler>(*m_context, MAX_FRAMES_IN_FLIGHT);
+		}
+		else
+		{
+			spdlog::warn("VulkanRenderer: No timestamp queries or host query reset, GPU pass timings are disabled");
+		}
+
 		// Init Global UBO Buffers
 		m_globalUboBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 		for (size_t i{}; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -67,6 +89,7 @@ namespace ix
 				1,
 				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 				VMA_MEMORY_USAGE_CPU_TO_GPU);
+			m_globalUboBuffers[i]->setMemoryTag(MemoryCategory::FrameData, "Global UBO");
 			m_globalUboBuffers[i]->map();
 		}
 
@@ -79,17 +102,22 @@ namespace ix
 				1,
 				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 				VMA_MEMORY_USAGE_CPU_TO_GPU);
+			m_lightBuffers[i]->setMemoryTag(MemoryCategory::FrameData, "Lights");
 			m_lightBuffers[i]->map();
 		}
 
-		// Init light grid buffer
-		m_lightGridBuffer = std::make_unique<VulkanBuffer>(
-			*m_context,
-			sizeof(LightGrid) * (16 * 9 * 24),
-			1,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VMA_MEMORY_USAGE_GPU_ONLY
-		);
+		// Init light grid buffers
+		m_lightGridBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+			m_lightGridBuffers[i] = std::make_unique<VulkanBuffer>(
+				*m_context,
+				sizeof(LightGrid) * (16 * 9 * 24),
+				1,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY
+			);
+			m_lightGridBuffers[i]->setMemoryTag(MemoryCategory::FrameData, "Light Grid");
+		}
 		
 		// Init cluster AABB buffer
 		uint32_t clusterCount = 16 * 9 * 24;
@@ -100,18 +128,23 @@ namespace ix
 			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 			VMA_MEMORY_USAGE_GPU_ONLY
 		);
+		m_clusterAABBbuffer->setMemoryTag(MemoryCategory::FrameData, "Cluster AABBs");
 
 		// Init light cache
 		m_cpuLightCache = std::make_unique<LightData>();
 
-		// Init light index buffer
-		m_lightIndexListBuffer = std::make_unique<VulkanBuffer>(
-			*m_context,
-			sizeof(uint32_t) * (16 * 9 * 24) * 100, // Max 100 lights per cluster
-			1,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VMA_MEMORY_USAGE_GPU_ONLY
-		);
+		// Init light index buffers
+		m_lightIndexListBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+			m_lightIndexListBuffers[i] = std::make_unique<VulkanBuffer>(
+				*m_context,
+				sizeof(uint32_t) * (16 * 9 * 24) * 100, // Max 100 lights per cluster
+				1,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY
+			);
+			m_lightIndexListBuffers[i]->setMemoryTag(MemoryCategory::FrameData, "Light Index List");
+		}
 
 		// Init atomic counter buffer
 		m_atomicCounterBuffer = std::make_unique<VulkanBuffer>(
@@ -121,31 +154,70 @@ namespace ix
 			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			VMA_MEMORY_USAGE_GPU_ONLY
 		);
+		m_atomicCounterBuffer->setMemoryTag(MemoryCategory::FrameData, "Light Counter");
+
+		// Init culling statistics and their readback ring
+		m_cullingStatsBuffer = std::make_unique<VulkanBuffer>(
+			*m_context,
+			sizeof(GPUCullingStats),
+			1,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+		m_cullingStatsBuffer->setMemoryTag(MemoryCategory::FrameData, "Culling Stats");
+
+		m_cullingStatsReadback = std::make_unique<VulkanBuffer>(
+			*m_context,
+			sizeof(GPUCullingStats),
+			MAX_FRAMES_IN_FLIGHT,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VMA_MEMORY_USAGE_GPU_TO_CPU
+		);
+		m_cullingStatsReadback->setMemoryTag(MemoryCategory::FrameData, "Culling Stats Readback");
+		m_cullingStatsReadback->map();
+		memset(m_cullingStatsReadback->getMappedData(), 0, sizeof(GPUCullingStats) * MAX_FRAMES_IN_FLIGHT);
 
 
-		// Init Instance Database (Input)
+		// Init Instance Database (Input). Frames in flight share it, so it only changes through copies
+		// recorded in a frame's command buffer, ordered after the previous frame's culling
 		m_instanceBuffer = std::make_unique<VulkanBuffer>(
 			*m_context,
-			sizeof(GPUInstanceData) * 3000,
+			sizeof(GPUInstanceData) * MAX_INSTANCES,
 			1,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VMA_MEMORY_USAGE_CPU_TO_GPU
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
 		);
-		m_instanceBuffer->map();
+		m_instanceBuffer->setMemoryTag(MemoryCategory::InstanceData, "Instance Database");
+
+		m_instanceStaging.resize(MAX_FRAMES_IN_FLIGHT);
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			m_instanceStaging[i] = std::make_unique<VulkanBuffer>(
+				*m_context,
+				sizeof(GPUInstanceData) * MAX_INSTANCES,
+				1,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VMA_MEMORY_USAGE_CPU_ONLY
+			);
+			m_instanceStaging[i]->setMemoryTag(MemoryCategory::Staging, "Instance Staging");
+			m_instanceStaging[i]->map();
+		}
+		m_cpuInstances.assign(MAX_INSTANCES, GPUInstanceData{});
+		m_pendingInstanceFlags.assign(MAX_INSTANCES, 0);
 
 
 
 		// Init Culled Instance Buffer (Commands + Filtered Data)
-		const uint32_t MAX_BATCHES = 16;
 		const VkDeviceSize commandHeaderSize = 1024;
 
 		m_culledInstanceBuffer = std::make_unique<VulkanBuffer>(
 			*m_context,
-			commandHeaderSize + (sizeof(GPUInstanceData) * 3000),
+			commandHeaderSize + (sizeof(GPUInstanceData) * MAX_INSTANCES),
 			1,
 			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			VMA_MEMORY_USAGE_GPU_ONLY
 		);
+		m_culledInstanceBuffer->setMemoryTag(MemoryCategory::InstanceData, "Culled Instances");
 
 		// Init Bindless Textures
 		m_bindlessPool = m_descriptorManagers[0]->createBindlessPool(1, 1000);
@@ -164,9 +236,10 @@ namespace ix
 			auto uboInfo = m_globalUboBuffers[i]->descriptorInfo();
 			auto lightBufferInfo = m_lightBuffers[i]->descriptorInfo();
 			auto clusterAABBInfo = m_clusterAABBbuffer->descriptorInfo();
-			auto gridInfo = m_lightGridBuffer->descriptorInfo();
-			auto indexListInfo = m_lightIndexListBuffer->descriptorInfo();
+			auto gridInfo = m_lightGridBuffers[i]->descriptorInfo();
+			auto indexListInfo = m_lightIndexListBuffers[i]->descriptorInfo();
 			auto atomicInfo = m_atomicCounterBuffer->descriptorInfo();
+			auto cullingStatsInfo = m_cullingStatsBuffer->descriptorInfo();
 
 			DescriptorWriter()
 				.writeBuffer(0, &uboInfo, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
@@ -175,6 +248,7 @@ namespace ix
 				.writeBuffer(3, &gridInfo, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)     
 				.writeBuffer(4, &indexListInfo, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
 				.writeBuffer(5, &atomicInfo, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.writeBuffer(6, &cullingStatsInfo, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
 				.updateSet(*m_context, sets.globalSet);
 
 			// Set 2 (Forward)
@@ -211,8 +285,20 @@ namespace ix
 		spdlog::info("Vulkan Renderer: Initialized. Descriptors baked for {} frames.", MAX_FRAMES_IN_FLIGHT);
 	}
 	
-	bool VulkanRenderer::beginFrame(FrameContext& ctx, const SceneView& view)
+	void VulkanRenderer::prepareFrame(Scene& scene, RenderSnapshot& snapshot)
+	{
+		IX_PROFILE_SCOPE("VulkanRenderer::prepareFrame");
+
+		extractInstances(scene, snapshot);
+		extractLights(scene, snapshot);
+	}
+
+	bool VulkanRenderer::beginFrame(FrameContext& ctx, const RenderSnapshot& snapshot)
 	{
+		IX_PROFILE_SCOPE("VulkanRenderer::beginFrame");
+
+		// Instance changes are deltas, keep them even if this frame ends up skipped
+		updateInstanceBuffer(snapshot);
 
 		if (m_window.wasWindowResized() || m_needsSwapchainRecreation)
 		{
@@ -223,11 +309,32 @@ namespace ix
 		FrameData& frame = getCurrentFrame();
 
 		// Synchronize: Wait for GPU to finish this frame's previous iteration
+		using clock = std::chrono::steady_clock;
+		const auto fenceStart = clock::now();
 		vkWaitForFences(m_context->device(), 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
 
+		// The fence only covers the graphics queue, the compute submission reads the same frame data
+		if (frame.computeSignalValue != 0)
+		{
+			VkSemaphoreWaitInfo waitInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+			waitInfo.semaphoreCount = 1;
+			waitInfo.pSemaphores = &m_computeTimeline;
+			waitInfo.pValues = &frame.computeSignalValue;
+			vkWaitSemaphores(m_context->device(), &waitInfo, UINT64_MAX);
+		}
+
+		const auto acquireStart = clock::now();
+		m_fenceWaitMs = std::chrono::duration<float, std::milli>(acquireStart - fenceStart).count();
+
+		// Both queues are done with this slot, its culling counters are from MAX_FRAMES_IN_FLIGHT frames ago
+		const VkDeviceSize statsOffset = sizeof(GPUCullingStats) * m_currentFrameIndex;
+		m_cullingStatsReadback->invalidate(sizeof(GPUCullingStats), statsOffset);
+		memcpy(&m_cullingStats, static_cast<const char*>(m_cullingStatsReadback->getMappedData()) + statsOffset, sizeof(GPUCullingStats));
+
 		// Acquire Image
 		uint32_t imageIndex;
 		VkResult result = m_swapchain->acquireNextImage(frame.imageAvailableSemapohore, &imageIndex);
+		m_acquireWaitMs = std::chrono::duration<float, std::milli>(clock::now() - acquireStart).count();
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 		{
 			recreateSwapchain();
@@ -238,11 +345,13 @@ namespace ix
 		// Reset Command Buffer & Fence
 		vkResetFences(m_context->device(), 1, &frame.inFlightFence);
 		vkResetCommandBuffer(frame.commandBuffer, 0);
+		if (m_secondaryPools) m_secondaryPools->resetFrame(m_currentFrameIndex);
+		if (m_gpuProfiler) m_gpuProfiler->beginFrame(m_currentFrameIndex);
+		m_context->getMemoryTracker().update(static_cast<uint32_t>(m_submitSerial));
 
-		// Update CPU Data (UBO and Instance Database)
-		updateGlobalUbo(view);
-		updateLightBuffer(view);
-		updateInstanceBuffer();
+		// Update CPU Data (UBO and Lights)
+		updateGlobalUbo(snapshot.view);
+		updateLightBuffer(snapshot);
 		
 
 		// Start Recording
@@ -251,11 +360,27 @@ namespace ix
 			throw std::runtime_error("VulkanRenderer: Failed to begin recording command buffer!");
 		}
 
+		ctx.computeCommandBuffer = VK_NULL_HANDLE;
+		ctx.tailCommandBuffer = VK_NULL_HANDLE;
+		if (frame.computeCommandBuffer != VK_NULL_HANDLE && m_renderGraph && m_renderGraph->hasAsyncWork())
+		{
+			vkResetCommandBuffer(frame.computeCommandBuffer, 0);
+			vkResetCommandBuffer(frame.tailCommandBuffer, 0);
+			if (vkBeginCommandBuffer(frame.computeCommandBuffer, &beginInfo) != VK_SUCCESS ||
+				vkBeginCommandBuffer(frame.tailCommandBuffer, &beginInfo) != VK_SUCCESS) {
+				throw std::runtime_error("VulkanRenderer: Failed to begin recording compute command buffer!");
+			}
+			ctx.computeCommandBuffer = frame.computeCommandBuffer;
+			ctx.tailCommandBuffer = frame.tailCommandBuffer;
+		}
+
+		recordInstanceUpload(frame.commandBuffer);
+
 		// Reset Indirect Commands
 		std::vector<GPUIndirectCommand> resetCmds;
-		resetCmds.reserve(m_renderBatches.size());
+		resetCmds.reserve(snapshot.batches.size());
 
-		for (const auto& batch : m_renderBatches) {
+		for (const auto& batch : snapshot.batches) {
 			VulkanMesh* mesh = AssetManager::get().getMesh(batch.meshHandle);
 			GPUIndirectCommand cmd{};
 			cmd.indexCount = mesh ? mesh->indexCount : 0;
@@ -304,14 +429,19 @@ namespace ix
 		ctx.bindlessDescriptorSet = m_bindlessDescriptorSet;
 
 		ctx.atomicCounterBuffer = m_atomicCounterBuffer->getBuffer();
+		ctx.cullingStatsBuffer = m_cullingStatsBuffer->getBuffer();
+		ctx.cullingStatsReadback = m_cullingStatsReadback->getBuffer();
+		ctx.cullingStatsReadbackOffset = sizeof(GPUCullingStats) * m_currentFrameIndex;
 		ctx.instanceCount = m_currentInstanceCount;
-		ctx.renderBatches = &m_renderBatches;
+		ctx.renderBatches = &snapshot.batches;
 
 		return true;
 	}
 
 	void VulkanRenderer::render(const FrameContext& ctx, const SceneView& view)
 	{
+		IX_PROFILE_SCOPE("VulkanRenderer::render");
+
 		updateBindlessTextures(AssetManager::get().takePendingUpdates());
 
 		RenderContext system;
@@ -321,150 +451,171 @@ namespace ix
 		system.descriptorManager = m_descriptorManagers[m_currentFrameIndex].get();
 		system.computeStorageLayout = m_computeStorageLayout;
 		system.computeCullingLayout = m_cullingDescriptorLayout;
+		system.jobSystem = m_secondaryPools ? m_jobSystem : nullptr;
+		system.commandPools = m_secondaryPools.get();
+		system.gpuProfiler = m_gpuProfiler.get();
 	
 		RenderState state{ system, ctx, view };
 
 		VulkanImage* currentImg = m_swapchain->getImageWrapper(m_currentImageIndex);
 		if (currentImg) 
 		{
-			m_renderGraph->importImage("BackBuffer", currentImg);
-			m_renderGraph->importImage("DepthBuffer", m_depthImage.get());
+			m_renderGraph->setBackBuffer(currentImg);
 		}
+		m_renderGraph->bindBuffer(m_lightGridHandle, m_lightGridBuffers[m_currentFrameIndex].get());
+		m_renderGraph->bindBuffer(m_lightIndexListHandle, m_lightIndexListBuffers[m_currentFrameIndex].get());
 
 		m_renderGraph->execute(state);
 	}
 
-	void VulkanRenderer::updateLightBuffer(const SceneView& view) 
+	void VulkanRenderer::extractLights(Scene& scene, RenderSnapshot& snapshot)
 	{
-		auto& scene = SceneManager::getActiveScene();
+		IX_PROFILE_SCOPE("VulkanRenderer::extractLights");
+
 		auto& registry = scene.getRegistry();
+		const glm::mat4& viewMatrix = snapshot.view.viewMatrix;
 
 		// Standard view for lights
 		auto lightView = registry.view<TransformComponent, PointLightComponent>();
 
-		uint32_t lightCount = 0;
+		snapshot.lights.clear();
 		lightView.each([&](auto entity, auto& transform, auto& light) {
-			if (lightCount >= 1024) return; // limit for SSBO size
+			if (snapshot.lights.size() >= MAX_POINT_LIGHTS) return; // limit for SSBO size
 
 			// Convert world position to View Space
 			glm::vec4 worldPos = glm::vec4(transform.position, 1.0f);
-			glm::vec4 viewPos = view.viewMatrix * worldPos;
 
-			m_cpuLightCache->lights[lightCount].position = viewPos;
-			m_cpuLightCache->lights[lightCount].position.w = light.radius; // Pack radius into W
-			m_cpuLightCache->lights[lightCount].color = glm::vec4(light.color, light.intensity);
-
-			lightCount++;
+			GPUPointLight& gpuLight = snapshot.lights.emplace_back();
+			gpuLight.position = viewMatrix * worldPos;
+			gpuLight.position.w = light.radius; // Pack radius into W
+			gpuLight.color = glm::vec4(light.color, light.intensity);
 			});
-
-		m_cpuLightCache->count = lightCount;
-
-		m_lightBuffers[m_currentFrameIndex]->writeToBuffer(m_cpuLightCache.get(), sizeof(LightData));
 	}
 
-	void VulkanRenderer::updateInstanceBuffer()
+	void VulkanRenderer::extractInstances(Scene& scene, RenderSnapshot& snapshot)
 	{
-		auto& scene = SceneManager::getActiveScene();
-		auto& registry = scene.getRegistry();
+		IX_PROFILE_SCOPE("VulkanRenderer::extractInstances");
 
-		// Use EnTT group for contiguous memory access
-		auto group = registry.group<MeshComponent>(entt::get<TransformComponent>);
+		// Apply this frame's structural and transform changes; slots of untouched entities stay put
+		m_instanceTable.sync(scene);
+		m_instanceTable.gatherChanges(snapshot);
 
-		// Only do a full rebuild if the scene structure changed
-		static size_t lastEntityCount = 0;
-		bool needsFullRebuild = (group.size() != lastEntityCount);
-
-		if (needsFullRebuild)
-		{
-			// Clear caches
-			for (auto& [handle, instances] : m_batchMapCache) instances.clear();
-			m_cpuInstanceCache.clear();
-			m_renderBatches.clear();
-
-			m_cpuInstanceCache.reserve(group.size());
+		// Logging
+		static size_t lastBatchCount = 0;
+		static uint32_t lastInstanceCount = 0;
+		const size_t batchCount = snapshot.batches.size();
+		const uint32_t liveCount = m_instanceTable.getLiveCount();
+		if (batchCount != lastBatchCount || liveCount != lastInstanceCount) {
+			spdlog::info("Batcher: {} instances in {} batches ({} slots)",
+				liveCount, batchCount, snapshot.instanceSlotCount);
+			lastBatchCount = batchCount;
+			lastInstanceCount = liveCount;
+		}
+	}
 
-			// Group by MeshHandle
-			group.each([&](auto entity, auto& mesh, auto& transform) {
-				GPUInstanceData data{};
-				data.modelMatrix = transform.getTransform();
-				data.textureIndex = AssetManager::get().getTextureBindlessIndex(mesh.textureHandle);
-				
-				float baseRadius = AssetManager::get().getMeshBoundingRadius(mesh.meshHandle);
-				float maxScale = std::max({ transform.scale.x, transform.scale.y, transform.scale.z });
-				data.boundingRadius = baseRadius * maxScale;
+	void VulkanRenderer::updateLightBuffer(const RenderSnapshot& snapshot)
+	{
+		IX_PROFILE_SCOPE("VulkanRenderer::updateLightBuffer");
 
-				m_batchMapCache[mesh.meshHandle].push_back(data);
-				});
+		const uint32_t lightCount = static_cast<uint32_t>(snapshot.lights.size());
+		std::copy(snapshot.lights.begin(), snapshot.lights.end(), m_cpuLightCache->lights);
+		m_cpuLightCache->count = lightCount;
 
-			// Flatten and assign BatchIDs
-			uint32_t currentOffset = 0;
-			uint32_t batchIndex = 0;
+		m_lightBuffers[m_currentFrameIndex]->writeToBuffer(m_cpuLightCache.get(), sizeof(LightData));
+	}
 
-			for (auto& [meshHandle, instances] : m_batchMapCache)
-			{
-				if (instances.empty()) continue;
-
-				// Create the metadata for this batch
-				RenderBatch batch;
-				batch.meshHandle = meshHandle;
-				batch.instanceCount = static_cast<uint32_t>(instances.size());
-				batch.firstInstance = currentOffset;
-				m_renderBatches.push_back(batch);
-
-				// Assign the Batch ID to every instance in this group
-				for (auto& inst : instances) {
-					inst.batchID = batchIndex;
-				}
+	void VulkanRenderer::updateInstanceBuffer(const RenderSnapshot& snapshot)
+	{
+		IX_PROFILE_SCOPE("VulkanRenderer::updateInstanceBuffer");
 
-				// Move into flat GPU-ready vector
-				m_cpuInstanceCache.insert(m_cpuInstanceCache.end(), instances.begin(), instances.end());
+		m_currentInstanceCount = snapshot.instanceSlotCount;
 
-				currentOffset += batch.instanceCount;
-				batchIndex++;
-			}
+		// The GPU may still read the database here, only the CPU mirror changes
+		auto markPending = [this](uint32_t slot) {
+			if (m_pendingInstanceFlags[slot]) return;
+			m_pendingInstanceFlags[slot] = 1;
+			m_pendingInstanceSlots.push_back(slot);
+			};
 
-			lastEntityCount = group.size();
-		}
-		else
+		if (snapshot.fullInstanceUpload)
 		{
-			// FAST PATH: Only update matrices for dirty transforms
-			uint32_t i = 0;
-			group.each([&](auto entity, auto& mesh, auto& transform) {
-				// Only update if the object actually moved
-				if (transform.dirty) 
-				{
-					float baseRadius = AssetManager::get().getMeshBoundingRadius(mesh.meshHandle);
-					float maxScale = std::max({ transform.scale.x, transform.scale.y, transform.scale.z });
-					m_cpuInstanceCache[i].modelMatrix = transform.getTransform();
+			const uint32_t count = std::min(static_cast<uint32_t>(snapshot.instanceData.size()), MAX_INSTANCES);
+			std::copy(snapshot.instanceData.begin(), snapshot.instanceData.begin() + count, m_cpuInstances.begin());
+			for (uint32_t slot = 0; slot < count; slot++) markPending(slot);
+			return;
+		}
 
-				}
-				i++;
-				});
+		for (size_t i = 0; i < snapshot.instanceSlots.size(); i++)
+		{
+			const uint32_t slot = snapshot.instanceSlots[i];
+			if (slot >= MAX_INSTANCES) continue;
+			m_cpuInstances[slot] = snapshot.instanceData[i];
+			markPending(slot);
 		}
+	}
+
+	void VulkanRenderer::recordInstanceUpload(VkCommandBuffer cmd)
+	{
+		if (m_pendingInstanceSlots.empty()) return;
+
+		IX_PROFILE_SCOPE("VulkanRenderer::recordInstanceUpload");
 
-		m_currentInstanceCount = static_cast<uint32_t>(m_cpuInstanceCache.size());
+		// This frame's fence was waited on, so its staging buffer is free. Slots keep their database offset
+		// in staging, which turns runs of neighbouring slots into one copy region each
+		VulkanBuffer& staging = *m_instanceStaging[m_currentFrameIndex];
+		auto* stagingData = static_cast<GPUInstanceData*>(staging.getMappedData());
 
-		// Single GPU Upload
-		if (m_currentInstanceCount > 0)
+		std::sort(m_pendingInstanceSlots.begin(), m_pendingInstanceSlots.end());
+		std::vector<VkBufferCopy> regions;
+		for (uint32_t slot : m_pendingInstanceSlots)
 		{
-			m_instanceBuffer->writeToBuffer(m_cpuInstanceCache.data(), m_currentInstanceCount * sizeof(GPUInstanceData));
-		}
+			stagingData[slot] = m_cpuInstances[slot];
+			m_pendingInstanceFlags[slot] = 0;
 
-		// Logging
-		static size_t lastBatchCount = 0;
-		static uint32_t lastInstanceCount = 0;
-		if (m_renderBatches.size() != lastBatchCount || m_currentInstanceCount != lastInstanceCount) {
-			spdlog::info("Batcher: Flattened {} instances into {} unique batches",
-				m_currentInstanceCount, m_renderBatches.size());
-			lastBatchCount = m_renderBatches.size();
-			lastInstanceCount = m_currentInstanceCount;
+			const VkDeviceSize offset = slot * sizeof(GPUInstanceData);
+			if (!regions.empty() && regions.back().srcOffset + regions.back().size == offset)
+			{
+				regions.back().size += sizeof(GPUInstanceData);
+			}
+			else
+			{
+				regions.push_back({ offset, offset, sizeof(GPUInstanceData) });
+			}
 		}
+		m_pendingInstanceSlots.clear();
+
+		// WAR against the previous frame's culling, which may still read the database on this queue
+		VkMemoryBarrier2 before{ VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+		before.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		before.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		before.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+		VkDependencyInfo beforeDep{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+		beforeDep.memoryBarrierCount = 1;
+		beforeDep.pMemoryBarriers = &before;
+		vkCmdPipelineBarrier2(cmd, &beforeDep);
+
+		vkCmdCopyBuffer(cmd, staging.getBuffer(), m_instanceBuffer->getBuffer(), static_cast<uint32_t>(regions.size()), regions.data());
+
+		VkBufferMemoryBarrier2 after{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+		after.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		after.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		after.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		after.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+		after.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		after.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		after.buffer = m_instanceBuffer->getBuffer();
+		after.offset = 0;
+		after.size = VK_WHOLE_SIZE;
+
+		VkDependencyInfo afterDep{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+		afterDep.bufferMemoryBarrierCount = 1;
+		afterDep.pBufferMemoryBarriers = &after;
+		vkCmdPipelineBarrier2(cmd, &afterDep);
 	}
 
 	void VulkanRenderer::updateGlobalUbo(const SceneView& view)
 	{
-		auto& scene = SceneManager::getActiveScene();
-
 		// Mapping SceneView (CPU) to GlobalUbo (GPU Layout)
 		m_globalUboData.projection = view.projectionMatrix;
 		m_globalUboData.view = view.viewMatrix;
@@ -479,7 +630,7 @@ namespace ix
 		);
 
 		// External scene parameters
-		m_globalUboData.skyboxIntensity = scene.getSkyboxIntensity();
+		m_globalUboData.skyboxIntensity = view.skyboxIntensity;
 
 		// Commit to the buffer for the current frame
 		m_globalUboBuffers[m_currentFrameIndex]->writeToBuffer(&m_globalUboData);
@@ -518,30 +669,132 @@ namespace ix
 
 	void VulkanRenderer::endFrame(const FrameContext& ctx)
 	{
+		IX_PROFILE_SCOPE("VulkanRenderer::endFrame");
+
 		FrameData& frame = getCurrentFrame();
 
-		// Transition to Present
+		// With async compute the frame ends in the tail buffer, everything up to the split is already recorded
+		const bool asyncCompute = ctx.computeCommandBuffer != VK_NULL_HANDLE;
+		VkCommandBuffer lastCmd = asyncCompute ? ctx.tailCommandBuffer : frame.commandBuffer;
+
+		// Transition to Present, or ready for a readback when there is nothing to present to
+		const bool headless = m_swapchain->isHeadless();
 		VulkanImage* currentImg = m_swapchain->getImageWrapper(m_currentImageIndex);
-		currentImg->transition(frame.commandBuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+		currentImg->transition(lastCmd, headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
 		vkEndCommandBuffer(frame.commandBuffer);
 
+		const uint64_t serial = m_submitSerial + 1;
+		std::unique_lock<std::mutex> queueLock(m_context->getQueueMutex());
+
+		// Async compute goes first. It rewrites this frame's light lists, which the graphics work of
+		// MAX_FRAMES_IN_FLIGHT frames ago read, so the previous frame's graphics work keeps running next to it
+		if (asyncCompute)
+		{
+			vkEndCommandBuffer(ctx.computeCommandBuffer);
+			vkEndCommandBuffer(ctx.tailCommandBuffer);
+
+			VkSemaphoreSubmitInfo waitGraphics{ VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+			waitGraphics.semaphore = m_graphicsTimeline;
+			waitGraphics.value = serial > MAX_FRAMES_IN_FLIGHT ? serial - MAX_FRAMES_IN_FLIGHT : 0;
+			waitGraphics.stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+			VkSemaphoreSubmitInfo signalCompute{ VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+			signalCompute.semaphore = m_computeTimeline;
+			signalCompute.value = serial;
+			signalCompute.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+			VkCommandBufferSubmitInfo computeCmd{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
+			computeCmd.commandBuffer = ctx.computeCommandBuffer;
+
+			VkSubmitInfo2 computeSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+			computeSubmit.waitSemaphoreInfoCount = 1;
+			computeSubmit.pWaitSemaphoreInfos = &waitGraphics;
+			computeSubmit.commandBufferInfoCount = 1;
+			computeSubmit.pCommandBufferInfos = &computeCmd;
+			computeSubmit.signalSemaphoreInfoCount = 1;
+			computeSubmit.pSignalSemaphoreInfos = &signalCompute;
+
+			if (vkQueueSubmit2(m_context->getComputeQueue(), 1, &computeSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+				throw std::runtime_error("failed to submit async compute command buffer!");
+			}
+			frame.computeSignalValue = serial;
+
+			// The graphics passes ahead of the split need neither the compute output nor the swapchain image
+			VkCommandBufferSubmitInfo headCmd{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
+			headCmd.commandBuffer = frame.commandBuffer;
+
+			VkSubmitInfo2 headSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+			headSubmit.commandBufferInfoCount = 1;
+			headSubmit.pCommandBufferInfos = &headCmd;
+
+			if (vkQueueSubmit2(m_context->getGraphicsQueue(), 1, &headSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+				throw std::runtime_error("failed to submit draw command buffer!");
+			}
+		}
+
 		// Submit
 		VkSemaphore renderFinishedSemaphore = m_swapchain->getRenderSemaphore(m_currentImageIndex);
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-
-		VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-		submit.waitSemaphoreCount = 1;
-		submit.pWaitSemaphores = &frame.imageAvailableSemapohore;
-		submit.pWaitDstStageMask = waitStages;
-		submit.commandBufferCount = 1;
-		submit.pCommandBuffers = &frame.commandBuffer;
-		submit.signalSemaphoreCount = 1;
-		submit.pSignalSemaphores = &renderFinishedSemaphore;
-
-		if (vkQueueSubmit(m_context->getGraphicsQueue(), 1, &submit, frame.inFlightFence) != VK_SUCCESS) {
+
+		VkSemaphoreSubmitInfo waits[2]{};
+		uint32_t waitCount = 0;
+		if (!headless)
+		{
+			waits[waitCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+			waits[waitCount].semaphore = frame.imageAvailableSemapohore;
+			waits[waitCount].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+			waitCount++;
+		}
+		if (asyncCompute && m_renderGraph->getAsyncWaitStages() != VK_PIPELINE_STAGE_2_NONE)
+		{
+			waits[waitCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+			waits[waitCount].semaphore = m_computeTimeline;
+			waits[waitCount].value = serial;
+			waits[waitCount].stageMask = m_renderGraph->getAsyncWaitStages();
+			waitCount++;
+		}
+
+		VkSemaphoreSubmitInfo signals[2]{};
+		uint32_t signalCount = 0;
+		if (!headless)
+		{
+			signals[signalCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+			signals[signalCount].semaphore = renderFinishedSemaphore;
+			signals[signalCount].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			signalCount++;
+		}
+		if (m_graphicsTimeline != VK_NULL_HANDLE)
+		{
+			signals[signalCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+			signals[signalCount].semaphore = m_graphicsTimeline;
+			signals[signalCount].value = serial;
+			signals[signalCount].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			signalCount++;
+		}
+
+		VkCommandBufferSubmitInfo graphicsCmd{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
+		graphicsCmd.commandBuffer = lastCmd;
+
+		VkSubmitInfo2 submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+		submit.waitSemaphoreInfoCount = waitCount;
+		submit.pWaitSemaphoreInfos = waits;
+		submit.commandBufferInfoCount = 1;
+		submit.pCommandBufferInfos = &graphicsCmd;
+		submit.signalSemaphoreInfoCount = signalCount;
+		submit.pSignalSemaphoreInfos = signals;
+
+		// The fence and the timeline signal cover the head submission too, it is earlier in submission order
+		if (vkQueueSubmit2(m_context->getGraphicsQueue(), 1, &submit, frame.inFlightFence) != VK_SUCCESS) {
 			throw std::runtime_error("failed to submit draw command buffer!");
 		}
+		m_submitSerial = serial;
+
+		if (headless)
+		{
+			queueLock.unlock();
+			m_currentFrameIndex = (m_currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+			return;
+		}
 
 		// Present
 		VkSwapchainKHR swapchains[] = { m_swapchain->get() };
@@ -553,6 +806,7 @@ namespace ix
 		presentInfo.pImageIndices = &m_currentImageIndex;
 
 		VkResult result = vkQueuePresentKHR(m_context->getPresentQueue(), &presentInfo);
+		queueLock.unlock();
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
 			recreateSwapchain();
@@ -574,15 +828,11 @@ namespace ix
 
 		m_renderGraphCompileConfig.context = m_context.get();
 		m_renderGraphCompileConfig.pipelineManager = m_pipelineManager.get();
+		m_renderGraphCompileConfig.swapchainExtent = m_swapchain->getExtent();
 
-		m_renderGraph->importBuffer("ClusterAABBbuffer", m_clusterAABBbuffer.get());
-		m_renderGraph->importBuffer("LightGridBuffer", m_lightGridBuffer.get());
-		m_renderGraph->importBuffer("LightIndexBuffer", m_lightIndexListBuffer.get());
-		m_renderGraph->importBuffer("AtomicCounter", m_atomicCounterBuffer.get());
-		m_renderGraph->importBuffer("InstanceDb", m_instanceBuffer.get());
-		m_renderGraph->importBuffer("CulledInstances", m_culledInstanceBuffer.get());
-
+		importGraphResources();
 
+		// Execution order comes from the declared resources, not from this list
 		m_renderGraph->addPass(std::move(clusterBuildPass));
 		m_renderGraph->addPass(std::move(computeCullingPass));
 		m_renderGraph->addPass(std::move(clusterCullingPass));
@@ -594,6 +844,19 @@ namespace ix
 		m_renderGraph->compile(m_renderGraphCompileConfig);
 	}
 
+	void VulkanRenderer::importGraphResources()
+	{
+		uint32_t startIdx = 0;
+		m_renderGraph->importImage(RenderGraph::BACK_BUFFER, m_swapchain->getImageWrapper(startIdx));
+
+		m_renderGraph->importBuffer("ClusterAABBbuffer", m_clusterAABBbuffer.get());
+		m_lightGridHandle = m_renderGraph->importBuffer("LightGridBuffer", m_lightGridBuffers[0].get());
+		m_lightIndexListHandle = m_renderGraph->importBuffer("LightIndexBuffer", m_lightIndexListBuffers[0].get());
+		m_renderGraph->importBuffer("AtomicCounter", m_atomicCounterBuffer.get());
+		m_renderGraph->importBuffer("InstanceDb", m_instanceBuffer.get());
+		m_renderGraph->importBuffer("CulledInstances", m_culledInstanceBuffer.get());
+	}
+
 	void VulkanRenderer::loadPipelines(const nlohmann::json& json)
 	{
 		std::string shaderRoot = std::string(PROJECT_ROOT_DIR) + "/sandbox_game/res/shaders/spirV/";
@@ -685,7 +948,8 @@ namespace ix
 		{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }, // Cluster AABBs
 		{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }, // Light Grid
 		{ 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }, // Light Index List
-		{ 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }  // Atomic counter
+		{ 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }, // Atomic counter
+		{ 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr }  // Culling stats
 		};
 
 		VkDescriptorSetLayoutCreateInfo uboCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
@@ -809,30 +1073,14 @@ namespace ix
 		m_context->setSwapchainFormat(m_swapchain->getFormat());
 		m_context->setDepthFormat(VK_FORMAT_D32_SFLOAT);
 
-		m_depthImage = std::make_unique<VulkanImage>(
-			*m_context,
-			m_swapchain->getExtent(),
-			VK_FORMAT_D32_SFLOAT,
-			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
-		);
-
-
 		if (m_renderGraph)
 		{
-			m_renderGraph->clearExternalResources();
-
-			uint32_t startIdx = 0;
-			m_renderGraph->importImage("BackBuffer", m_swapchain->getImageWrapper(startIdx));
-			m_renderGraph->importImage("DepthBuffer", m_depthImage.get());
+			// Only the swapchain-bound resources change, the compiled passes are kept unless new ones were added
+			m_renderGraph->importImage(RenderGraph::BACK_BUFFER, m_swapchain->getImageWrapper(0));
+			m_renderGraphCompileConfig.swapchainExtent = m_swapchain->getExtent();
 
-			m_renderGraph->importBuffer("ClusterAABBbuffer", m_clusterAABBbuffer.get());
-			m_renderGraph->importBuffer("LightGridBuffer", m_lightGridBuffer.get());
-			m_renderGraph->importBuffer("LightIndexBuffer", m_lightIndexListBuffer.get());
-			m_renderGraph->importBuffer("AtomicCounter", m_atomicCounterBuffer.get());
-			m_renderGraph->importBuffer("InstanceDb", m_instanceBuffer.get());
-			m_renderGraph->importBuffer("CulledInstances", m_culledInstanceBuffer.get());
-
-			m_renderGraph->compile(m_renderGraphCompileConfig);
+			if (m_renderGraph->needsCompile()) m_renderGraph->compile(m_renderGraphCompileConfig);
+			else m_renderGraph->resize(m_renderGraphCompileConfig);
 
 			auto* basePass = m_renderGraph->getPass("ClusterBuild");
 			if (basePass)
@@ -848,7 +1096,10 @@ namespace ix
 
 	void VulkanRenderer::onResize(uint32_t width, uint32_t height)
 	{
-		vkDeviceWaitIdle(m_context->device());
+		{
+			std::lock_guard<std::mutex> queueLock(m_context->getQueueMutex());
+			vkDeviceWaitIdle(m_context->device());
+		}
 		recreateSwapchain();
 	}
 
@@ -858,6 +1109,69 @@ namespace ix
 		return { extent.width, extent.height };
 	}
 
+	bool VulkanRenderer::saveFrame(const std::string& path)
+	{
+		if (!m_swapchain->isHeadless())
+		{
+			spdlog::warn("VulkanRenderer: Frame readback needs the headless back buffer, swapchain images aren't transfer sources");
+			return false;
+		}
+		waitIdle();
+
+		// endFrame left it in TRANSFER_SRC_OPTIMAL
+		VulkanImage* image = m_swapchain->getImageWrapper(m_currentImageIndex);
+		const VkExtent2D extent = image->getExtent();
+		const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+
+		VulkanBuffer readback(*m_context, size, 1, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+		m_context->immediateSubmit([&](VkCommandBuffer cmd) {
+			image->transition(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+			VkBufferImageCopy region{};
+			region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+			region.imageExtent = { extent.width, extent.height, 1 };
+			vkCmdCopyImageToBuffer(cmd, image->getHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.getBuffer(), 1, &region);
+
+			VkBufferMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+			hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			hostBarrier.buffer = readback.getBuffer();
+			hostBarrier.size = VK_WHOLE_SIZE;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+				0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+			});
+
+		// R8G8B8A8, the sRGB encoding is kept as is
+		readback.map();
+		readback.invalidate();
+		const bool written = stbi_write_png(path.c_str(), static_cast<int>(extent.width), static_cast<int>(extent.height), 4,
+			readback.getMappedData(), static_cast<int>(extent.width) * 4) != 0;
+		readback.unmap();
+
+		if (written) spdlog::info("VulkanRenderer: Frame written to {}", path);
+		else spdlog::error("VulkanRenderer: Failed to write {}", path);
+		return written;
+	}
+
+	RenderStats VulkanRenderer::getStats() const
+	{
+		RenderStats stats;
+		stats.fenceWaitMs = m_fenceWaitMs;
+		stats.acquireWaitMs = m_acquireWaitMs;
+
+		// Triangles the indirect draws submit once per scene pass
+		for (uint32_t visible : m_cullingStats.visibleInstances) stats.visibleInstances += visible;
+		stats.triangleCount = m_cullingStats.trianglesSubmitted;
+		stats.maxLightsPerCluster = m_cullingStats.maxLightsPerCluster;
+		stats.averageLightsPerCluster = static_cast<float>(m_cullingStats.totalLightReferences) / (16 * 9 * 24);
+		stats.lightIndexOverflow = m_cullingStats.droppedLightIndices;
+
+		if (m_gpuProfiler) stats.gpuTimeMs = static_cast<float>(m_gpuProfiler->getTotalMs());
+		return stats;
+	}
+
 	void VulkanRenderer::createCommandBuffers() 
 	{
 		uint32_t graphicsFamily = m_context->getGraphicsFamily();
@@ -874,6 +1188,28 @@ namespace ix
 			allocInfo.commandBufferCount = 1;
 			vkAllocateCommandBuffers(m_context->device(), &allocInfo, &m_frames[i].commandBuffer);
 		}
+
+		if (!m_context->hasAsyncCompute()) return;
+
+		// The graphics work after the first consumer of compute output is submitted on its own
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+			VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+			allocInfo.commandPool = m_frames[i].commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			vkAllocateCommandBuffers(m_context->device(), &allocInfo, &m_frames[i].tailCommandBuffer);
+		}
+
+		poolInfo.queueFamilyIndex = m_context->getComputeFamily();
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+			vkCreateCommandPool(m_context->device(), &poolInfo, nullptr, &m_frames[i].computeCommandPool);
+
+			VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+			allocInfo.commandPool = m_frames[i].computeCommandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			vkAllocateCommandBuffers(m_context->device(), &allocInfo, &m_frames[i].computeCommandBuffer);
+		}
 	}
 
 	void VulkanRenderer::createSyncObjects() 
@@ -887,11 +1223,21 @@ namespace ix
 			vkCreateSemaphore(m_context->device(), &semInfo, nullptr, &m_frames[i].renderFinishedSemaphore);
 			vkCreateFence(m_context->device(), &fenceInfo, nullptr, &m_frames[i].inFlightFence);
 		}
+
+		if (!m_context->hasAsyncCompute()) return;
+
+		VkSemaphoreTypeCreateInfo timelineInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+		timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		timelineInfo.initialValue = 0;
+		semInfo.pNext = &timelineInfo;
+		vkCreateSemaphore(m_context->device(), &semInfo, nullptr, &m_graphicsTimeline);
+		vkCreateSemaphore(m_context->device(), &semInfo, nullptr, &m_computeTimeline);
 	}
 	
 
 	void VulkanRenderer::waitIdle()
 	{
+		std::lock_guard<std::mutex> queueLock(m_context->getQueueMutex());
 		vkDeviceWaitIdle(m_context->device());
 	}
 
@@ -938,14 +1284,20 @@ namespace ix
 	{
 		if (!m_context) return;
 
-		// Shutdown imgui
-		ImGui_ImplGlfw_Shutdown();
-		ImGui_ImplVulkan_Shutdown();
-		ImGui::DestroyContext();
+		// Shutdown imgui, headless runs never create it
+		if (ImGui::GetCurrentContext())
+		{
+			ImGui_ImplGlfw_Shutdown();
+			ImGui_ImplVulkan_Shutdown();
+			ImGui::DestroyContext();
+		}
 		if (m_imguiPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(m_context->device(), m_imguiPool, nullptr);
 		
 
 		// Clean up resources
+		m_secondaryPools.reset();
+		m_gpuProfiler.reset();
+
 		if (m_pipelineManager) 
 		{
 			m_pipelineManager->clearCache();
@@ -973,19 +1325,21 @@ namespace ix
 			m_renderGraph->clearExternalResources();
 			m_renderGraph.reset();
 		}
-		m_depthImage.reset();
 		m_descriptorManagers.clear();
 		m_globalUboBuffers.clear();
 		m_frameDescriptorSets.clear();
 
 		m_instanceBuffer.reset();
+		m_instanceStaging.clear();
 		m_culledInstanceBuffer.reset();
 		m_lightBuffers.clear();
 		m_clusterAABBbuffer.reset();
-		m_lightIndexListBuffer.reset();
-		m_lightGridBuffer.reset();
+		m_lightIndexListBuffers.clear();
+		m_lightGridBuffers.clear();
 		m_cpuLightCache.reset();
 		m_atomicCounterBuffer.reset();
+		m_cullingStatsBuffer.reset();
+		m_cullingStatsReadback.reset();
 	
 
 		if (m_bindlessPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(m_context->device(), m_bindlessPool, nullptr);
@@ -1004,7 +1358,12 @@ namespace ix
 			if (m_frames[i].commandPool != VK_NULL_HANDLE) {
 				vkDestroyCommandPool(m_context->device(), m_frames[i].commandPool, nullptr);
 			}
+			if (m_frames[i].computeCommandPool != VK_NULL_HANDLE) {
+				vkDestroyCommandPool(m_context->device(), m_frames[i].computeCommandPool, nullptr);
+			}
 		}
+		if (m_graphicsTimeline != VK_NULL_HANDLE) vkDestroySemaphore(m_context->device(), m_graphicsTimeline, nullptr);
+		if (m_computeTimeline != VK_NULL_HANDLE) vkDestroySemaphore(m_context->device(), m_computeTimeline, nullptr);
 
 		m_swapchain.reset();
 		m_context.reset();
@@ -8,6 +8,8 @@
 #include "global_common/ix_global_pods.h"
 #include "global_common/ix_event_pods.h"
 #include "vk_buffer.h"
+#include "render_graph_pass_i.h"
+#include "platform/rendering/instance_table.h"
 
 namespace ix 
 {
@@ -18,6 +20,9 @@ namespace ix
     class VulkanDescriptorManager;
     class RenderGraph;
     class VulkanImage;
+    class VulkanCommandPools;
+    class VulkanGpuProfiler;
+    class JobSystem;
     
     struct LightData;
 
@@ -26,6 +31,8 @@ namespace ix
 	class VulkanRenderer : public Renderer_I 
 	{
 	public:
+        static constexpr uint32_t MAX_INSTANCES = 3000; // Instance database slots, entities past it aren't drawn
+
         VulkanRenderer(Window_I& window);
         ~VulkanRenderer() override;
 
@@ -34,12 +41,14 @@ namespace ix
         void shutdown() override;
         void onResize(uint32_t width, uint32_t height) override;
         void waitIdle() override;
-        bool beginFrame(FrameContext& ctx, const SceneView& view) override;
+        void prepareFrame(Scene& scene, RenderSnapshot& snapshot) override;
+        bool beginFrame(FrameContext& ctx, const RenderSnapshot& snapshot) override;
         void endFrame(const FrameContext& ctx) override;
         void loadPipelines(const nlohmann::json& json) override;
         void compileRenderGraph() override;
         void render(const FrameContext& ctx, const SceneView& view) override;
         void setupImGui() override;
+        void setJobSystem(JobSystem* jobs) override { m_jobSystem = jobs; }
 
         // Misc
         void updateGlobalUbo(const SceneView& view);
@@ -61,7 +70,14 @@ namespace ix
         RenderExtent getSwapchainExtent() const override;
         VulkanSwapchain* getSwapchain() override { return m_swapchain.get(); }
         uint32_t getCurrentImageIndex() const override { return m_currentImageIndex; }
+        RenderStats getStats() const override;
+        bool saveFrame(const std::string& path) override; // Headless only
         VulkanPipelineManager* getPipelineManager() const { return m_pipelineManager.get(); }
+        VulkanGpuProfiler* getGpuProfiler() const { return m_gpuProfiler.get(); } // Null when unsupported
+        const GPUCullingStats& getCullingStats() const { return m_cullingStats; }
+
+        // View space light packing, no device state involved (also driven by the CPU microbenchmarks)
+        static void extractLights(Scene& scene, RenderSnapshot& snapshot);
       
     private:
         // Internal Helpers
@@ -69,10 +85,14 @@ namespace ix
         void createCommandBuffers();
         void createSyncObjects();
         void createDescriptorAndPipelineLayouts();
+        void importGraphResources();
         
         // Misc
-        void updateInstanceBuffer();
-        void updateLightBuffer(const SceneView& view);
+        void extractInstances(Scene& scene, RenderSnapshot& snapshot);
+        void updateInstanceBuffer(const RenderSnapshot& snapshot);
+        // After the frame's fence: stages the slots changed since the last upload and copies them into the database
+        void recordInstanceUpload(VkCommandBuffer cmd);
+        void updateLightBuffer(const RenderSnapshot& snapshot);
 
     private:
         // Core Infrastructure
@@ -90,6 +110,22 @@ namespace ix
         uint32_t  m_currentImageIndex = 0;
         VkCommandPool m_commandPool = VK_NULL_HANDLE;
 
+        // Async compute: both queues count submissions on a timeline, one value per frame
+        VkSemaphore m_graphicsTimeline = VK_NULL_HANDLE;
+        VkSemaphore m_computeTimeline = VK_NULL_HANDLE;
+        uint64_t  m_submitSerial = 0;
+
+        // CPU time beginFrame spent blocked, last frame
+        float m_fenceWaitMs = 0.0f;
+        float m_acquireWaitMs = 0.0f;
+
+        // Parallel pass recording (secondary buffers per thread and frame)
+        JobSystem* m_jobSystem = nullptr;
+        std::unique_ptr<VulkanCommandPools> m_secondaryPools;
+
+        // Per-pass timestamps and pipeline statistics, read back one frame slot later
+        std::unique_ptr<VulkanGpuProfiler> m_gpuProfiler;
+
         // Pipeline & Descriptor Management
         std::unique_ptr<VulkanPipelineManager> m_pipelineManager;
         std::vector<std::unique_ptr<VulkanDescriptorManager>> m_descriptorManagers;
@@ -105,7 +141,6 @@ namespace ix
         VkDescriptorSetLayout m_computeStorageLayout = VK_NULL_HANDLE;
 
         // Global Resources
-        std::unique_ptr<VulkanImage> m_depthImage;
         GlobalUbo m_globalUboData{};
         std::vector<std::unique_ptr<VulkanBuffer>> m_globalUboBuffers;
         std::vector<FrameDescriptorSetGroup>       m_frameDescriptorSets;
@@ -116,20 +151,33 @@ namespace ix
         VkDescriptorSet       m_bindlessDescriptorSet = VK_NULL_HANDLE;
 
         // GPU-Driven Rendering & Culling
-        std::unique_ptr<VulkanBuffer> m_instanceBuffer;       // Scene Database (Input)
+        std::unique_ptr<VulkanBuffer> m_instanceBuffer;       // Scene Database (Input), device local
+        std::vector<std::unique_ptr<VulkanBuffer>> m_instanceStaging; // Per frame in flight, same layout as the database
+        std::vector<GPUInstanceData> m_cpuInstances;          // Snapshot deltas land here, whether the frame renders or not
+        std::vector<uint32_t> m_pendingInstanceSlots;         // Changed since the last recorded upload
+        std::vector<uint8_t> m_pendingInstanceFlags;
         std::unique_ptr<VulkanBuffer> m_culledInstanceBuffer; // Indirect Commands + Culled Data (Output)
         uint32_t m_currentInstanceCount = 0;
 
         // CPU-Side Batching & Caches
-        std::vector<RenderBatch> m_renderBatches;
-        std::vector<GPUInstanceData> m_cpuInstanceCache;
-        std::unordered_map<MeshHandle, std::vector<GPUInstanceData>> m_batchMapCache;
+        static constexpr uint32_t MAX_BATCHES = 16; // Matches batchOffsets[] in frustum_culling.comp
+        static constexpr uint32_t MAX_POINT_LIGHTS = 1024; // Matches LightData::lights
+        InstanceTable m_instanceTable{ MAX_INSTANCES, MAX_BATCHES }; // Game thread only (prepareFrame)
         std::vector<std::unique_ptr<VulkanBuffer>> m_lightBuffers;
         std::unique_ptr<VulkanBuffer> m_clusterAABBbuffer;
-        std::unique_ptr<VulkanBuffer> m_lightIndexListBuffer;// pool of light IDs
-        std::unique_ptr<VulkanBuffer> m_lightGridBuffer;
+        // Light lists, one copy per frame in flight: async culling of the next frame
+        // overlaps the graphics work still shading with the current one
+        std::vector<std::unique_ptr<VulkanBuffer>> m_lightIndexListBuffers;// pool of light IDs
+        std::vector<std::unique_ptr<VulkanBuffer>> m_lightGridBuffers;
+        RGResourceHandle m_lightIndexListHandle = INVALID_RESOURCE;
+        RGResourceHandle m_lightGridHandle = INVALID_RESOURCE;
         std::unique_ptr<LightData> m_cpuLightCache;
         std::unique_ptr<VulkanBuffer> m_atomicCounterBuffer;
+
+        // Culling counters, copied into a host ring with one slot per frame in flight
+        std::unique_ptr<VulkanBuffer> m_cullingStatsBuffer;
+        std::unique_ptr<VulkanBuffer> m_cullingStatsReadback;
+        GPUCullingStats m_cullingStats{}; // Last slot read back
         // Imgui
         VkDescriptorPool m_imguiPool = VK_NULL_HANDLE;
 
@@ -14,7 +14,8 @@ namespace ix
 		// Capture the handle from the raw pointer if it exists
 		VkSwapchainKHR oldHandle = (old != nullptr) ? old->get() : VK_NULL_HANDLE;
 
-		create(oldHandle, vSync);
+		if (m_context.isHeadless()) createHeadless();
+		else create(oldHandle, vSync);
 	}
 
 	VulkanSwapchain::~VulkanSwapchain()
@@ -106,8 +107,34 @@ namespace ix
 		}
 	}
 	
+	void VulkanSwapchain::createHeadless()
+	{
+		m_imageFormat = HEADLESS_FORMAT;
+		m_images.resize(HEADLESS_IMAGE_COUNT);
+		m_frames.resize(HEADLESS_IMAGE_COUNT);
+
+		// Transfer source for reading the final frame back
+		const VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		for (uint32_t i = 0; i < HEADLESS_IMAGE_COUNT; i++) {
+			m_frames[i].image = std::make_unique<VulkanImage>(m_context, m_extent, m_imageFormat, usage);
+			m_frames[i].image->setMemoryTag(MemoryCategory::RenderTargets, "Headless Back Buffer");
+			m_frames[i].renderFinishedSemaphore = VK_NULL_HANDLE;
+			m_images[i] = m_frames[i].image->getHandle();
+		}
+
+		spdlog::info("VulkanSwapchain: Headless, {} offscreen {}x{} images", HEADLESS_IMAGE_COUNT, m_extent.width, m_extent.height);
+	}
+
 	VkResult VulkanSwapchain::acquireNextImage(VkSemaphore signalSemaphore, uint32_t* imageIndex)
 	{
+		// Handed out in order, more images than frames in flight so the fences cover their previous use
+		if (isHeadless())
+		{
+			*imageIndex = m_nextHeadlessImage;
+			m_nextHeadlessImage = (m_nextHeadlessImage + 1) % HEADLESS_IMAGE_COUNT;
+			return VK_SUCCESS;
+		}
+
 		return vkAcquireNextImageKHR(
 			m_context.device(),
 			m_swapchain,
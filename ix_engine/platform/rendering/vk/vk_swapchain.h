@@ -15,9 +15,14 @@ namespace ix
         VkSemaphore renderFinishedSemaphore;
     };
 
+    // On a headless context the "swapchain" is a ring of offscreen images: acquire hands them out in
+    // turn without signaling anything, and the renderer skips presenting them
     class VulkanSwapchain 
     {
     public:
+        static constexpr uint32_t HEADLESS_IMAGE_COUNT = 3;
+        static constexpr VkFormat HEADLESS_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
         VulkanSwapchain(VulkanContext& context, VkExtent2D extent, VulkanSwapchain* old = nullptr, bool vSync = true);
         ~VulkanSwapchain();
 
@@ -33,12 +38,14 @@ namespace ix
         VkImage getImage(uint32_t index) const { return m_images[index]; }
         VulkanImage* getImageWrapper(uint32_t index);
         VkSemaphore getRenderSemaphore(uint32_t index) { return m_frames[index].renderFinishedSemaphore; }
+        bool isHeadless() const { return m_swapchain == VK_NULL_HANDLE; }
 
         // Misc
         VkResult acquireNextImage(VkSemaphore signalSemaphore, uint32_t* imageIndex);
 
     private:
         void create(VkSwapchainKHR oldHandle, bool vSync);
+        void createHeadless();
 
         // Selection helpers
         VkSurfaceFormatKHR chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats);
@@ -52,5 +59,6 @@ namespace ix
 
         std::vector<VkImage> m_images;
         std::vector<SwapchainImage> m_frames;
+        uint32_t m_nextHeadlessImage = 0;
     };
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
+#include <vector>
 #include "common/handles.h"
 
 namespace ix 
@@ -11,6 +12,9 @@ namespace ix
     class VulkanDescriptorManager;
     class VulkanContext;
     class VulkanBuffer;
+    class VulkanCommandPools;
+    class VulkanGpuProfiler;
+    class JobSystem;
 
     struct GlobalUbo
     {
@@ -29,6 +33,7 @@ namespace ix
     {
         VulkanContext* context;
         VulkanPipelineManager* pipelineManager;
+        VkExtent2D swapchainExtent{}; // Size of transient images that follow the swapchain
     };
 
 
@@ -85,6 +90,13 @@ namespace ix
         VulkanDescriptorManager* descriptorManager;
         VkDescriptorSetLayout computeStorageLayout;
         VkDescriptorSetLayout computeCullingLayout;
+
+        // Parallel pass recording, both null when passes are recorded serially
+        JobSystem* jobSystem;
+        VulkanCommandPools* commandPools;
+
+        // Per-pass GPU timings, null when the device can't profile
+        VulkanGpuProfiler* gpuProfiler;
     };
 
     // The specific "State" of the current frame
@@ -92,6 +104,8 @@ namespace ix
     {
         uint32_t frameIndex;
         VkCommandBuffer commandBuffer;
+        VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE; // Async compute queue, only when the graph has async passes
+        VkCommandBuffer tailCommandBuffer = VK_NULL_HANDLE;    // Graphics work that waits for the async passes, submitted after commandBuffer
 
         // Volatile Descriptor Sets (Change every frame)
         VkDescriptorSet globalDescriptorSet;
@@ -105,6 +119,11 @@ namespace ix
 
         // Misc
         VkBuffer atomicCounterBuffer;
+
+        // Culling counters, each culling pass copies its region into this frame's readback slot
+        VkBuffer cullingStatsBuffer;
+        VkBuffer cullingStatsReadback;
+        VkDeviceSize cullingStatsReadbackOffset;
     };
 
     // Constant Data
@@ -116,6 +135,10 @@ namespace ix
         glm::mat4 projectionMatrix;
         glm::mat4 clusterProjection;
         glm::vec3 cameraPosition;
+
+        // Environment
+        TextureHandle skybox = 0;
+        float skyboxIntensity = 1.0f;
     };
 
     struct RenderState 
@@ -142,6 +165,12 @@ namespace ix
         VkFence inFlightFence;
         VkCommandPool commandPool;
         VkCommandBuffer commandBuffer;
+
+        // Async compute queue, null without a dedicated compute family
+        VkCommandPool computeCommandPool;
+        VkCommandBuffer computeCommandBuffer;
+        VkCommandBuffer tailCommandBuffer; // Graphics passes from the first consumer of compute output on
+        uint64_t computeSignalValue; // Compute timeline value of the last submission
     };
 
     struct FrameDescriptorSetGroup 
@@ -167,11 +196,45 @@ namespace ix
 
     struct alignas(16) GPUInstanceData
     {
-        glm::mat4 modelMatrix;    // 64 bytes
+        glm::vec4 modelRows[3];   // 48 bytes - Row-major affine 3x4 (translation in w)
         uint32_t  textureIndex;   // 4 bytes
         float     boundingRadius; // 4 bytes
         uint32_t  batchID;        // 4 bytes
-        uint32_t  _padding;       // 4 bytes (Makes struct 80 bytes total)
+        uint32_t  _padding;       // 4 bytes (Makes struct 64 bytes total)
+    };
+
+    // Render-relevant copy of the scene. Written by the game thread (Renderer_I::prepareFrame),
+    // read by the render thread, so the renderer never touches the registry.
+    struct RenderSnapshot
+    {
+        SceneView view{};
+        float interpolationAlpha = 0.0f;
+
+        // Point lights in view space
+        std::vector<GPUPointLight> lights;
+
+        // Instance database changes since the previous snapshot
+        bool fullInstanceUpload = false;
+        uint32_t instanceSlotCount = 0;
+        std::vector<uint32_t> instanceSlots;       // Changed slots (unused on a full upload)
+        std::vector<GPUInstanceData> instanceData; // Data for instanceSlots, or every slot on a full upload
+        std::vector<RenderBatch> batches;
+    };
+
+    // Set 0, binding 6. Frustum culling fills the first region on the graphics queue, cluster light culling
+    // the second on the compute queue, so the two never touch the same bytes
+    struct GPUCullingStats
+    {
+        // Frustum culling
+        uint32_t visibleInstances[16];   // Per batch, same limit as CullingPushConstants::batchOffsets
+        uint32_t trianglesSubmitted;     // Index count / 3 of every surviving instance
+        uint32_t _padding[3];
+
+        // Cluster light culling
+        uint32_t maxLightsPerCluster;
+        uint32_t totalLightReferences;   // Summed over clusters, before any clamping
+        uint32_t overflowedClusters;     // More lights than the shader's per-cluster list holds
+        uint32_t droppedLightIndices;    // References that didn't fit in the light index list
     };
 
     struct CullingPushConstants
@@ -9,7 +9,7 @@ namespace ix {
         virtual void onDetach() {}
         virtual void onUpdate(float dt) {} // Called every frame. Use for: Animations, Cameras, Visuals.
         virtual void onFixedUpdate(float fixedDt) {} // Called at fixed intervals (e.g., 0.016s). Use for: Physics, Gameplay Logic.
-        virtual void onRender(float alpha) {} // 'alpha' is the interpolation factor (how far we are between physics steps).
-        virtual void onImGuiRender() {}
+        virtual void onRender(float alpha) {} // 'alpha' is the interpolation factor (how far we are between physics steps). Main thread.
+        virtual void onImGuiRender() {} // Called on the main thread after the frame has begun. Use for: Debug UI.
     };
 }
\ No newline at end of file
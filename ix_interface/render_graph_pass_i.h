@@ -15,9 +15,10 @@ namespace ix
 
     enum class RGResourceType { Image, Buffer };
 
+    // Dense index into the graph's registry, returned by the builder during setup
     struct RGResourceview {
-        RGResourceHandle handle;
-        RGResourceType type;
+        RGResourceHandle handle = INVALID_RESOURCE;
+        RGResourceType type = RGResourceType::Image;
     };
 
     enum class PassType {
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <glm/glm.hpp>
 #include <nlohmann/json_fwd.hpp>
 
@@ -10,7 +11,9 @@ namespace ix
     class Scene; 
     struct FrameContext;
     struct SceneView;
+    struct RenderSnapshot;
     class VulkanSwapchain;
+    class JobSystem;
     
 
     enum class RendererAPI { None, Vulkan, OpenGL };
@@ -18,6 +21,15 @@ namespace ix
     struct RenderStats {
         uint32_t drawCalls = 0;
         uint32_t triangleCount = 0;
+        float gpuTimeMs = 0.0f; // Graphics queue, a few frames behind
+        float fenceWaitMs = 0.0f;
+        float acquireWaitMs = 0.0f;
+
+        // Culling counters, read back MAX_FRAMES_IN_FLIGHT frames late
+        uint32_t visibleInstances = 0;
+        uint32_t maxLightsPerCluster = 0;
+        float averageLightsPerCluster = 0.0f;
+        uint32_t lightIndexOverflow = 0; // Light references dropped by the cluster culling
     };
 
     struct RenderExtent {
@@ -41,7 +53,10 @@ namespace ix
         virtual void onResize(uint32_t width, uint32_t height) = 0;
 
         // The Frame Cycle
-        virtual bool beginFrame(FrameContext& ctx, const SceneView& view) = 0;
+        // prepareFrame runs on the game thread and copies what the frame needs out of the scene;
+        // the other calls run on the render thread and only read the snapshot
+        virtual void prepareFrame(Scene& scene, RenderSnapshot& snapshot) = 0;
+        virtual bool beginFrame(FrameContext& ctx, const RenderSnapshot& snapshot) = 0;
         virtual void endFrame(const FrameContext& ctx) = 0;
         virtual void render(const FrameContext& ctx, const SceneView& view) = 0;
 
@@ -50,9 +65,13 @@ namespace ix
         virtual RenderExtent getSwapchainExtent() const = 0;
         virtual VulkanSwapchain* getSwapchain() = 0;
         virtual uint32_t getCurrentImageIndex() const = 0;
+        virtual RenderStats getStats() const { return {}; }
+        // Writes the last rendered frame to a PNG, false where the back buffer can't be read back
+        virtual bool saveFrame(const std::string& path) { return false; }
 
         // Misc
         virtual void setupImGui() {}
+        virtual void setJobSystem(JobSystem* jobs) {} // Before init(). Enables parallel command recording
 
     };
 }
\ No newline at end of file
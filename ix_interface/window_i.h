@@ -37,5 +37,7 @@ namespace ix
         virtual void resetWindowResizedFlag() = 0;
         virtual void setWindowResizedFlag(bool wasResized) = 0;
         virtual void waitEvents() = 0;
+        // No surface to present to, the renderer draws into offscreen images
+        virtual bool isHeadless() const { return false; }
     };
 }
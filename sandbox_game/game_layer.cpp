@@ -77,14 +77,14 @@ void GameLayer::onAttach()
     for (int i = 0; i < lightCount; ++i)
     {
         auto light = scene.createEntity("TestLight_" + std::to_string(i));
-        auto& tc = light.addComponent<TransformComponent>();
+        light.addComponent<TransformComponent>();
 
         float x = ((float)(rand() % 600) / 10.0f) - 30.0f;
         float y = 1.5f;
         float z = ((float)(rand() % 600) / 10.0f) - 30.0f;
 
-        tc.setPosition({ x, y, z });
-        tc.setScale({ 0.1f, 0.1f, 0.1f });
+        light.setPosition({ x, y, z });
+        light.setScale({ 0.1f, 0.1f, 0.1f });
 
         auto& plc = light.addComponent<PointLightComponent>();
 
@@ -104,7 +104,7 @@ void GameLayer::onAttach()
 
 void GameLayer::onUpdate(float dt)
 {
-    SceneManager::getActiveScene().update(dt, Engine::get().getInput());
+    SceneManager::getActiveScene().update(dt, Engine::get().getInput(), &Engine::get().getJobSystem());
 }
 
 void GameLayer::onFixedUpdate(float fixedDt) 
@@ -1,15 +1,41 @@
 #include "engine.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include "core/layers/imgui_layer.h"
 #include "game_layer.h"
 
-int main()
+int main(int argc, char** argv)
 {
 	ix::EngineSpecification engineSpec;
 	engineSpec.windowSpec.mode = ix::WindowMode::Windowed;
+
+	// --headless [frames] --capture <path.png> --record <path> --replay <path>
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--headless") == 0)
+		{
+			engineSpec.headless.enabled = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-') engineSpec.headless.frameCount = static_cast<uint32_t>(std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+		{
+			engineSpec.headless.capturePath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			engineSpec.replay.recordPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			engineSpec.replay.replayPath = argv[++i];
+		}
+	}
+
 	ix::Engine engine(engineSpec);
 	engine.pushLayer<GameLayer>();
-	engine.pushLayer<ix::ImGuiLayer>();
+	if (!engineSpec.headless.enabled) engine.pushLayer<ix::ImGuiLayer>();
 	engine.init();
 	engine.run();
 	return 0;
@@ -30,7 +30,7 @@ layout(set = 0, binding = 0) uniform GlobalUbo
 
 struct InstanceData 
 {
-    mat4 modelMatrix;
+    vec4 modelRows[3]; // Row-major affine 3x4
     uint textureIndex;
     float boundingRadius;
     uint batchID;
@@ -45,7 +45,7 @@ layout(std430, set = 2, binding = 2) readonly buffer InstanceBuffer
 void main() 
 {
     InstanceData inst = instanceData.instances[gl_InstanceIndex];
-    mat4 model = inst.modelMatrix;
+    mat4 model = transpose(mat4(inst.modelRows[0], inst.modelRows[1], inst.modelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
     outTextureIndex = inst.textureIndex;
 
     mat3 normalMatrix = transpose(inverse(mat3(ubo.view * model)));
@@ -0,0 +1,304 @@
+// instance_table_tests.cpp
+// InstanceTable on the CPU: slot assignment, swap-remove, batch growth and relocation, batch
+// recycling, rebuilds and compaction. No device needed, asset lookups fall back to their defaults.
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "core/components.h"
+#include "core/scene.h"
+#include "platform/rendering/instance_table.h"
+
+namespace
+{
+    int g_failures = 0;
+
+#define IX_CHECK(cond)                                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);             \
+            g_failures++;                                                               \
+        }                                                                               \
+    } while (0)
+
+    constexpr uint32_t MAX_INSTANCES = 4096;
+    constexpr uint32_t MAX_BATCHES = 16;
+
+    std::vector<ix::Entity> addInstances(ix::Scene& scene, ix::MeshHandle mesh, uint32_t count)
+    {
+        std::vector<ix::Entity> entities;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ix::Entity entity = scene.createEntity("Instance");
+            entity.addComponent<ix::TransformComponent>();
+            entity.addComponent<ix::MeshComponent>(mesh);
+            entities.push_back(entity);
+        }
+        return entities;
+    }
+
+    // Every live entity sits inside its batch's packed range, no slot is shared
+    void checkConsistent(const ix::InstanceTable& table, const std::vector<ix::Entity>& live)
+    {
+        IX_CHECK(table.getLiveCount() == live.size());
+
+        std::set<uint32_t> slots;
+        for (ix::Entity entity : live)
+        {
+            const uint32_t slot = table.getSlot(entity);
+            IX_CHECK(slot != ix::InstanceTable::INVALID_SLOT);
+            if (slot == ix::InstanceTable::INVALID_SLOT) continue;
+            IX_CHECK(slots.insert(slot).second);
+
+            const uint32_t batchID = table.getInstances()[slot].batchID;
+            IX_CHECK(batchID < table.getBatches().size());
+            if (batchID >= table.getBatches().size()) continue;
+            const ix::RenderBatch& batch = table.getBatches()[batchID];
+            IX_CHECK(slot >= batch.firstInstance && slot < batch.firstInstance + batch.instanceCount);
+        }
+
+        uint32_t counted = 0;
+        for (const ix::RenderBatch& batch : table.getBatches()) counted += batch.instanceCount;
+        IX_CHECK(counted == live.size());
+    }
+
+    void testAdd()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto entities = addInstances(scene, 1, 10);
+        table.sync(scene);
+
+        IX_CHECK(table.needsFullUpload());
+        IX_CHECK(table.getBatches().size() == 1);
+        checkConsistent(table, entities);
+        table.clearDirty();
+
+        // Incremental add after the first rebuild: appended to the batch, only its slot is dirty
+        auto added = addInstances(scene, 1, 1);
+        table.sync(scene);
+        entities.push_back(added[0]);
+
+        IX_CHECK(!table.needsFullUpload());
+        IX_CHECK(table.getDirtySlots().size() == 1);
+        IX_CHECK(table.getDirtySlots()[0] == table.getSlot(added[0]));
+        IX_CHECK(table.getSlot(added[0]) == table.getBatches()[0].firstInstance + 10);
+        checkConsistent(table, entities);
+    }
+
+    void testGatherChanges()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto entities = addInstances(scene, 1, 6);
+        table.sync(scene);
+
+        // First gather after a rebuild carries every slot
+        ix::RenderSnapshot snapshot;
+        table.gatherChanges(snapshot);
+        IX_CHECK(snapshot.fullInstanceUpload);
+        IX_CHECK(snapshot.instanceSlotCount == table.getSlotCount());
+        IX_CHECK(snapshot.instanceData.size() == table.getSlotCount());
+        IX_CHECK(snapshot.batches.size() == table.getBatches().size());
+        IX_CHECK(table.getDirtySlots().empty() && !table.needsFullUpload());
+
+        // Then only what changed, with the data of those slots
+        entities[3].setPosition(glm::vec3(5.0f, 0.0f, 0.0f));
+        scene.updateTransforms();
+        table.sync(scene);
+        table.gatherChanges(snapshot);
+        IX_CHECK(!snapshot.fullInstanceUpload);
+        IX_CHECK(snapshot.instanceSlots.size() == 1 && snapshot.instanceData.size() == 1);
+        if (snapshot.instanceSlots.size() == 1)
+        {
+            IX_CHECK(snapshot.instanceSlots[0] == table.getSlot(entities[3]));
+        }
+        IX_CHECK(table.getDirtySlots().empty());
+    }
+
+    void testSwapRemove()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto entities = addInstances(scene, 1, 8);
+        table.sync(scene);
+        table.clearDirty();
+
+        const uint32_t removedSlot = table.getSlot(entities[2]);
+        const uint32_t lastSlot = table.getSlot(entities[7]);
+        scene.destroyEntity(entities[2]);
+        entities.erase(entities.begin() + 2);
+        table.sync(scene);
+
+        // The batch's last instance fills the hole, the freed tail slot is marked unused
+        IX_CHECK(table.getSlot(entities[6]) == removedSlot);
+        IX_CHECK(table.getInstances()[lastSlot].batchID == ix::InstanceTable::INVALID_BATCH);
+        IX_CHECK(table.getDirtySlots().size() == 2);
+        checkConsistent(table, entities);
+
+        // Removing the last instance moves nothing
+        const uint32_t tailSlot = table.getSlot(entities.back());
+        scene.destroyEntity(entities.back());
+        entities.pop_back();
+        table.sync(scene);
+        IX_CHECK(table.getInstances()[tailSlot].batchID == ix::InstanceTable::INVALID_BATCH);
+        checkConsistent(table, entities);
+    }
+
+    void testBatchGrowth()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto meshA = addInstances(scene, 1, 10);
+        auto meshB = addInstances(scene, 2, 10);
+        table.sync(scene);
+        table.clearDirty();
+
+        const uint32_t oldFirst = table.getBatches()[0].firstInstance;
+        const uint32_t oldSlots = table.getSlotCount();
+
+        // Batch 0 isn't at the tail: it fills up, then moves behind batch 1
+        auto more = addInstances(scene, 1, 25);
+        meshA.insert(meshA.end(), more.begin(), more.end());
+        table.sync(scene);
+
+        const ix::RenderBatch& batch = table.getBatches()[0];
+        IX_CHECK(batch.firstInstance >= oldSlots);
+        IX_CHECK(batch.instanceCount == meshA.size());
+        IX_CHECK(table.getOrphanedSlotCount() > 0);
+        IX_CHECK(table.getInstances()[oldFirst].batchID == ix::InstanceTable::INVALID_BATCH);
+
+        std::vector<ix::Entity> live = meshA;
+        live.insert(live.end(), meshB.begin(), meshB.end());
+        checkConsistent(table, live);
+
+        // The tail batch grows in place
+        const uint32_t tailFirst = table.getBatches()[0].firstInstance;
+        more = addInstances(scene, 1, 40);
+        live.insert(live.end(), more.begin(), more.end());
+        table.sync(scene);
+        IX_CHECK(table.getBatches()[0].firstInstance == tailFirst);
+        checkConsistent(table, live);
+    }
+
+    void testBatchRecycling()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto meshA = addInstances(scene, 1, 4);
+        auto meshB = addInstances(scene, 2, 4);
+        table.sync(scene);
+
+        const uint32_t batchB = table.getInstances()[table.getSlot(meshB[0])].batchID;
+        const uint32_t firstB = table.getBatches()[batchB].firstInstance;
+        for (ix::Entity entity : meshB) scene.destroyEntity(entity);
+        table.sync(scene);
+        IX_CHECK(table.getBatches()[batchB].instanceCount == 0);
+
+        // A new mesh takes over the drained batch and its range instead of opening a new one
+        auto meshC = addInstances(scene, 3, 2);
+        table.sync(scene);
+        IX_CHECK(table.getBatches().size() == 2);
+        IX_CHECK(table.getBatches()[batchB].meshHandle == 3);
+        IX_CHECK(table.getSlot(meshC[0]) == firstB);
+
+        std::vector<ix::Entity> live = meshA;
+        live.insert(live.end(), meshC.begin(), meshC.end());
+        checkConsistent(table, live);
+    }
+
+    void testRebuild()
+    {
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        {
+            ix::Scene first;
+            addInstances(first, 1, 20);
+            table.sync(first);
+            table.clearDirty();
+        }
+
+        // Scene switch: everything is laid out again and re-uploaded
+        ix::Scene second;
+        auto entities = addInstances(second, 5, 7);
+        auto others = addInstances(second, 6, 3);
+        entities.insert(entities.end(), others.begin(), others.end());
+        table.sync(second);
+
+        IX_CHECK(table.needsFullUpload());
+        IX_CHECK(table.getBatches().size() == 2);
+        IX_CHECK(table.getOrphanedSlotCount() == 0);
+        checkConsistent(table, entities);
+
+        // Running out of slots also falls back to a rebuild, which drops what doesn't fit
+        ix::Scene full;
+        ix::InstanceTable small(32, MAX_BATCHES);
+        addInstances(full, 1, 20);
+        small.sync(full);
+        small.clearDirty();
+        addInstances(full, 2, 20);
+        small.sync(full);
+        IX_CHECK(small.needsFullUpload());
+        IX_CHECK(small.getSlotCount() <= 32);
+        IX_CHECK(small.getLiveCount() == 32);
+    }
+
+    void testCompaction()
+    {
+        ix::Scene scene;
+        ix::InstanceTable table(MAX_INSTANCES, MAX_BATCHES);
+        auto meshA = addInstances(scene, 1, 100);
+        auto meshB = addInstances(scene, 2, 100);
+        table.sync(scene);
+        table.clearDirty();
+
+        // Each batch outgrows its range in turn and moves to the tail, orphaning the old one
+        auto moreA = addInstances(scene, 1, 40);
+        table.sync(scene);
+        IX_CHECK(table.getOrphanedSlotCount() > 0);
+        IX_CHECK(!table.needsFullUpload());
+        table.clearDirty();
+
+        const uint32_t fragmentedSlots = table.getSlotCount();
+        auto moreB = addInstances(scene, 2, 40);
+        table.sync(scene);
+
+        // Past the threshold the table compacts instead of growing further
+        IX_CHECK(table.needsFullUpload());
+        IX_CHECK(table.getOrphanedSlotCount() == 0);
+        IX_CHECK(table.getSlotCount() < fragmentedSlots);
+
+        std::vector<ix::Entity> live = meshA;
+        for (const auto* list : { &meshB, &moreA, &moreB }) live.insert(live.end(), list->begin(), list->end());
+        checkConsistent(table, live);
+    }
+}
+
+int main()
+{
+    spdlog::set_level(spdlog::level::off);
+
+    const std::pair<const char*, std::function<void()>> tests[] = {
+        { "add", testAdd },
+        { "gather_changes", testGatherChanges },
+        { "swap_remove", testSwapRemove },
+        { "batch_growth", testBatchGrowth },
+        { "batch_recycling", testBatchRecycling },
+        { "rebuild", testRebuild },
+        { "compaction", testCompaction },
+    };
+
+    for (const auto& [name, test] : tests)
+    {
+        const int before = g_failures;
+        test();
+        std::printf("%-20s %s\n", name, g_failures == before ? "ok" : "FAILED");
+    }
+    return g_failures == 0 ? 0 : 1;
+}